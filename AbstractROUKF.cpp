@@ -7,13 +7,45 @@
 
 #include "AbstractROUKF.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <utility>
+
+#include "parallel/SerialBackend.h"
+#include "parallel/ThreadsBackend.h"
+
 AbstractROUKF::AbstractROUKF() {
 	currIt = 0;
 	currError = 0;
 	prevError = 0;
+	covarianceFactorValid = false;
+	tolerance = 1E-5;
+	maxIterations = 1000;
+	stagnationIterations = 50;
+	divergenceFactor = 1E3;
+	errorHistoryHead = 0;
+	setErrorHistoryLength(10000);
+	statePropagation = PROPAGATED;
+	mapper = NULL;
+	forwardCache = NULL;
+	surrogate = NULL;
+	backend = new SerialBackend();
+	observationModel = NULL;
+	observationBlockSize = 0;
+	singlePrecision = false;
+	communicationMode = SigmaPointsExchange::GATHER_BROADCAST;
 }
 
 AbstractROUKF::~AbstractROUKF() {
+	delete backend;
+	delete mapper;
+	delete observationModel;
+	delete forwardCache;
+	delete surrogate;
 }
 
 void AbstractROUKF::getParameters(double** thetac) {
@@ -22,6 +54,7 @@ void AbstractROUKF::getParameters(double** thetac) {
 
 void AbstractROUKF::setParameters(double *thetac) {
 	Theta = mat(thetac, nParameters, 1);
+	mapParameters(Theta.memptr());
 }
 
 void AbstractROUKF::getState(double** xc) {
@@ -32,6 +65,19 @@ void AbstractROUKF::setState(double* xc) {
 	X = mat(xc, nStates, 1);
 }
 
+void AbstractROUKF::copyState(double* xc) const {
+	memcpy(xc, X.memptr(), nStates * sizeof(double));
+}
+
+void AbstractROUKF::copyParameters(double* thetac) {
+	memcpy(thetac, Theta.memptr(), nParameters * sizeof(double));
+	unmapParameters(thetac);
+}
+
+void AbstractROUKF::copyError(double* err) const {
+	memcpy(err, error.memptr(), nObservations * sizeof(double));
+}
+
 void AbstractROUKF::getError(double** err) {
 	*err = error.memptr();
 }
@@ -45,12 +91,16 @@ void AbstractROUKF::toString() {
 	X.print("X:");
 	Theta.print("Theta:");
 	U.print("U:");
-	LX.print("LX:");
+	R.print("R:");
+	if (singlePrecision)
+		LXf.print("LX:");
+	else
+		LX.print("LX:");
 	LTheta.print("LTheta:");
 	sigma.print("sigma:");
 	Dsigma.print("Dsigma:");
 	Pa.print("Pa:");
-	Wi.print("Wi:");
+	observationModel->getCovariance().print("Observations covariance:");
 
 }
 
@@ -59,6 +109,59 @@ vector<double> AbstractROUKF::getParametersStd() {
 	return arma::conv_to<vector<double> >::from(std);
 }
 
+void AbstractROUKF::buildCovarianceFactor() {
+	if (covarianceFactorValid)
+		return;
+	covarianceFactor = LTheta.t();
+	StepWorkspace::solveUpper(R, covarianceFactor.memptr(), nParameters);
+	covarianceFactorValid = true;
+}
+
+void AbstractROUKF::copyParametersCovariance(double *P) {
+	buildCovarianceFactor();
+	mat cov(P, nParameters, nParameters, false, true);
+	cov = covarianceFactor.t() * covarianceFactor;
+}
+
+vector<double> AbstractROUKF::getParametersMarginalStd(const vector<int> &parameters) {
+	for (size_t k = 0; k < parameters.size(); ++k)
+		if (parameters[k] < 0 || parameters[k] >= nParameters) {
+			cerr << "The filter has no parameter " << parameters[k] << "." << endl;
+			return vector<double>();
+		}
+	buildCovarianceFactor();
+	vector<int> indexes = parameters;
+	if (indexes.empty())
+		for (int j = 0; j < nParameters; ++j)
+			indexes.push_back(j);
+
+	//	The variance of the parameter j is the squared norm of the column j of the factor
+	vector<double> std;
+	for (size_t k = 0; k < indexes.size(); ++k)
+		std.push_back(norm(covarianceFactor.col(indexes[k]), 2));
+	return std;
+}
+
+bool AbstractROUKF::copyStateParametersCovariance(double *C, int first, int count) {
+	if (statePropagation != PROPAGATED || first < 0 || count < 1 || first + count > nStates) {
+		cerr << "The cross-covariance of the states " << first << " to " << first + count - 1
+				<< " is not available." << endl;
+		return false;
+	}
+	buildCovarianceFactor();
+
+	//	(LX R^{-T}) (R^{-1} LTheta^T), only for the requested rows of LX
+	mat rowsT;
+	if (singlePrecision)
+		rowsT = conv_to<mat>::from(LXf.rows(first, first + count - 1).t());
+	else
+		rowsT = LX.rows(first, first + count - 1).t();
+	StepWorkspace::solveUpper(R, rowsT.memptr(), count);
+	mat cov(C, count, nParameters, false, true);
+	cov = rowsT.t() * covarianceFactor;
+	return true;
+}
+
 int AbstractROUKF::getObservations() const
 {
 	return nObservations;
@@ -69,6 +172,11 @@ int AbstractROUKF::getStates() const
 	return nStates;
 }
 
+int AbstractROUKF::getSigmaPoints() const
+{
+	return sigma.n_cols;
+}
+
 double AbstractROUKF::getMaxIterations() const
 {
 	return maxIterations;
@@ -89,6 +197,80 @@ void AbstractROUKF::setTolerance(double tolerance)
 	this->tolerance = tolerance;
 }
 
+int AbstractROUKF::getStagnationIterations() const {
+	return stagnationIterations;
+}
+
+void AbstractROUKF::setStagnationIterations(int stagnationIterations) {
+	this->stagnationIterations = stagnationIterations;
+}
+
+double AbstractROUKF::getDivergenceFactor() const {
+	return divergenceFactor;
+}
+
+void AbstractROUKF::setDivergenceFactor(double divergenceFactor) {
+	this->divergenceFactor = divergenceFactor;
+}
+
+AbstractROUKF::RUN_STATUS AbstractROUKF::run(const function<double()> &step, bool isConvergenceRelative) {
+	double bestError = datum::inf, previousError = 0;
+	int sinceBest = 0;
+	mat previousTheta = Theta;
+	for (long long int it = 0; it < (long long int) maxIterations; ++it) {
+		double err = step();
+		if (!std::isfinite(err) || !Theta.is_finite())
+			return NOT_A_NUMBER;
+		if (err < 0)
+			return FAILED;
+		if (divergenceFactor > 0 && err > divergenceFactor * bestError)
+			return DIVERGED;
+
+		//	Convergence of the error or of the parameters, only between steps of this run so that
+		//	the steps done before do not count
+		if (it > 0) {
+			double errorChange = abs(err - previousError);
+			if (isConvergenceRelative)
+				errorChange /= previousError;
+			double change = norm(Theta - previousTheta, 2);
+			if (isConvergenceRelative)
+				change /= std::max(norm(previousTheta, 2), datum::eps);
+			if (errorChange < tolerance || change < tolerance)
+				return CONVERGED;
+		}
+		previousError = err;
+		previousTheta = Theta;
+
+		//	Stagnation, improvements under the tolerance do not count
+		if (err < bestError * (1 - tolerance)) {
+			bestError = err;
+			sinceBest = 0;
+		} else if (stagnationIterations > 0 && ++sinceBest >= stagnationIterations)
+			return STAGNATED;
+	}
+	return MAX_ITERATIONS;
+}
+
+AbstractROUKF::RUN_STATUS AbstractROUKF::run(const double *zkhatc, const forwardFunction &A,
+		const observationFunction &H, bool isConvergenceRelative) {
+	return run([&]() {
+		return executeStep(zkhatc, A, H);
+	}, isConvergenceRelative);
+}
+
+AbstractROUKF::RUN_STATUS AbstractROUKF::run(const double *zkhatc, const batchForwardFunction &A,
+		const batchObservationFunction &H, bool isConvergenceRelative) {
+	return run([&]() {
+		return executeStep(zkhatc, A, H);
+	}, isConvergenceRelative);
+}
+
+const char *AbstractROUKF::getName(RUN_STATUS status) {
+	static const char *names[] = { "converged", "max_iterations", "stagnated", "not_a_number", "diverged",
+			"failed" };
+	return status <= FAILED ? names[status] : "";
+}
+
 bool AbstractROUKF::hasConverged(bool isConvergenceRelative) {
 	if (currIt > 1) {
 		double diff = abs(currError - prevError);
@@ -100,3 +282,1050 @@ bool AbstractROUKF::hasConverged(bool isConvergenceRelative) {
 	}
 	return false;
 }
+
+void AbstractROUKF::setExecutionBackend(AbstractExecutionBackend *backend) {
+	delete this->backend;
+	this->backend = backend ? backend : new SerialBackend();
+	allocateWorkspace();
+}
+
+AbstractExecutionBackend *AbstractROUKF::getExecutionBackend() const {
+	return backend;
+}
+
+void AbstractROUKF::setThreads(int nThreads) {
+	if (nThreads > 1)
+		setExecutionBackend(new ThreadsBackend(nThreads));
+	else
+		setExecutionBackend(new SerialBackend());
+}
+
+int AbstractROUKF::getThreads() const {
+	return backend->getThreads();
+}
+
+void AbstractROUKF::setParameterMapper(CompositeParameterMapper *mapper) {
+	//	Remap kalman parameters from previous kalman parameters space into the new one.
+	unmapParameters(Theta.memptr());
+	delete this->mapper;
+	this->mapper = mapper;
+	mapParameters(Theta.memptr());
+}
+
+AbstractROUKF::STATE_PROPAGATION AbstractROUKF::getStatePropagation() const {
+	return statePropagation;
+}
+
+void AbstractROUKF::unmapParameters(double *thetac, int nColumns) {
+	if (mapper)
+		mapper->unmapBlock(thetac, nParameters, nColumns, nParameters);
+}
+
+void AbstractROUKF::mapParameters(double *thetac, int nColumns) {
+	if (mapper)
+		mapper->mapBlock(thetac, nParameters, nColumns, nParameters);
+}
+
+AbstractExecutionBackend::Blocks AbstractROUKF::getBlocks(bool withObservations) {
+	AbstractExecutionBackend::Blocks blocks;
+	blocks.Xk = statePropagation == PROPAGATED ? workspace.Xk.memptr() : NULL;
+	blocks.Thetak = workspace.Thetak.memptr();
+	blocks.Zk = withObservations ? workspace.Zk.memptr() : NULL;
+	blocks.nStates = nStates;
+	blocks.nParameters = nParameters;
+	blocks.nObservations = withObservations ? nObservations : 0;
+	blocks.nSigma = sigma.n_cols;
+	blocks.singlePrecision = singlePrecision;
+	blocks.profiler = &profiler;
+	blocks.failed = &(stepFailed[0]);
+	return blocks;
+}
+
+/**
+ * Returns if all the observations of a sigma point are finite, observation operators flag their
+ * failures with a non-finite observation.
+ * @param zk Observations.
+ * @param nObservations Quantity of observations.
+ * @return If no observation is NaN or infinite.
+ */
+static bool finiteObservations(const double *zk, int nObservations) {
+	for (int j = 0; j < nObservations; ++j)
+		if (!std::isfinite(zk[j]))
+			return false;
+	return true;
+}
+
+void AbstractROUKF::propagateSigmaPoint(int i, int thread, const forwardFunction &A, const observationFunction &H) {
+	//	Filters with static states propagate each sigma point in the scratch column of its thread
+	double *xk = statePropagation == PROPAGATED ? workspace.Xk.colptr(i) : workspace.xkScratch.colptr(thread);
+	double *thetak = workspace.Thetak.colptr(i);
+	double *zk = workspace.Zk.colptr(i);
+
+	//	Observations already answered by the surrogate model or the forward cache
+	if (H && stepKnown[i])
+		return;
+
+	//	Transform theta_k -kalman parameters- to problem values -problem parameters-
+	unmapParameters(thetak);
+
+	//	Propagate sigma point
+	{
+		StepProfiler::Scope scope(&profiler, StepProfiler::FORWARD, thread);
+		if (A(xk, nStates, thetak, nParameters) < 0)
+			stepFailed[i] = 1;
+	}
+	profiler.count(StepProfiler::FORWARD_CALLS);
+
+	//	Perform observation
+	if (H) {
+		StepProfiler::Scope scope(&profiler, StepProfiler::OBSERVATION, thread);
+		H(xk, nStates, zk, nObservations);
+		profiler.count(StepProfiler::OBSERVATION_CALLS);
+		if (!finiteObservations(zk, nObservations))
+			stepFailed[i] = 1;
+	}
+	mapParameters(thetak);
+}
+
+void AbstractROUKF::propagateWindow(int i, int thread, const double *times, int nTimes,
+		const windowForwardFunction &A, const observationFunction &H) {
+	double *xk = statePropagation == PROPAGATED ? workspace.Xk.colptr(i) : workspace.xkScratch.colptr(thread);
+	double *thetak = workspace.Thetak.colptr(i);
+
+	unmapParameters(thetak);
+	for (int k = 0; k < nTimes; ++k) {
+		{
+			StepProfiler::Scope scope(&profiler, StepProfiler::FORWARD, thread);
+			if (A(xk, nStates, thetak, nParameters, times[k]) < 0)
+				stepFailed[i] = 1;
+		}
+		StepProfiler::Scope scope(&profiler, StepProfiler::OBSERVATION, thread);
+		double *zk = workspace.Zk.colptr(i) + k * nObservations;
+		H(xk, nStates, zk, nObservations);
+		if (!finiteObservations(zk, nObservations))
+			stepFailed[i] = 1;
+	}
+	profiler.count(StepProfiler::FORWARD_CALLS, nTimes);
+	profiler.count(StepProfiler::OBSERVATION_CALLS, nTimes);
+	mapParameters(thetak);
+}
+
+bool AbstractROUKF::evaluateSigmaPoints(const function<void(int, int)> &evaluate,
+		AbstractExecutionBackend &backend, const AbstractExecutionBackend::Blocks &blocks) {
+	restorePartialStep();
+	if (backend.sharesMemory())
+		startStepCheckpoint();
+	std::fill(stepFailed.begin(), stepFailed.end(), 0);
+
+	//	Each sigma point only touches its own columns of the workspace, hence they can be
+	//	evaluated concurrently with the same results as in serial execution. The lambda only
+	//	captures two pointers, so that its std::function is stored without allocation.
+	const pair<const function<void(int, int)> *, bool> task(&evaluate, backend.sharesMemory());
+	bool evaluated = backend.evaluate(blocks, [this, &task](int i, int thread) {
+		if (stepDone[i])
+			return;
+		(*task.first)(i, thread);
+		if (task.second && !stepFailed[i])
+			markEvaluated(i);
+	});
+	if (!evaluated)
+		cerr << "The sigma points could not be evaluated, the estimate is unchanged." << endl;
+	return evaluated;
+}
+
+bool AbstractROUKF::failedSigmaPoints(AbstractExecutionBackend &backend, const AbstractExecutionBackend::Blocks &blocks) {
+	if (!backend.anyFailed(blocks))
+		return false;
+	//	Completes the exchange of the states, so that no communication is left pending. A new
+	//	step evaluates all its sigma points again.
+	backend.waitStates(blocks);
+	std::fill(stepDone.begin(), stepDone.end(), 0);
+	cerr << "The forward or observation operator failed, the estimate is unchanged." << endl;
+	return true;
+}
+
+double AbstractROUKF::evaluateAndAssimilate(const double *zkhatc,
+		const function<void(int, int)> &evaluate, AbstractExecutionBackend &backend) {
+	//	The emulator learns the sigma points of the previous step, it stays fixed during this one
+	if (surrogate)
+		surrogate->fit();
+
+	//	Sampling, only of its own sigma point if the process evaluates a single one. With static
+	//	states the observations only depend on the parameters and may be cached, all sigma points
+	//	are then sampled (only their parameters) to find the ones that share an entry.
+	bool cached = forwardCache && statePropagation == STATIC;
+	{
+		StepProfiler::Scope scope(&profiler, StepProfiler::SAMPLING);
+		if (backend.getLocalSigmaPoint() >= 0 && !cached)
+			sampleSigmaPoint(backend.getLocalSigmaPoint());
+		else
+			sampleSigmaPoints();
+	}
+	answerSigmaPoints(backend.getLocalSigmaPoint());
+
+	AbstractExecutionBackend::Blocks blocks = getBlocks();
+	if (!evaluateSigmaPoints(evaluate, backend, blocks))
+		return -1;
+
+	//	Parameters are updated while the states may still be in flight.
+	backend.waitParametersAndObservations(blocks);
+	if (failedSigmaPoints(backend, blocks))
+		return -1;
+	recordSigmaPoints(backend.getLocalSigmaPoint());
+	double err = assimilateObservations(zkhatc);
+	backend.waitStates(blocks);
+	assimilateStates(err >= 0);
+	return err;
+}
+
+void AbstractROUKF::answerSigmaPoints(int local) {
+	std::fill(stepKnown.begin(), stepKnown.end(), 0);
+	std::fill(stepShared.begin(), stepShared.end(), 0);
+	bool cached = forwardCache && statePropagation == STATIC;
+	if (cached) {
+		workspace.problemThetak = workspace.Thetak;
+		unmapParameters(workspace.problemThetak.memptr(), sigma.n_cols);
+		forwardCache->findShared(workspace.problemThetak.memptr(), nParameters, sigma.n_cols, &(stepShared[0]));
+	}
+	for (int i = 0; i < (int) sigma.n_cols; ++i) {
+		if (local >= 0 && i != local)
+			continue;
+		//	Emulated sigma point, in the kalman space
+		if (surrogate && surrogate->predict(workspace.Thetak.colptr(i), workspace.Zk.colptr(i))) {
+			stepKnown[i] = 1;
+			profiler.count(StepProfiler::SURROGATE_PREDICTIONS);
+		} else if (cached && !stepShared[i] && forwardCache->lookup(workspace.problemThetak.colptr(i),
+				nParameters, workspace.Zk.colptr(i), nObservations)) {
+			stepKnown[i] = 1;
+			profiler.count(StepProfiler::FORWARD_CACHE_HITS);
+		}
+	}
+}
+
+void AbstractROUKF::recordSigmaPoints(int local) {
+	//	Only the sigma points truly evaluated in this step, whose problem parameters were computed
+	//	by answerSigmaPoints
+	bool cached = forwardCache && statePropagation == STATIC;
+	for (int i = 0; i < (int) sigma.n_cols; ++i) {
+		if (stepKnown[i] || (local >= 0 && i != local))
+			continue;
+		if (cached && !stepShared[i])
+			forwardCache->insert(workspace.problemThetak.colptr(i), nParameters, workspace.Zk.colptr(i),
+					nObservations);
+		if (surrogate)
+			surrogate->addSample(workspace.Thetak.colptr(i), workspace.Zk.colptr(i));
+	}
+}
+
+double AbstractROUKF::executeStep(const double *zkhatc, const forwardFunction &A, const observationFunction &H) {
+	//	Two pointers captured, stored by std::function without allocation
+	const pair<const forwardFunction *, const observationFunction *> operators(&A, &H);
+	return evaluateAndAssimilate(zkhatc, [this, &operators](int i, int thread) {
+		propagateSigmaPoint(i, thread, *operators.first, *operators.second);
+	}, *backend);
+}
+
+double AbstractROUKF::executeStep(const double *zkhatc, const batchForwardFunction &A, const batchObservationFunction &H) {
+
+	//	Matrixes
+	mat &Xk = workspace.Xk, &Thetak = workspace.Thetak, &Zk = workspace.Zk;
+
+	//	Sampling
+	{
+		StepProfiler::Scope scope(&profiler, StepProfiler::SAMPLING);
+		sampleSigmaPoints();
+	}
+
+	//	Propagate and observe the whole ensemble at once in the problem parameters space
+	unmapParameters(Thetak.memptr(), sigma.n_cols);
+	bool failed;
+	{
+		StepProfiler::Scope scope(&profiler, StepProfiler::FORWARD);
+		failed = A(Xk.memptr(), nStates, Thetak.memptr(), nParameters, sigma.n_cols) < 0;
+	}
+	mapParameters(Thetak.memptr(), sigma.n_cols);
+	if (failed) {
+		cerr << "The forward operator failed, the estimate is unchanged." << endl;
+		return -1;
+	}
+	{
+		StepProfiler::Scope scope(&profiler, StepProfiler::OBSERVATION);
+		H(Xk.memptr(), nStates, Zk.memptr(), nObservations, sigma.n_cols);
+	}
+	profiler.count(StepProfiler::FORWARD_CALLS);
+	profiler.count(StepProfiler::OBSERVATION_CALLS);
+	if (!Zk.is_finite()) {
+		cerr << "The observation operator failed, the estimate is unchanged." << endl;
+		return -1;
+	}
+
+	return assimilate(zkhatc);
+}
+
+double AbstractROUKF::executeStepStreaming(const double *zkhatc, const forwardFunction &A, const blockObservationFunction &H) {
+	if (statePropagation != PROPAGATED) {
+		cerr << "The streaming step needs the states of the sigma points." << endl;
+		return -1;
+	}
+
+	//	Sampling
+	{
+		StepProfiler::Scope scope(&profiler, StepProfiler::SAMPLING);
+		sampleSigmaPoints(false);
+	}
+
+	//	Propagate sigma points, observations are evaluated by blocks afterwards
+	AbstractExecutionBackend::Blocks blocks = getBlocks(false);
+	if (!evaluateSigmaPoints([&](int i, int thread) {
+		propagateSigmaPoint(i, thread, A, observationFunction());
+	}, *backend, blocks))
+		return -1;
+	backend->waitParametersAndObservations(blocks);
+	if (failedSigmaPoints(*backend, blocks))
+		return -1;
+	backend->waitStates(blocks);
+
+	return streamAndAssimilate(zkhatc, H);
+}
+
+double AbstractROUKF::executeStepWindow(const double *zkhatc, const double *times, int nTimes,
+		const windowForwardFunction &A, const observationFunction &H) {
+	if (nTimes < 1) {
+		cerr << "The window needs at least one observation time." << endl;
+		return -1;
+	}
+
+	//	Sampling, the observations of all times are stacked in the rows of Zk
+	{
+		StepProfiler::Scope scope(&profiler, StepProfiler::SAMPLING);
+		sampleSigmaPoints(false);
+	}
+	profiler.count(StepProfiler::WORKSPACE_ALLOCATIONS,
+			workspace.resizeObservations(nObservations * nTimes, nParameters, sigma.n_cols));
+
+	AbstractExecutionBackend::Blocks blocks = getBlocks();
+	blocks.nObservations = nObservations * nTimes;
+	if (!evaluateSigmaPoints([&](int i, int thread) {
+		propagateWindow(i, thread, times, nTimes, A, H);
+	}, *backend, blocks))
+		return -1;
+
+	backend->waitParametersAndObservations(blocks);
+	if (failedSigmaPoints(*backend, blocks))
+		return -1;
+	double err = assimilateWindow(zkhatc, nTimes);
+	backend->waitStates(blocks);
+	assimilateStates(err >= 0);
+	return err;
+}
+
+double AbstractROUKF::executeStepParallel(const double *zkhatc, const forwardFunction &A, const observationFunction &H,
+		int sigmaPoint, MPI_Comm world_comm, MPI_Comm sigmaMasters_comm) {
+	sigmaPointBackend.setup(sigmaPoint, world_comm, sigmaMasters_comm, communicationMode);
+	return evaluateAndAssimilate(zkhatc, [&](int i, int thread) {
+		propagateSigmaPoint(i, thread, A, H);
+	}, sigmaPointBackend);
+}
+
+double AbstractROUKF::executeStepScheduled(const double *zkhatc, const forwardFunction &A, const observationFunction &H,
+		MPI_Comm group_comm, MPI_Comm masters_comm) {
+	groupsBackend.setup(group_comm, masters_comm, backend->getThreadPool());
+	return evaluateAndAssimilate(zkhatc, [&](int i, int thread) {
+		propagateSigmaPoint(i, thread, A, H);
+	}, groupsBackend);
+}
+
+void AbstractROUKF::parallelFor(int n, const function<void(int, int)> &evaluate) {
+	ThreadPool *pool = backend->getThreadPool();
+	if (pool)
+		pool->parallelFor(n, evaluate);
+	else
+		for (int i = 0; i < n; i++)
+			evaluate(i, 0);
+}
+
+void AbstractROUKF::restorePartialStep() {
+	if (!resumeCheckpoint.has("stepDone"))
+		return;
+	bool restored = statePropagation != PROPAGATED
+			|| resumeCheckpoint.readColumns("Xk", workspace.Xk, stepDone);
+	restored = restored && resumeCheckpoint.readColumns("Thetak", workspace.Thetak, stepDone);
+	restored = restored && resumeCheckpoint.readColumns("Zk", workspace.Zk, stepDone);
+	if (!restored) {
+		cerr << "The evaluated sigma points could not be restored, the step is evaluated again." << endl;
+		std::fill(stepDone.begin(), stepDone.end(), 0);
+	}
+	resumeCheckpoint.close();
+}
+
+void AbstractROUKF::startStepCheckpoint() {
+	stepCheckpoint.close();
+	if (checkpointFile.empty() || !writeCheckpoint(checkpointFile, true))
+		return;
+	if (!stepCheckpoint.open(checkpointFile, true))
+		cerr << "The sigma points of the step will not be checkpointed." << endl;
+}
+
+void AbstractROUKF::markEvaluated(int i) {
+	stepDone[i] = 1;
+	uint64_t rows, cols;
+	double *done = stepCheckpoint.update("stepDone", &rows, &cols);
+	if (!done)
+		return;
+
+	//	Only the columns of this sigma point are written, which no other sigma point touches,
+	//	hence no lock is needed. The flag is written last, so that an interrupted write is
+	//	never restored.
+	if (statePropagation == PROPAGATED)
+		memcpy(stepCheckpoint.update("Xk", &rows, &cols) + (size_t) i * rows, workspace.Xk.colptr(i),
+				rows * sizeof(double));
+	memcpy(stepCheckpoint.update("Thetak", &rows, &cols) + (size_t) i * rows, workspace.Thetak.colptr(i),
+			rows * sizeof(double));
+	memcpy(stepCheckpoint.update("Zk", &rows, &cols) + (size_t) i * rows, workspace.Zk.colptr(i),
+			rows * sizeof(double));
+	atomic_thread_fence(memory_order_release);
+	done[i] = 1;
+}
+
+void AbstractROUKF::finishStep() {
+	std::fill(stepDone.begin(), stepDone.end(), 0);
+	resumeCheckpoint.close();
+	stepCheckpoint.close();
+	if (!checkpointFile.empty())
+		saveCheckpoint(checkpointFile);
+}
+
+/**
+ * Makes @p m use @p memory as its storage, without copying it.
+ * @param m Matrix.
+ * @param memory Memory of rows x cols elements that outlives @p m .
+ * @param rows Rows of @p m .
+ * @param cols Columns of @p m .
+ */
+template<typename eT>
+static void bindMatrix(Mat<eT> &m, eT *memory, uword rows, uword cols) {
+	m.~Mat<eT>();
+	new (&m) Mat<eT>(memory, rows, cols, false, false);
+}
+
+/**
+ * Moves the content of @p m into memory owned by it.
+ * @param m Matrix.
+ */
+template<typename eT>
+static void unbindMatrix(Mat<eT> &m) {
+	Mat<eT> copy(m);
+	m.~Mat<eT>();
+	new (&m) Mat<eT>();
+	m.swap(copy);
+}
+
+/**
+ * Empties @p m , releasing its memory or detaching it from external memory.
+ * @param m Matrix.
+ */
+template<typename eT>
+static void releaseMatrix(Mat<eT> &m) {
+	m.~Mat<eT>();
+	new (&m) Mat<eT>();
+}
+
+void AbstractROUKF::allocateWorkspace() {
+	//	LX set by the derived filters in double precision
+	if (singlePrecision && !LX.is_empty()) {
+		LXf = conv_to<fmat>::from(LX);
+		releaseMatrix(LX);
+	}
+	if (!stateStorageDirectory.empty())
+		mapStates();
+	profiler.count(StepProfiler::WORKSPACE_ALLOCATIONS,
+			workspace.resize(nStates, nParameters, nObservations, sigma.n_cols, getThreads()));
+	covarianceFactorValid = false;
+	error.set_size(nObservations, 1);
+	stepDone.assign(sigma.n_cols, 0);
+	stepFailed.assign(sigma.n_cols, 0);
+	stepKnown.assign(sigma.n_cols, 0);
+	stepShared.assign(sigma.n_cols, 0);
+}
+
+void AbstractROUKF::setSigmaPoints(SigmaPointsGenerator::SIGMA_DISTRIBUTION distribution) {
+	shared_ptr<const SigmaPointsGenerator::SigmaPointsSet> set =
+			SigmaPointsGenerator::getSigmaPointsSet(nParameters, distribution);
+	sigma = set->sigma;
+	alpha = set->alpha;
+	Dsigma = set->Dsigma;
+	Pa = set->Pa;
+}
+
+void AbstractROUKF::sampleSigmaPoints(bool allocateObservations) {
+	if (allocateObservations)
+		profiler.count(StepProfiler::WORKSPACE_ALLOCATIONS,
+				workspace.resizeObservations(nObservations, nParameters, sigma.n_cols));
+
+	//	Lower Cholesky factor of U^{-1} = R^{-T} R^{-1} applied to all sigma points at once
+	workspace.S = sigma;
+	StepWorkspace::solveUpperTransposed(R, workspace.S.memptr(), sigma.n_cols);
+
+	if (statePropagation == STATIC) {
+		//	States are not sampled, the forward operator starts from its own
+	} else if (stateStorage.isOpen() || singlePrecision) {
+		if (stateStorage.isOpen())
+			mapStates();
+		for (uword first = 0; first < (uword) nStates; first += getStateTileRows())
+			sampleStateRows(first, std::min(first + getStateTileRows(), (uword) nStates) - 1);
+	} else {
+		workspace.Xk = LX * workspace.S;
+		workspace.Xk.each_col() += X;
+	}
+	workspace.Thetak = LTheta * workspace.S;
+	workspace.Thetak.each_col() += Theta;
+}
+
+void AbstractROUKF::sampleSigmaPoint(int i) {
+	profiler.count(StepProfiler::WORKSPACE_ALLOCATIONS,
+			workspace.resizeObservations(nObservations, nParameters, sigma.n_cols));
+
+	double *s = workspace.S.colptr(i);
+	memcpy(s, sigma.colptr(i), nParameters * sizeof(double));
+	StepWorkspace::solveUpperTransposed(R, s, 1);
+
+	if (statePropagation == PROPAGATED) {
+		if (singlePrecision)
+			workspace.Xk.col(i) = X + conv_to<mat>::from(LXf * conv_to<fmat>::from(workspace.S.col(i)));
+		else
+			workspace.Xk.col(i) = X + LX * workspace.S.col(i);
+	}
+	workspace.Thetak.col(i) = Theta + LTheta * workspace.S.col(i);
+}
+
+double AbstractROUKF::assimilate(const double *zkhatc) {
+	double err = assimilateObservations(zkhatc);
+	assimilateStates(err >= 0);
+	return err;
+}
+
+double AbstractROUKF::assimilateObservations(const double *zkhatc) {
+	{
+		StepProfiler::Scope scope(&profiler, StepProfiler::ASSEMBLY);
+
+		//	Expressions are split so that every result is written into preallocated memory.
+		const mat zkhat(const_cast<double *>(zkhatc), nObservations, 1, false, true);
+
+		//	Associated observation
+		workspace.zkMean = mean(workspace.Zk, 1);	// Only constant alpha
+		error = zkhat - workspace.zkMean;
+
+		//	Observation terms of the update
+		workspace.HL = workspace.Zk * Dsigma;
+		observationModel->whiten(workspace.HL.memptr(), workspace.HL.n_cols);
+		workspace.Un = workspace.HL.t() * workspace.HL;
+		workspace.whitenedError = error;
+		observationModel->whiten(workspace.whitenedError.memptr(), 1);
+		workspace.gain = workspace.HL.t() * workspace.whitenedError;
+	}
+
+	return updateParameters(error);
+}
+
+double AbstractROUKF::assimilateWindow(const double *zkhatc, int nTimes) {
+	const int rows = nObservations * nTimes;
+	{
+		StepProfiler::Scope scope(&profiler, StepProfiler::ASSEMBLY);
+		const mat zkhat(const_cast<double *>(zkhatc), rows, 1, false, true);
+
+		//	The residual of the window replaces the mean in zkMean, error keeps nObservations rows
+		workspace.zkMean = mean(workspace.Zk, 1);
+		workspace.zkMean = zkhat - workspace.zkMean;
+
+		//	Each time is whitened by the observation error model, the times are uncorrelated
+		workspace.HL = workspace.Zk * Dsigma;
+		workspace.whitenedError = workspace.zkMean;
+		for (int k = 0; k < nTimes; ++k) {
+			observationModel->whitenRows(workspace.HL.memptr() + k * nObservations, rows, nParameters, 0,
+					nObservations);
+			observationModel->whitenRows(workspace.whitenedError.memptr() + k * nObservations, rows, 1, 0,
+					nObservations);
+		}
+		workspace.Un = workspace.HL.t() * workspace.HL;
+		workspace.gain = workspace.HL.t() * workspace.whitenedError;
+	}
+
+	//	Errors of the last time of the window
+	memcpy(error.memptr(), workspace.zkMean.memptr() + rows - nObservations, nObservations * sizeof(double));
+	return updateParameters(workspace.zkMean);
+}
+
+double AbstractROUKF::updateParameters(const mat &residual) {
+	{
+		StepProfiler::Scope scope(&profiler, StepProfiler::ASSEMBLY);
+
+		workspace.Un += Pa;
+	}
+
+	{
+		StepProfiler::Scope scope(&profiler, StepProfiler::FACTORIZATION);
+		if (!StepWorkspace::cholReversed(workspace.Rn, workspace.Un)) {
+			cerr << "The covariance of the parameters is not positive definite, the estimate is unchanged." << endl;
+			return -1;
+		}
+		U = workspace.Un;
+		R = workspace.Rn;
+		covarianceFactorValid = false;
+
+		//	Compute new estimate, the gain is applied through triangular solves with R
+		StepWorkspace::solveUpper(R, workspace.gain.memptr(), 1);
+		StepWorkspace::solveUpperTransposed(R, workspace.gain.memptr(), 1);
+	}
+	{
+		StepProfiler::Scope scope(&profiler, StepProfiler::ASSEMBLY);
+
+		//	New parameters and their covariance factor
+		workspace.thetakMean = mean(workspace.Thetak, 1);
+		LTheta = workspace.Thetak * Dsigma;
+	}
+	Theta = workspace.thetakMean;
+	Theta += LTheta * workspace.gain;
+	profiler.count(StepProfiler::STEPS);
+
+	prevError = currError;
+	currError = norm(residual, 2);
+	if (errorHistoryLength > 0) {
+		//	Bounded history, its memory is reserved by setErrorHistoryLength. Once full, the
+		//	oldest error is overwritten.
+		if ((int) errorHistory.size() < errorHistoryLength)
+			errorHistory.push_back(currError);
+		else {
+			errorHistory[errorHistoryHead] = currError;
+			errorHistoryHead = (errorHistoryHead + 1) % errorHistory.size();
+		}
+	}
+	++currIt;
+
+	return currError;
+}
+
+void AbstractROUKF::assimilateStates(bool updated) {
+	//	New state
+	if (!updated || statePropagation == STATIC) {
+		//	Failed update, or only the parameters are estimated
+	} else if (stateStorage.isOpen() || singlePrecision) {
+		//	Tiles of rows read each column of Xk and LX sequentially
+		StepProfiler::Scope scope(&profiler, StepProfiler::STATE_UPDATE);
+		for (uword first = 0; first < (uword) nStates; first += getStateTileRows())
+			updateStateRows(first, std::min(first + getStateTileRows(), (uword) nStates) - 1);
+	} else {
+		StepProfiler::Scope scope(&profiler, StepProfiler::STATE_UPDATE);
+		workspace.xkMean = mean(workspace.Xk, 1);
+		LX = workspace.Xk * Dsigma;
+		X = workspace.xkMean;
+		X += LX * workspace.gain;
+	}
+
+	finishStep();
+}
+
+void AbstractROUKF::sampleStateRows(uword first, uword last) {
+	if (singlePrecision)
+		workspace.Xk.rows(first, last) = conv_to<mat>::from(LXf.rows(first, last)) * workspace.S;
+	else
+		workspace.Xk.rows(first, last) = LX.rows(first, last) * workspace.S;
+	workspace.Xk.rows(first, last).each_col() += X.rows(first, last);
+}
+
+void AbstractROUKF::updateStateRows(uword first, uword last) {
+	workspace.xkMean.rows(first, last) = mean(workspace.Xk.rows(first, last), 1);
+	if (singlePrecision) {
+		//	The tile is accumulated in double precision and then rounded
+		mat LXTile = workspace.Xk.rows(first, last) * Dsigma;
+		X.rows(first, last) = workspace.xkMean.rows(first, last) + LXTile * workspace.gain;
+		LXf.rows(first, last) = conv_to<fmat>::from(LXTile);
+	} else {
+		LX.rows(first, last) = workspace.Xk.rows(first, last) * Dsigma;
+		X.rows(first, last) = workspace.xkMean.rows(first, last) + LX.rows(first, last) * workspace.gain;
+	}
+}
+
+bool AbstractROUKF::mapStates() {
+	const size_t nXk = (size_t) nStates * sigma.n_cols;
+	const size_t nLX = (size_t) nStates * nParameters;
+
+	const size_t nLXBytes = nLX * (singlePrecision ? sizeof(float) : sizeof(double));
+
+	double *base = stateStorage.data();
+	bool mappedLX = singlePrecision ? (void *) LXf.memptr() == base + nXk && LXf.n_elem == nLX
+			: LX.memptr() == base + nXk && LX.n_elem == nLX;
+	if (base && workspace.Xk.memptr() == base && workspace.Xk.n_elem == nXk && mappedLX)
+		return true;
+
+	MappedFile storage;
+	if (!storage.create(stateStorageDirectory, nXk * sizeof(double) + nLXBytes))
+		return false;
+
+	//	Current contents are kept if they have the expected size, the file is zero-filled
+	base = storage.data();
+	if (workspace.Xk.n_elem == nXk)
+		memcpy(base, workspace.Xk.memptr(), nXk * sizeof(double));
+	bindMatrix(workspace.Xk, base, nStates, sigma.n_cols);
+	if (singlePrecision) {
+		if (LXf.n_rows == (uword) nStates && LXf.n_cols == (uword) nParameters)
+			memcpy(base + nXk, LXf.memptr(), nLXBytes);
+		bindMatrix(LXf, (float *) (base + nXk), nStates, nParameters);
+	} else {
+		if (LX.n_rows == (uword) nStates && LX.n_cols == (uword) nParameters)
+			memcpy(base + nXk, LX.memptr(), nLXBytes);
+		bindMatrix(LX, base + nXk, nStates, nParameters);
+	}
+	stateStorage.swap(storage);
+	return true;
+}
+
+void AbstractROUKF::initializeLX() {
+	if (!stateStorageDirectory.empty()) {
+		if (mapStates()) {
+			if (singlePrecision)
+				LXf.zeros();
+			else
+				LX.zeros();
+			return;
+		}
+		cerr << "The states are kept in memory." << endl;
+		stateStorageDirectory.clear();
+	}
+	LX = zeros(nStates, nParameters);
+}
+
+uword AbstractROUKF::getStateTileRows() const {
+	//	About 8 MiB of Xk and LX per tile
+	return std::max<uword>(256, (1 << 20) / (sigma.n_cols + nParameters));
+}
+
+bool AbstractROUKF::setStateStorage(const string &directory) {
+	stateStorageDirectory = directory;
+	if (!directory.empty())
+		return mapStates();
+
+	if (stateStorage.isOpen()) {
+		unbindMatrix(workspace.Xk);
+		if (singlePrecision)
+			unbindMatrix(LXf);
+		else
+			unbindMatrix(LX);
+		stateStorage.close();
+	}
+	return true;
+}
+
+const string &AbstractROUKF::getStateStorage() const {
+	return stateStorageDirectory;
+}
+
+double AbstractROUKF::streamAndAssimilate(const double *zkhatc, const blockObservationFunction &H) {
+	const int nSigma = sigma.n_cols;
+	//	By default a block of observations of all sigma points takes about 256 KiB
+	int blockSize = observationBlockSize > 0 ? observationBlockSize : std::max(64, 32768 / nSigma);
+	blockSize = std::min(blockSize, nObservations);
+	profiler.count(StepProfiler::WORKSPACE_ALLOCATIONS,
+			workspace.resizeObservations(blockSize, nParameters, nSigma));
+
+	workspace.Un.zeros();
+	workspace.gain.zeros();
+
+	int first = 0;
+	while (first < nObservations) {
+		//	Blocks never split a group of correlated observations
+		int last = first;
+		while (last < nObservations && last - first < blockSize)
+			last = observationModel->nextIndependentRow(last);
+		const int rows = last - first;
+		if (rows > (int) workspace.Zk.n_rows)
+			profiler.count(StepProfiler::WORKSPACE_ALLOCATIONS,
+					workspace.resizeObservations(rows, nParameters, nSigma));
+
+		//	Views of the first rows of the workspace, packed with leading dimension rows
+		mat Zb(workspace.Zk.memptr(), rows, nSigma, false, true);
+		mat HLb(workspace.HL.memptr(), rows, nParameters, false, true);
+		mat zbMean(workspace.zkMean.memptr(), rows, 1, false, true);
+		mat eb(error.memptr() + first, rows, 1, false, true);
+		mat web(workspace.whitenedError.memptr(), rows, 1, false, true);
+		const mat zbhat(const_cast<double *>(zkhatc) + first, rows, 1, false, true);
+
+		parallelFor(nSigma, [&](int i, int thread) {
+			StepProfiler::Scope scope(&profiler, StepProfiler::OBSERVATION, thread);
+			H(workspace.Xk.colptr(i), nStates, Zb.colptr(i), first, rows);
+		});
+		profiler.count(StepProfiler::OBSERVATION_CALLS, nSigma);
+		if (!Zb.is_finite()) {
+			std::fill(stepDone.begin(), stepDone.end(), 0);
+			cerr << "The observation operator failed, the estimate is unchanged." << endl;
+			return -1;
+		}
+
+		StepProfiler::Scope scope(&profiler, StepProfiler::ASSEMBLY);
+		zbMean = mean(Zb, 1);
+		eb = zbhat - zbMean;
+		HLb = Zb * Dsigma;
+		observationModel->whitenRows(HLb.memptr(), rows, nParameters, first, rows);
+		web = eb;
+		observationModel->whitenRows(web.memptr(), rows, 1, first, rows);
+
+		workspace.Un += HLb.t() * HLb;
+		workspace.gain += HLb.t() * web;
+
+		first = last;
+	}
+
+	double err = updateParameters(error);
+	assimilateStates(err >= 0);
+	return err;
+}
+
+void AbstractROUKF::setCommunicationMode(SigmaPointsExchange::COMMUNICATION_MODE communicationMode) {
+	this->communicationMode = communicationMode;
+}
+
+SigmaPointsExchange::COMMUNICATION_MODE AbstractROUKF::getCommunicationMode() const {
+	return communicationMode;
+}
+
+const vector<double> &AbstractROUKF::getSigmaPointTimings() const {
+	return groupsBackend.getTimings();
+}
+
+void AbstractROUKF::setProfiling(bool enabled, bool tracing) {
+	profiler.setEnabled(enabled, tracing);
+}
+
+bool AbstractROUKF::setSurrogateModel(SurrogateModel *surrogate) {
+	if (surrogate && statePropagation == PROPAGATED) {
+		cerr << "The surrogate model does not propagate the states, it only suits filters with static states." << endl;
+		return false;
+	}
+	if (surrogate && (surrogate->getParameters() != nParameters || surrogate->getObservations() != nObservations)) {
+		cerr << "The surrogate model has " << surrogate->getParameters() << " parameters and "
+				<< surrogate->getObservations() << " observations, the filter " << nParameters << " and "
+				<< nObservations << "." << endl;
+		return false;
+	}
+	delete this->surrogate;
+	this->surrogate = surrogate;
+	return true;
+}
+
+SurrogateModel *AbstractROUKF::getSurrogateModel() const {
+	return surrogate;
+}
+
+const StepProfiler &AbstractROUKF::getProfiler() const {
+	return profiler;
+}
+
+void AbstractROUKF::resetProfiling() {
+	profiler.reset();
+}
+
+bool AbstractROUKF::writeChromeTrace(const string &filename) {
+	//	Events of each MPI process are told apart by its rank
+	int rank = 0, initialized = 0;
+	MPI_Initialized(&initialized);
+	if (initialized)
+		MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	return profiler.writeChromeTrace(filename, rank);
+}
+
+const vector<double> &AbstractROUKF::getErrorHistory() const {
+	std::rotate(errorHistory.begin(), errorHistory.begin() + errorHistoryHead, errorHistory.end());
+	errorHistoryHead = 0;
+	return errorHistory;
+}
+
+void AbstractROUKF::setErrorHistoryLength(int errorHistoryLength) {
+	this->errorHistoryLength = std::max(errorHistoryLength, 0);
+	//	Oldest errors first, so that they are the ones dropped
+	getErrorHistory();
+	if ((int) errorHistory.size() > this->errorHistoryLength)
+		errorHistory.erase(errorHistory.begin(), errorHistory.end() - this->errorHistoryLength);
+	errorHistory.reserve(this->errorHistoryLength);
+}
+
+int AbstractROUKF::getErrorHistoryLength() const {
+	return errorHistoryLength;
+}
+
+void AbstractROUKF::setCheckpointFile(const string &filename) {
+	checkpointFile = filename;
+}
+
+bool AbstractROUKF::saveCheckpoint(const string &filename) {
+	return writeCheckpoint(filename, false);
+}
+
+bool AbstractROUKF::writeCheckpoint(const string &filename, bool allColumns) {
+	vector<double> dims = { (double) nObservations, (double) nStates, (double) nParameters };
+	vector<double> scalars = { alpha, prevError, currError, (double) currIt };
+	vector<double> done(stepDone.begin(), stepDone.end());
+
+	Checkpoint checkpoint;
+	checkpoint.add("dims", dims);
+	checkpoint.add("scalars", scalars);
+	checkpoint.add("X", X);
+	checkpoint.add("Theta", Theta);
+	checkpoint.add("U", U);
+	checkpoint.add("R", R);
+	if (singlePrecision)
+		checkpoint.add("LX", LXf);
+	else
+		checkpoint.add("LX", LX);
+	checkpoint.add("LTheta", LTheta);
+	observationModel->save(checkpoint);
+	checkpoint.add("sigma", sigma);
+	checkpoint.add("Dsigma", Dsigma);
+	checkpoint.add("Pa", Pa);
+	checkpoint.add("error", error);
+	checkpoint.add("errorHistory", getErrorHistory());
+
+	//	Only the finished columns are saved, the others may be under evaluation.
+	if (allColumns || std::find(stepDone.begin(), stepDone.end(), 1) != stepDone.end()) {
+		checkpoint.add("stepDone", done);
+		if (statePropagation == PROPAGATED)
+			checkpoint.add("Xk", workspace.Xk, &stepDone);
+		checkpoint.add("Thetak", workspace.Thetak, &stepDone);
+		checkpoint.add("Zk", workspace.Zk, &stepDone);
+	}
+	return checkpoint.write(filename);
+}
+
+/**
+ * Returns if an entry of a checkpoint exists with the given size.
+ * @param checkpoint Opened checkpoint.
+ * @param name Name of the entry.
+ * @param rows Expected rows.
+ * @param cols Expected columns.
+ * @return If the entry exists with @p rows x @p cols values (any shape if it is empty).
+ */
+static bool hasEntry(const Checkpoint &checkpoint, const string &name, uint64_t rows, uint64_t cols) {
+	uint64_t fileRows, fileCols;
+	if (!checkpoint.find(name, &fileRows, &fileCols)) {
+		cerr << "Checkpoint entry " << name << " is missing." << endl;
+		return false;
+	}
+	if (fileRows * fileCols != rows * cols || (rows * cols > 0 && (fileRows != rows || fileCols != cols))) {
+		cerr << "Checkpoint entry " << name << " is " << fileRows << "x" << fileCols << " instead of "
+				<< rows << "x" << cols << "." << endl;
+		return false;
+	}
+	return true;
+}
+
+bool AbstractROUKF::loadCheckpoint(const string &filename) {
+	//	The checkpoint stays mapped if the evaluated sigma points of a partial step must be restored.
+	Checkpoint &checkpoint = resumeCheckpoint;
+	vector<double> dims, scalars;
+	if (!checkpoint.open(filename) || !checkpoint.read("dims", dims) || !checkpoint.read("scalars", scalars)
+			|| dims.size() != 3 || scalars.size() != 4) {
+		cerr << "Unable to restore the filter from " << filename << "." << endl;
+		checkpoint.close();
+		return false;
+	}
+
+	//	Every entry is checked before the filter is modified, so that it is unchanged on failure
+	uint64_t m = dims[0], n = dims[1], p = dims[2], sigmaRows, nSigma;
+	uint64_t nX = statePropagation == PROPAGATED ? n : 0;
+	AbstractObservationErrorModel *restoredModel = NULL;
+	bool valid = hasEntry(checkpoint, "X", nX, 1) && hasEntry(checkpoint, "Theta", p, 1)
+			&& hasEntry(checkpoint, "U", p, p) && hasEntry(checkpoint, "R", p, p)
+			&& hasEntry(checkpoint, "LX", nX, p) && hasEntry(checkpoint, "LTheta", p, p)
+			&& checkpoint.find("sigma", &sigmaRows, &nSigma) && sigmaRows == p
+			&& hasEntry(checkpoint, "Dsigma", nSigma, p) && hasEntry(checkpoint, "Pa", p, p)
+			&& hasEntry(checkpoint, "error", m, 1) && checkpoint.has("errorHistory");
+	if (valid) {
+		restoredModel = AbstractObservationErrorModel::restore(checkpoint);
+		valid = restoredModel && (uint64_t) restoredModel->getObservations() == m;
+	}
+	if (!valid) {
+		cerr << "Unable to restore the filter from " << filename << "." << endl;
+		delete restoredModel;
+		checkpoint.close();
+		return false;
+	}
+
+	nObservations = m;
+	nStates = n;
+	nParameters = p;
+	alpha = scalars[0];
+	prevError = scalars[1];
+	currError = scalars[2];
+	currIt = scalars[3];
+
+	checkpoint.read("X", X);
+	checkpoint.read("Theta", Theta);
+	checkpoint.read("U", U);
+	checkpoint.read("R", R);
+	if (singlePrecision)
+		checkpoint.read("LX", LXf);
+	else
+		checkpoint.read("LX", LX);
+	checkpoint.read("LTheta", LTheta);
+	covarianceFactorValid = false;
+	setObservationErrorModel(restoredModel);
+	checkpoint.read("sigma", sigma);
+	checkpoint.read("Dsigma", Dsigma);
+	checkpoint.read("Pa", Pa);
+	checkpoint.read("errorHistory", errorHistory);
+	errorHistoryHead = 0;
+	setErrorHistoryLength(errorHistoryLength);
+
+	allocateWorkspace();
+	checkpoint.read("error", error);
+
+	//	Kept opened only if some sigma point of the step was evaluated
+	vector<double> done;
+	if (checkpoint.read("stepDone", done) && done.size() == stepDone.size()
+			&& std::find(done.begin(), done.end(), 1.) != done.end())
+		stepDone.assign(done.begin(), done.end());
+	else
+		checkpoint.close();
+	return true;
+}
+
+void AbstractROUKF::setObservationErrorModel(AbstractObservationErrorModel *observationModel) {
+	if (!observationModel || observationModel->getObservations() != nObservations) {
+		cerr << "Observation error model does not match the " << nObservations << " observations." << endl;
+		delete observationModel;
+		return;
+	}
+	delete this->observationModel;
+	this->observationModel = observationModel;
+}
+
+const AbstractObservationErrorModel *AbstractROUKF::getObservationErrorModel() const {
+	return observationModel;
+}
+
+void AbstractROUKF::setObservationBlockSize(int observationBlockSize) {
+	this->observationBlockSize = observationBlockSize;
+}
+
+int AbstractROUKF::getObservationBlockSize() const {
+	return observationBlockSize;
+}
+
+void AbstractROUKF::setSinglePrecision(bool singlePrecision) {
+	if (singlePrecision == this->singlePrecision)
+		return;
+
+	//	Converted in memory, the storage file is then recreated for the new precision
+	if (singlePrecision) {
+		LXf = conv_to<fmat>::from(LX);
+		releaseMatrix(LX);
+	} else {
+		LX = conv_to<mat>::from(LXf);
+		releaseMatrix(LXf);
+	}
+	this->singlePrecision = singlePrecision;
+	if (!stateStorageDirectory.empty())
+		mapStates();
+}
+
+bool AbstractROUKF::isSinglePrecision() const {
+	return singlePrecision;
+}
@@ -9,11 +9,24 @@
 #define ABSTRACTROUKF_H_
 
 #include <armadillo>
+#include <functional>
 #include <mpi.h>
+#include <string>
 #include <vector>
 
-#include "mapping/AbstractParameterMapper.h"
+#include "io/Checkpoint.h"
+#include "io/MappedFile.h"
+#include "observation/AbstractObservationErrorModel.h"
+#include "mapping/CompositeParameterMapper.h"
+#include "parallel/AbstractExecutionBackend.h"
+#include "parallel/MPIGroupsBackend.h"
+#include "parallel/MPISigmaPointBackend.h"
+#include "parallel/SigmaPointsExchange.h"
+#include "ForwardCache.h"
 #include "SigmaPointsGenerator.h"
+#include "StepProfiler.h"
+#include "StepWorkspace.h"
+#include "SurrogateModel.h"
 
 using namespace std;
 
@@ -21,12 +34,85 @@ using namespace std;
 typedef int (*forwardOp)(double *, int, double *, int);
 /**	Type definition for the observation operator	*/
 typedef void (*observationOp)(double *, int, double *, int);
+/**
+ *	Type definition for the batched forward operator. It receives the states (nStates x nSigma) and
+ *	parameters (nParameters x nSigma) of all sigma points as column-major blocks and propagates
+ *	them in place. The last argument is nSigma.
+ */
+typedef int (*batchForwardOp)(double *, int, double *, int, int);
+/**
+ *	Type definition for the batched observation operator. It receives the states (nStates x nSigma)
+ *	of all sigma points and fills the observations (nObservations x nSigma) as column-major blocks.
+ *	The last argument is nSigma.
+ */
+typedef void (*batchObservationOp)(double *, int, double *, int, int);
+/**
+ *	Type definition for the block observation operator. It receives the state of one sigma point
+ *	and fills the observations [first, first + count) of it. The arguments are
+ *	(state, nStates, observations, first, count).
+ */
+typedef void (*blockObservationOp)(double *, int, double *, int, int);
+/**
+ *	Operators as taken by the filters. Besides the functions above, any callable with the same
+ *	arguments is accepted (functors, lambdas with captures, std::bind), so the solver state can
+ *	travel with the operator instead of living in globals. Each filter step only refers to its
+ *	own operators, hence several filters may run in the same process; when sigma points are
+ *	evaluated by threads, the operators are called concurrently and their context must allow it.
+ *	A negative value returned by a forward operator, or a non-finite value (NaN or infinite) left
+ *	by an observation operator in its observations, flags the evaluation as failed, and the step
+ *	then returns -1 with the estimate unchanged, in every process of the MPI steps.
+ */
+typedef function<int(double *, int, double *, int)> forwardFunction;
+/**	Observation operator with its context (see forwardFunction). */
+typedef function<void(double *, int, double *, int)> observationFunction;
+/**	Batched forward operator with its context (see forwardFunction). */
+typedef function<int(double *, int, double *, int, int)> batchForwardFunction;
+/**	Batched observation operator with its context (see forwardFunction). */
+typedef function<void(double *, int, double *, int, int)> batchObservationFunction;
+/**	Block observation operator with its context (see forwardFunction). */
+typedef function<void(double *, int, double *, int, int)> blockObservationFunction;
+/**
+ *	Forward operator of the windowed steps with its context. It advances the state of one sigma
+ *	point up to an observation time, given as last argument, from the previous observation time
+ *	(or from the end of the previous step for the first time of a window).
+ */
+typedef function<int(double *, int, double *, int, double)> windowForwardFunction;
 
 using namespace arma;
 using namespace std;
 
+/**
+ * Reduced order unscented Kalman filter engine shared by all the filters. A step samples the
+ * sigma points, evaluates them with an execution backend (serial, threads, MPI solvers or
+ * processes) and assimilates them. The filters differ in their policies: how the parameters are
+ * mapped to the problem parameters and whether the states are propagated.
+ */
 class AbstractROUKF {
 
+public:
+	/**	How the states of the sigma points are handled. */
+	enum STATE_PROPAGATION {
+		/**	States are sampled, propagated and estimated together with the parameters. */
+		PROPAGATED,
+		/**	States are scratch memory of the forward operator and are not estimated. */
+		STATIC
+	};
+	/**	Reasons why run stopped. */
+	enum RUN_STATUS {
+		/**	The change of the error or of the parameters fell under the tolerance. */
+		CONVERGED,
+		/**	The maximum quantity of iterations was reached. */
+		MAX_ITERATIONS,
+		/**	The error did not improve its best value during the stagnation iterations. */
+		STAGNATED,
+		/**	The error or the parameters are not finite. */
+		NOT_A_NUMBER,
+		/**	The error grew over the divergence factor times its best value. */
+		DIVERGED,
+		/**	A step failed (its sigma points could not be evaluated). */
+		FAILED
+	};
+
 protected:
 	/**	States vector.	*/
 	arma::mat X;
@@ -36,12 +122,23 @@ protected:
 	arma::mat U;
 	/**	U squared.	*/
 	arma::mat U2;
+	/**
+	 * Upper triangular UL factor of @p U (U = R R^T), kept across steps so that U is never
+	 * inverted. R^{-T} is the lower Cholesky factor of U^{-1} that samples the sigma points.
+	 */
+	arma::mat R;
 	/**	L part of the covariance matrix	after LU factorization concerning to the state part of the extended state vector.	*/
 	arma::mat LX;
+	/**	@p LX in single precision, used instead of it (which is then empty) if @p singlePrecision . */
+	arma::fmat LXf;
 	/**	L part of the covariance matrix	after LU factorization concerning to the parameter part of the extended state vector.	*/
 	arma::mat LTheta;
-	/** Observations confidence matrix.	*/
-	arma::sp_mat Wi;
+	/**	R^{-1} LTheta^T, so that the parameters covariance is its cross product. Built on demand. */
+	arma::mat covarianceFactor;
+	/**	If @p covarianceFactor matches the current @p R and @p LTheta . */
+	bool covarianceFactorValid;
+	/**	Covariance model of the observation errors, used to whiten the observations.	*/
+	AbstractObservationErrorModel *observationModel;
 
 	/**	Matrix with sigma points as columns. */
 	arma::mat sigma;
@@ -66,13 +163,302 @@ protected:
 	double tolerance;
 	/** Maximum number of iterations. */
 	double maxIterations;
+	/**	Iterations without improvement of the best error after which run stops. */
+	int stagnationIterations;
+	/**	Ratio between the error and its best value over which run considers the filter diverged. */
+	double divergenceFactor;
 	/**	Previous iteration error. */
 	double prevError;
 	/**	Current iteration error. */
 	double currError;
 	/** Current iteration. */
 	long long int currIt;
+	/**
+	 * L2 norm of the errors across all observations at the last iterations. Once it holds
+	 * @p errorHistoryLength errors it is a ring whose oldest error is at @p errorHistoryHead ,
+	 * ordered again when it is read.
+	 */
+	mutable vector<double> errorHistory;
+	/**	Position of the oldest error of the full @p errorHistory , overwritten by the next error. */
+	mutable size_t errorHistoryHead;
+	/**	Maximum quantity of errors kept in @p errorHistory , the oldest ones are dropped first. */
+	int errorHistoryLength;
+
+	/**	How the states of the sigma points are handled, set by each filter. */
+	STATE_PROPAGATION statePropagation;
+	/**	Mapping from the problem parameters to the kalman parameters, NULL for the identity. */
+	CompositeParameterMapper *mapper;
+
+	/**	Strategy that evaluates the sigma points in executeStep. */
+	AbstractExecutionBackend *backend;
+	/**	Backend of executeStepParallel. */
+	MPISigmaPointBackend sigmaPointBackend;
+	/**	Backend of executeStepScheduled. */
+	MPIGroupsBackend groupsBackend;
+	/**	Matrices reused by every step. */
+	StepWorkspace workspace;
+	/**	Timers and counters of the phases of the steps, disabled by default. */
+	StepProfiler profiler;
+	/**	Observations of already evaluated parameters, only used with STATIC states, NULL if disabled. */
+	ForwardCache *forwardCache;
+	/**	Emulator of the observations of the sigma points, NULL if disabled. */
+	SurrogateModel *surrogate;
+	/**	Exchange of the sigma points among the MPI solvers. */
+	SigmaPointsExchange::COMMUNICATION_MODE communicationMode;
+
+	/**	File where the filter is checkpointed after each sigma point and each step, empty if none. */
+	string checkpointFile;
+	/**	Sigma points of the current step that have already been evaluated. */
+	vector<char> stepDone;
+	/**	Sigma points of the current step whose forward or observation operator failed (see forwardFunction). */
+	vector<char> stepFailed;
+	/**	Sigma points of the current step answered by the surrogate model or the forward cache before their evaluation. */
+	vector<char> stepKnown;
+	/**	Sigma points of the current step that share their entry of the forward cache with another one. */
+	vector<char> stepShared;
+	/**	Checkpoint with a partially evaluated step, kept opened until the step is resumed. */
+	Checkpoint resumeCheckpoint;
+	/**	Checkpoint of the current step mapped read-write, each evaluated sigma point is written
+	 * in place in it. Only opened during the evaluation of the sigma points. */
+	Checkpoint stepCheckpoint;
+	/**	Observations processed at a time by the streaming step, 0 for an automatic size. */
+	int observationBlockSize;
+	/**	Directory of the file that stores @p workspace.Xk and @p LX , empty to keep them in memory. */
+	string stateStorageDirectory;
+	/**	Memory mapped file with @p workspace.Xk followed by @p LX (or @p LXf ). */
+	MappedFile stateStorage;
+	/**	If @p LX is kept in single precision and the sigma points are communicated in single precision. */
+	bool singlePrecision;
+
+	/**
+	 * Sizes @p workspace and @p error for the current dimensions of the filter. Must be called
+	 * whenever the dimensions, the sigma points or the quantity of threads change.
+	 */
+	void allocateWorkspace();
+	/**
+	 * Sets @p sigma , @p alpha , @p Dsigma and @p Pa from the cached sigma points set of
+	 * @p distribution for the current quantity of parameters.
+	 * @param distribution Type of sigmas applied to assess the unscented transform.
+	 */
+	void setSigmaPoints(SigmaPointsGenerator::SIGMA_DISTRIBUTION distribution);
+
+	/**
+	 * Samples the states of all sigma points for the rows [ @p first , @p last ] from @p LX or
+	 * @p LXf and @p workspace.S .
+	 * @param first First row.
+	 * @param last Last row.
+	 */
+	void sampleStateRows(uword first, uword last);
+	/**
+	 * Updates the states, @p LX or @p LXf for the rows [ @p first , @p last ] from @p workspace.Xk
+	 * and @p workspace.gain .
+	 * @param first First row.
+	 * @param last Last row.
+	 */
+	void updateStateRows(uword first, uword last);
+
+	/**
+	 * Places @p workspace.Xk and @p LX in a new file of @p stateStorage , keeping their content,
+	 * unless they are already there with the current dimensions.
+	 * @return If the matrices are stored in the file.
+	 */
+	bool mapStates();
+	/**
+	 * Sets @p LX to zeros. With a storage directory it is created in the file of
+	 * @p stateStorage , so that neither @p LX nor @p workspace.Xk is ever held in memory. The
+	 * sigma points must already be set.
+	 */
+	void initializeLX();
+	/**
+	 * Returns the rows of @p workspace.Xk and @p LX processed at a time when they are stored in
+	 * a file.
+	 * @return Rows per tile.
+	 */
+	uword getStateTileRows() const;
+
+	/**
+	 * Executes @p evaluate(i, threadId) for each i in [0, @p n ), concurrently if the execution
+	 * backend has a pool of threads.
+	 * @param n Quantity of tasks.
+	 * @param evaluate Function that executes one task.
+	 */
+	void parallelFor(int n, const function<void(int, int)> &evaluate);
+
+	/**
+	 * Transforms the kalman parameters into the problem parameters with @p mapper .
+	 * @param thetac Parameters of @p nColumns consecutive sigma points, transformed in place.
+	 * @param nColumns Quantity of sigma points.
+	 */
+	void unmapParameters(double *thetac, int nColumns = 1);
+	/**
+	 * Transforms the problem parameters into the kalman parameters with @p mapper .
+	 * @param thetac Parameters of @p nColumns consecutive sigma points, transformed in place.
+	 * @param nColumns Quantity of sigma points.
+	 */
+	void mapParameters(double *thetac, int nColumns = 1);
+	/**
+	 * Builds @p covarianceFactor if the factorization or @p LTheta changed since it was last built.
+	 */
+	void buildCovarianceFactor();
+
+	/**
+	 * Returns the blocks of the sigma points of the workspace handed to the execution backends.
+	 * @param withObservations If the observations are shared (false for the streaming step).
+	 * @return Blocks of the sigma points.
+	 */
+	AbstractExecutionBackend::Blocks getBlocks(bool withObservations = true);
+	/**
+	 * Propagates and observes the sigma point @p i in its columns of the workspace, in the
+	 * problem parameters space.
+	 * @param i Index of the sigma point.
+	 * @param thread Thread that evaluates the sigma point.
+	 * @param A Forward operator.
+	 * @param H Observation operator, or an empty function to only propagate the sigma point.
+	 */
+	void propagateSigmaPoint(int i, int thread, const forwardFunction &A, const observationFunction &H);
+	/**
+	 * Evaluates the sampled sigma points with @p backend , skipping the ones already evaluated in
+	 * a resumed step.
+	 * @param evaluate Function that evaluates the sigma point i in the thread threadId.
+	 * @param backend Execution backend.
+	 * @param blocks Blocks of the sigma points.
+	 * @return If all sigma points were evaluated.
+	 */
+	bool evaluateSigmaPoints(const function<void(int, int)> &evaluate, AbstractExecutionBackend &backend,
+			const AbstractExecutionBackend::Blocks &blocks);
+	/**
+	 * Returns if the forward or observation operator failed for any sigma point in any process
+	 * of the filter, after waitParametersAndObservations. The states are then still awaited, so
+	 * that the step can return without communications in flight.
+	 * @param backend Execution backend.
+	 * @param blocks Blocks of the sigma points.
+	 * @return If the step must be discarded.
+	 */
+	bool failedSigmaPoints(AbstractExecutionBackend &backend, const AbstractExecutionBackend::Blocks &blocks);
+	/**
+	 * Step engine: samples the sigma points, evaluates them with @p backend and assimilates them.
+	 * @param zkhatc Current observations.
+	 * @param evaluate Function that evaluates the sigma point i in the thread threadId.
+	 * @param backend Execution backend.
+	 * @return	Current L2 norm of the errors across all observations, or -1 if the sigma points
+	 * could not be evaluated or the covariance of the parameters is no longer positive definite
+	 * (the estimate is then unchanged).
+	 */
+	double evaluateAndAssimilate(const double *zkhatc, const function<void(int, int)> &evaluate,
+			AbstractExecutionBackend &backend);
+	/**
+	 * Answers the sampled sigma points with the surrogate model or the forward cache, flagging
+	 * them in @p stepKnown . Both are only used in the process of the filter, before and after
+	 * the evaluation, hence also with the backends that evaluate the sigma points in other
+	 * processes. Sigma points of the step that share an entry of the cache are all evaluated.
+	 * @param local Only sigma point evaluated by this process, or -1 for all of them.
+	 */
+	void answerSigmaPoints(int local);
+	/**
+	 * Stores the observations of the sigma points truly evaluated in the forward cache (except
+	 * the ones flagged in @p stepShared ) and adds them to the samples of the surrogate model.
+	 * @param local Only sigma point evaluated by this process, or -1 for all of them.
+	 */
+	void recordSigmaPoints(int local);
+	/**
+	 * Copies the sigma points already evaluated in a resumed step from @p resumeCheckpoint into
+	 * the workspace, after they have been sampled again.
+	 */
+	void restorePartialStep();
+	/**
+	 * Checkpoints the filter with room for all the sigma points of the current step, and maps
+	 * the checkpoint so that markEvaluated only writes the columns of each sigma point.
+	 */
+	void startStepCheckpoint();
+	/**
+	 * Flags the sigma point @p i of the current step as evaluated and writes its columns in
+	 * place in the checkpoint of the step. Sigma points may be flagged concurrently.
+	 * @param i Index of the sigma point.
+	 */
+	void markEvaluated(int i);
+	/**
+	 * Flags the current step as finished and checkpoints the filter.
+	 */
+	void finishStep();
+	/**
+	 * Writes the full state of the filter into a binary checkpoint.
+	 * @param filename Checkpoint path.
+	 * @param allColumns If the step entries are written with all the sigma points even if none
+	 * was evaluated (the missing ones as zeros), otherwise only if some was evaluated.
+	 * @return If the checkpoint was written.
+	 */
+	bool writeCheckpoint(const string &filename, bool allColumns);
 
+	/**
+	 * Samples the states and parameters of all sigma points around the current estimate into
+	 * @p workspace.Xk and @p workspace.Thetak .
+	 * @param allocateObservations If the workspace must hold all the observations of each sigma
+	 * point (false for the streaming step).
+	 */
+	void sampleSigmaPoints(bool allocateObservations = true);
+	/**
+	 * Samples the state and parameters of the sigma point @p i into its columns of
+	 * @p workspace.Xk and @p workspace.Thetak .
+	 * @param i Index of the sigma point.
+	 */
+	void sampleSigmaPoint(int i);
+	/**
+	 * Updates the estimate and its covariance with the propagated sigma points stored in
+	 * @p workspace.Xk , @p workspace.Thetak and @p workspace.Zk .
+	 * @param zkhatc Current observations.
+	 * @return	Current L2 norm of the errors across all observations.
+	 */
+	double assimilate(const double *zkhatc);
+	/**
+	 * First part of assimilate, that only needs @p workspace.Thetak and @p workspace.Zk .
+	 * Updates the parameters, the covariance factors and the gain.
+	 * @param zkhatc Current observations.
+	 * @return	Current L2 norm of the errors across all observations.
+	 */
+	double assimilateObservations(const double *zkhatc);
+	/**
+	 * Updates the parameters and the covariance factors from the accumulated observation terms,
+	 * @p workspace.Un = HL^T C^{-1} HL and @p workspace.gain = HL^T C^{-1} error, and from
+	 * @p error . If the new U is not positive definite, the parameters and their covariance are
+	 * left unchanged.
+	 * @param residual Errors whose L2 norm is recorded, @p error or the errors of all times of a window.
+	 * @return	Current L2 norm of the errors across all observations, or -1 if the factorization failed.
+	 */
+	double updateParameters(const mat &residual);
+	/**
+	 * Second part of assimilate, that updates the states from @p workspace.Xk .
+	 * @param updated If the parameters were updated, the states are left unchanged otherwise.
+	 */
+	void assimilateStates(bool updated = true);
+	/**
+	 * Evaluates the observations of the propagated sigma points in @p workspace.Xk by blocks of
+	 * rows and assimilates them. Each block is folded into the p x p and p terms of the update
+	 * as soon as it is evaluated, so the observations of all sigma points are never stored.
+	 * @param zkhatc Current observations.
+	 * @param H Block observation operator.
+	 * @return	Current L2 norm of the errors across all observations.
+	 */
+	double streamAndAssimilate(const double *zkhatc, const blockObservationFunction &H);
+	/**
+	 * Propagates the sigma point @p i through the observation times of a window and observes it
+	 * at each of them, in its columns of the workspace and in the problem parameters space.
+	 * @param i Index of the sigma point.
+	 * @param thread Thread that evaluates the sigma point.
+	 * @param times Observation times of the window.
+	 * @param nTimes Quantity of observation times.
+	 * @param A Windowed forward operator.
+	 * @param H Observation operator.
+	 */
+	void propagateWindow(int i, int thread, const double *times, int nTimes, const windowForwardFunction &A,
+			const observationFunction &H);
+	/**
+	 * Assimilates the observations of all times of a window, stacked in @p workspace.Zk , with a
+	 * block diagonal observation covariance whose blocks are the observation error model.
+	 * @param zkhatc Observations of each time as columns (nObservations x nTimes).
+	 * @param nTimes Quantity of observation times.
+	 * @return	L2 norm of the errors across all observations of the window.
+	 */
+	double assimilateWindow(const double *zkhatc, int nTimes);
 public:
 
 	/**
@@ -98,9 +484,35 @@ public:
 
 	/**
 	 * Returns a vector with the standard variation of each parameter at the current iteration.
+	 * It is sqrt(1 / U_ii), which ignores the correlations among parameters; see
+	 * getParametersMarginalStd for the marginal standard deviations.
 	 * @return Vector with the standard variation of each parameter at the current iteration.
 	 */
 	vector<double> getParametersStd();
+	/**
+	 * Copies the covariance of the parameters, LTheta U^{-1} LTheta^T, in the kalman space. The
+	 * Cholesky factor of U computed by the step is reused and the result is cached until the
+	 * next step, so steps do no extra work when the covariance is not requested.
+	 * @param P Array with room for nParameters x nParameters elements, column-major.
+	 */
+	void copyParametersCovariance(double *P);
+	/**
+	 * Returns the marginal standard deviation of some parameters in the kalman space, the square
+	 * root of the diagonal of the parameters covariance.
+	 * @param parameters Indexes of the parameters, all of them if empty.
+	 * @return Standard deviation of each requested parameter, or an empty vector if an index is
+	 * out of range.
+	 */
+	vector<double> getParametersMarginalStd(const vector<int> &parameters = vector<int>());
+	/**
+	 * Copies the cross-covariance between a range of states and the parameters,
+	 * LX U^{-1} LTheta^T, in the kalman space. Only the requested rows of LX are read.
+	 * @param C Array with room for @p count x nParameters elements, column-major.
+	 * @param first First state of the range.
+	 * @param count Quantity of states of the range.
+	 * @return If the cross-covariance is available (the filter keeps the states and the range is valid).
+	 */
+	bool copyStateParametersCovariance(double *C, int first, int count);
 
 	/**
 	 * Getter of the field @p X.
@@ -120,10 +532,28 @@ public:
 	virtual void getParameters(double **ThetaC);
 	/**
 	 * Setter of the field @p Theta.
-	 * @param ThetaC Array of parameters.
+	 * @param ThetaC Array of problem parameters, mapped into the kalman parameters.
 	 */
 	virtual void setParameters(double *ThetaC);
 
+	/**
+	 * Copies the field @p X into a caller-provided array.
+	 * @param XC Array with room for @p nStates elements.
+	 */
+	void copyState(double *XC) const;
+	/**
+	 * Copies the field @p Theta , transformed into the problem parameters, into a caller-provided
+	 * array.
+	 * @param ThetaC Array with room for @p nParameters elements.
+	 */
+	virtual void copyParameters(double *ThetaC);
+	/**
+	 * Copies the error associated to each observation at the current iteration into a
+	 * caller-provided array.
+	 * @param err Array with room for @p nObservations elements.
+	 */
+	void copyError(double *err) const;
+
 	/**
 	 * Returns the error associated to each observation at the current iteration in a STL array.
 	 * @param err Error associated to each observation at the current iteration.
@@ -145,6 +575,11 @@ public:
 	 * @return Number of states used in this instance of the kalman filter.
 	 */
 	int getStates() const;
+	/**
+	 * Return the number of sigma points evaluated at each step.
+	 * @return Number of sigma points.
+	 */
+	int getSigmaPoints() const;
 
 	/**
 	 * Getter of the field @p maxIterations.
@@ -166,6 +601,358 @@ public:
 	 * @param tolerance Maximum tolerance allowed.
 	 */
 	void setTolerance(double tolerance);
+	/**
+	 * Getter of the field @p stagnationIterations.
+	 * @return Field @p stagnationIterations.
+	 */
+	int getStagnationIterations() const;
+	/**
+	 * Setter of the field @p stagnationIterations.
+	 * @param stagnationIterations Iterations without improvement, 0 to disable the detection.
+	 */
+	void setStagnationIterations(int stagnationIterations);
+	/**
+	 * Getter of the field @p divergenceFactor.
+	 * @return Field @p divergenceFactor.
+	 */
+	double getDivergenceFactor() const;
+	/**
+	 * Setter of the field @p divergenceFactor.
+	 * @param divergenceFactor Ratio over the best error, 0 to disable the detection.
+	 */
+	void setDivergenceFactor(double divergenceFactor);
+
+	/**
+	 * Steps the filter until it converges or one of the stop criteria is met, at most
+	 * maxIterations steps. After each step it stops if:
+	 *	- the step failed (FAILED) or the error or parameters are NaN or infinite (NOT_A_NUMBER);
+	 *	- the error exceeds divergenceFactor times its best value of the run (DIVERGED);
+	 *	- the change of the error (as in hasConverged) or of the parameters since the previous
+	 *	step of the run is under the tolerance (CONVERGED);
+	 *	- the best error did not improve for stagnationIterations steps (STAGNATED).
+	 * Any step can be driven, hence it works with every filter and execution mode, e.g.
+	 *
+	 *	@code
+	 *	status = filter.run([&]() {
+	 *		return filter.executeStepScheduled(observations, ptA, ptH, groupComm, mastersComm);
+	 *	});
+	 *	@endcode
+	 * Only the steps of this run are considered, hence a new run does at least two steps before it
+	 * converges. All the processes of a parallel filter hold the same estimate, hence they stop
+	 * together.
+	 * @param step Function that performs one step and returns its error (or -1).
+	 * @param isConvergenceRelative If the tolerance is relative to the error and the parameters.
+	 * @return Reason why the run stopped.
+	 */
+	RUN_STATUS run(const function<double()> &step, bool isConvergenceRelative = true);
+	/**
+	 * Runs executeStep with the same observations at each step. See run.
+	 * @param Zkhatc	Observations.
+	 * @param A	Forward operator.
+	 * @param H	Observation operator.
+	 * @param isConvergenceRelative If the tolerance is relative to the error and the parameters.
+	 * @return Reason why the run stopped.
+	 */
+	RUN_STATUS run(const double *Zkhatc, const forwardFunction &A, const observationFunction &H,
+			bool isConvergenceRelative = true);
+	/**
+	 * Runs the batched executeStep with the same observations at each step. See run.
+	 * @param Zkhatc	Observations.
+	 * @param A	Batched forward operator.
+	 * @param H	Batched observation operator.
+	 * @param isConvergenceRelative If the tolerance is relative to the error and the parameters.
+	 * @return Reason why the run stopped.
+	 */
+	RUN_STATUS run(const double *Zkhatc, const batchForwardFunction &A, const batchObservationFunction &H,
+			bool isConvergenceRelative = true);
+	/**
+	 * Returns the name of a run status.
+	 * @param status Run status.
+	 * @return Name of @p status .
+	 */
+	static const char *getName(RUN_STATUS status);
+
+	/**
+	 * Performs one step of the Kalman filtering process evaluating the sigma points with the
+	 * execution backend (serial by default).
+	 * @param Zkhatc	Current observations estimations.
+	 * @param A	Forward operator.
+	 * @param H	Observation operator;
+	 * @return	Current L2 norm of the errors across all observations, or -1 if an operator failed or
+	 * the covariance of the parameters is no longer positive definite (the estimate is then
+	 * unchanged).
+	 */
+	double executeStep(const double *Zkhatc, const forwardFunction &A, const observationFunction &H);
+	/**
+	 * Performs one step of the Kalman filtering process evaluating all sigma points with a single
+	 * call to the batched operators. In filters with STATIC states, the states block passed to the
+	 * operators is scratch memory.
+	 * @param Zkhatc	Current observations estimations.
+	 * @param A	Batched forward operator.
+	 * @param H	Batched observation operator;
+	 * @return	Current L2 norm of the errors across all observations, or -1 if an operator failed or
+	 * the covariance of the parameters is no longer positive definite (the estimate is then
+	 * unchanged).
+	 */
+	double executeStep(const double *Zkhatc, const batchForwardFunction &A, const batchObservationFunction &H);
+	/**
+	 * Performs one step of the Kalman filtering process evaluating the observations by blocks.
+	 * Only one block of observations of the sigma points is held in memory, hence it suits
+	 * problems with a very large quantity of observations. Not available for STATIC states.
+	 * @param Zkhatc	Current observations estimations.
+	 * @param A	Forward operator.
+	 * @param H	Block observation operator.
+	 * @return	Current L2 norm of the errors across all observations, or -1 if an operator failed or
+	 * the covariance of the parameters is no longer positive definite (the estimate is then
+	 * unchanged).
+	 */
+	double executeStepStreaming(const double *Zkhatc, const forwardFunction &A, const blockObservationFunction &H);
+	/**
+	 * Performs one step of the Kalman filtering process that assimilates the observations of
+	 * several times at once. Each sigma point is propagated from one observation time to the
+	 * next and observed at each of them, then a single update (one p x p factorization and one
+	 * gain application) assimilates the whole window with a block diagonal observation
+	 * covariance. The states are estimated at the last time of the window. Afterwards getError
+	 * gives the errors at the last time, while the returned norm and the error history cover the
+	 * whole window.
+	 * @param Zkhatc	Observations of each time as columns (nObservations x nTimes).
+	 * @param times	Observation times, in increasing order.
+	 * @param nTimes	Quantity of observation times.
+	 * @param A	Windowed forward operator.
+	 * @param H	Observation operator.
+	 * @return	L2 norm of the errors across all observations of the window, or -1 if the sigma
+	 * points could not be evaluated, an operator failed or the covariance of the parameters is no longer positive
+	 * definite (the estimate is then unchanged).
+	 */
+	double executeStepWindow(const double *Zkhatc, const double *times, int nTimes,
+			const windowForwardFunction &A, const observationFunction &H);
+	/**
+	 * Performs one step of the Kalman filtering process with parallel execution of the sigma points.
+	 * @param Zkhatc	Current observations estimations.
+	 * @param A	Forward operator.
+	 * @param H	Observation operator;
+	 * @param seed Sigma point ID for the current MPI process.
+	 * @param local_comm Communicator of all MPI processes that solve the sigma point @p seed.
+	 * @param masters_comm Communicator of the master MPI processes of each sigma point @p seed.
+	 * @return	Current L2 norm of the errors across all observations, or -1 if an operator
+	 * failed in any process or the covariance of the parameters is no longer positive definite
+	 * (the estimate is then unchanged in every process).
+	 */
+	double executeStepParallel(const double *Zkhatc, const forwardFunction &A, const observationFunction &H,
+			int seed, MPI_Comm local_comm, MPI_Comm masters_comm);
+	/**
+	 * Performs one step of the Kalman filtering process distributing the sigma points among any
+	 * quantity of MPI solver groups. Groups take sigma points from a shared queue, the slowest
+	 * sigma points of the previous step first. If threads are set, each group evaluates as many
+	 * sigma points as threads at a time (the operators must then be thread-safe).
+	 * @param Zkhatc	Current observations estimations.
+	 * @param A	Forward operator.
+	 * @param H	Observation operator;
+	 * @param group_comm Communicator of all MPI processes of this solver group (rank 0 is the master).
+	 * @param masters_comm Communicator of the master MPI processes of each group, MPI_COMM_NULL in the workers.
+	 * @return	Current L2 norm of the errors across all observations, or -1 if an operator
+	 * failed in any process or the covariance of the parameters is no longer positive definite
+	 * (the estimate is then unchanged in every process).
+	 */
+	double executeStepScheduled(const double *Zkhatc, const forwardFunction &A, const observationFunction &H,
+			MPI_Comm group_comm, MPI_Comm masters_comm);
+
+	/**
+	 * Sets the strategy that evaluates the sigma points in executeStep. The filter takes
+	 * ownership of the backend.
+	 * @param backend Execution backend, or NULL for serial execution.
+	 */
+	void setExecutionBackend(AbstractExecutionBackend *backend);
+	/**
+	 * Getter of the field @p backend.
+	 * @return Field @p backend.
+	 */
+	AbstractExecutionBackend *getExecutionBackend() const;
+	/**
+	 * Sets the quantity of threads that evaluate the sigma points in executeStep, replacing the
+	 * execution backend by a serial or a ThreadsBackend one. The forward and observation
+	 * operators must be reentrant if @p nThreads > 1. The results do not depend on the quantity
+	 * of threads.
+	 * @param nThreads Quantity of threads (1 for serial execution).
+	 */
+	void setThreads(int nThreads);
+	/**
+	 * Returns the quantity of threads that evaluate the sigma points in executeStep.
+	 * @return Quantity of threads.
+	 */
+	int getThreads() const;
+
+	/**
+	 * Sets the mapping from the problem parameters to the kalman parameters, remapping the
+	 * current estimate into the new space. The filter takes ownership of the mapper.
+	 * @param mapper Parameter mapper, or NULL for the identity.
+	 */
+	void setParameterMapper(CompositeParameterMapper *mapper);
+	/**
+	 * Getter of the field @p statePropagation.
+	 * @return Field @p statePropagation.
+	 */
+	STATE_PROPAGATION getStatePropagation() const;
+
+	/**
+	 * Sets how the sigma points are exchanged among the MPI solvers in executeStepParallel. In
+	 * both modes the master of the sigma point i must have rank i in the masters communicator.
+	 * @param communicationMode Communication mode.
+	 */
+	void setCommunicationMode(SigmaPointsExchange::COMMUNICATION_MODE communicationMode);
+	/**
+	 * Getter of the field @p communicationMode.
+	 * @return Field @p communicationMode.
+	 */
+	SigmaPointsExchange::COMMUNICATION_MODE getCommunicationMode() const;
+	/**
+	 * Returns the time spent evaluating each sigma point at the last scheduled step.
+	 * @return Time in seconds of each sigma point.
+	 */
+	const vector<double> &getSigmaPointTimings() const;
+
+	/**
+	 * Returns the L2 norm of the errors across all observations at each iteration, the oldest
+	 * first. The steps write the history as a ring, which is ordered here.
+	 * @return Error history.
+	 */
+	const vector<double> &getErrorHistory() const;
+	/**
+	 * Sets the maximum quantity of errors kept in the error history, the oldest ones are dropped
+	 * first. The memory of the history is reserved here, so that the steps do not allocate it.
+	 * @param errorHistoryLength Maximum quantity of errors, 0 to keep no history.
+	 */
+	void setErrorHistoryLength(int errorHistoryLength);
+	/**
+	 * Getter of the field @p errorHistoryLength.
+	 * @return Field @p errorHistoryLength.
+	 */
+	int getErrorHistoryLength() const;
+
+	/**
+	 * Enables the per-phase timers and counters of the steps (sampling, forward and observation
+	 * operators, covariance assembly, factorizations, state update and communications). When
+	 * disabled, they cost a branch per phase.
+	 * @param enabled If the phases are recorded.
+	 * @param tracing If each phase is also kept as an event for writeChromeTrace.
+	 */
+	void setProfiling(bool enabled, bool tracing = false);
+	/**
+	 * Sets an emulator that answers the sigma points instead of the forward and observation
+	 * operators when its predicted error is under its threshold. It is trained with the sigma
+	 * points truly evaluated and refitted before each step. It applies to the steps that evaluate
+	 * one sigma point at a time with an observation operator (not the batched, windowed or
+	 * streaming ones), with any execution backend, as the model predicts and learns in the
+	 * process of the filter. The states of an emulated sigma point are not propagated, hence it
+	 * is rejected by the filters with PROPAGATED states. The filter takes ownership of the model
+	 * if it is set.
+	 * @param surrogate Emulator with the dimensions of the filter, NULL to disable it.
+	 * @return If the model was set, false if its dimensions differ from the ones of the filter or
+	 * the filter propagates its states.
+	 */
+	bool setSurrogateModel(SurrogateModel *surrogate);
+	/**
+	 * Returns the emulator of the sigma points, with the quantity of true solves saved.
+	 * @return Emulator, or NULL if disabled.
+	 */
+	SurrogateModel *getSurrogateModel() const;
+
+	/**
+	 * Returns the timers and counters of the steps executed while profiling was enabled.
+	 * @return Profiler of the filter.
+	 */
+	const StepProfiler &getProfiler() const;
+	/**
+	 * Zeroes the timers and counters and drops the recorded events.
+	 */
+	void resetProfiling();
+	/**
+	 * Writes the phases recorded with tracing enabled as a Chrome trace JSON file. In MPI
+	 * executions each process should write its own file.
+	 * @param filename Path of the trace.
+	 * @return If the trace was written.
+	 */
+	bool writeChromeTrace(const string &filename);
+
+	/**
+	 * Sets a file where executeStep checkpoints the filter after each evaluated sigma point and
+	 * after each step. In MPI executions it should be set in a single process.
+	 * @param filename Checkpoint path, or an empty string to disable checkpointing.
+	 */
+	void setCheckpointFile(const string &filename);
+	/**
+	 * Saves the full state of the filter, including the sigma points already evaluated in the
+	 * current step, into a binary checkpoint.
+	 * @param filename Checkpoint path.
+	 * @return If the checkpoint was written.
+	 */
+	bool saveCheckpoint(const string &filename);
+	/**
+	 * Restores the state of the filter from a binary checkpoint. If the checkpoint was taken in
+	 * the middle of a step, the next executeStep only evaluates the missing sigma points. The
+	 * file is read-only mapped, hence many processes can restart from it at once.
+	 * @param filename Checkpoint path.
+	 * @return If the checkpoint was restored.
+	 */
+	bool loadCheckpoint(const string &filename);
+
+	/**
+	 * Sets the covariance model of the observation errors, replacing the diagonal one built from
+	 * the observations uncertainty. The filter takes ownership of the model, which must have
+	 * the same quantity of observations as the filter (otherwise it is discarded).
+	 * @param observationModel Observation error model.
+	 */
+	void setObservationErrorModel(AbstractObservationErrorModel *observationModel);
+	/**
+	 * Getter of the field @p observationModel.
+	 * @return Field @p observationModel.
+	 */
+	const AbstractObservationErrorModel *getObservationErrorModel() const;
+
+	/**
+	 * Moves the states of the sigma points and @p LX to a memory mapped file in @p directory ,
+	 * for problems where they do not fit in memory. The API and the results are unchanged; the
+	 * sampling and the state update stream over the file in tiles of rows. The file is
+	 * temporary and is recreated whenever the dimensions change. Moving them after construction
+	 * copies them from memory, where they were first allocated; to never hold them in memory,
+	 * give the directory to the constructor of the filter instead.
+	 * @param directory Directory for the file, or an empty string to move them back to memory.
+	 * @return If the storage could be set.
+	 */
+	bool setStateStorage(const string &directory);
+	/**
+	 * Getter of the field @p stateStorageDirectory.
+	 * @return Field @p stateStorageDirectory.
+	 */
+	const string &getStateStorage() const;
+
+	/**
+	 * Sets the quantity of observations evaluated at a time by executeStepStreaming. Blocks are
+	 * enlarged to whole groups of correlated observations of the observation error model.
+	 * @param observationBlockSize Observations per block, or 0 to fit the block in cache.
+	 */
+	void setObservationBlockSize(int observationBlockSize);
+	/**
+	 * Getter of the field @p observationBlockSize.
+	 * @return Field @p observationBlockSize.
+	 */
+	int getObservationBlockSize() const;
+
+	/**
+	 * Enables the mixed precision mode, where @p LX is stored in single precision and the states
+	 * and observations of the sigma points are communicated in single precision among the MPI
+	 * solvers, halving the memory and the traffic of the larger terms. The working states and
+	 * observations handed to the operators, the covariance U and the gain stay in double
+	 * precision. All processes round the communicated values alike, so they keep the same
+	 * estimate.
+	 * @param singlePrecision If the mixed precision mode is enabled.
+	 */
+	void setSinglePrecision(bool singlePrecision);
+	/**
+	 * Getter of the field @p singlePrecision.
+	 * @return Field @p singlePrecision.
+	 */
+	bool isSinglePrecision() const;
 
 };
 
@@ -0,0 +1,432 @@
+/*
+ * BatchROUKF.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "BatchROUKF.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+/*
+ * Batched kernels. The p x p matrices and the p x c blocks of the filters [first, last) are
+ * stored as structure of arrays: the element (i, j) of the filter f is at [(j * p + i) * n + f],
+ * where n is the quantity of filters, so the innermost loops run across filters.
+ */
+
+/**
+ * Batched UL Cholesky factorization U = R R^T, with R upper triangular, so that R^{-T} is the
+ * lower Cholesky factor of U^{-1}. Filters whose U is not positive definite are flagged in
+ * @p failed and their factor is meaningless.
+ * @param U Matrices to factorize.
+ * @param R Upper triangular factors.
+ * @param failed Flags of the failed filters.
+ * @param p Order of the matrices.
+ * @param n Quantity of filters of the arrays.
+ * @param first First filter.
+ * @param last Filter after the last one.
+ */
+static void batchCholeskyReversed(const double *U, double *R, char *failed, int p, int n, int first, int last) {
+	for (int j = p - 1; j >= 0; --j) {
+		double *rjj = R + (j * p + j) * n;
+		const double *ujj = U + (j * p + j) * n;
+		for (int f = first; f < last; ++f)
+			rjj[f] = ujj[f];
+		for (int k = j + 1; k < p; ++k) {
+			const double *rjk = R + (k * p + j) * n;
+#pragma omp simd
+			for (int f = first; f < last; ++f)
+				rjj[f] -= rjk[f] * rjk[f];
+		}
+		for (int f = first; f < last; ++f) {
+			if (!(rjj[f] > 0)) {
+				failed[f] = 1;
+				rjj[f] = 1;
+			}
+			rjj[f] = sqrt(rjj[f]);
+		}
+
+		//	Column j of R above the diagonal, the row j left of the diagonal is zero
+		for (int i = 0; i < j; ++i) {
+			double *rij = R + (j * p + i) * n;
+			const double *uij = U + (j * p + i) * n;
+			for (int f = first; f < last; ++f)
+				rij[f] = uij[f];
+			for (int k = j + 1; k < p; ++k) {
+				const double *rik = R + (k * p + i) * n, *rjk = R + (k * p + j) * n;
+#pragma omp simd
+				for (int f = first; f < last; ++f)
+					rij[f] -= rik[f] * rjk[f];
+			}
+#pragma omp simd
+			for (int f = first; f < last; ++f)
+				rij[f] /= rjj[f];
+			double *rji = R + (i * p + j) * n;
+			for (int f = first; f < last; ++f)
+				rji[f] = 0;
+		}
+	}
+}
+
+/**
+ * Batched in place solution of R Y = B, with R upper triangular.
+ * @param R Upper triangular matrices.
+ * @param B Right hand sides with p rows and @p nCols columns, overwritten with the solutions.
+ * @param p Order of the matrices.
+ * @param nCols Quantity of columns of @p B .
+ * @param n Quantity of filters of the arrays.
+ * @param first First filter.
+ * @param last Filter after the last one.
+ */
+static void batchSolveUpper(const double *R, double *B, int p, int nCols, int n, int first, int last) {
+	for (int c = 0; c < nCols; ++c)
+		for (int i = p - 1; i >= 0; --i) {
+			double *bi = B + (c * p + i) * n;
+			const double *rii = R + (i * p + i) * n;
+#pragma omp simd
+			for (int f = first; f < last; ++f)
+				bi[f] /= rii[f];
+			for (int j = 0; j < i; ++j) {
+				double *bj = B + (c * p + j) * n;
+				const double *rji = R + (i * p + j) * n;
+#pragma omp simd
+				for (int f = first; f < last; ++f)
+					bj[f] -= rji[f] * bi[f];
+			}
+		}
+}
+
+/**
+ * Batched in place solution of R^T Y = B, with R upper triangular.
+ * @param R Upper triangular matrices.
+ * @param B Right hand sides with p rows and @p nCols columns, overwritten with the solutions.
+ * @param p Order of the matrices.
+ * @param nCols Quantity of columns of @p B .
+ * @param n Quantity of filters of the arrays.
+ * @param first First filter.
+ * @param last Filter after the last one.
+ */
+static void batchSolveUpperTransposed(const double *R, double *B, int p, int nCols, int n, int first, int last) {
+	for (int c = 0; c < nCols; ++c)
+		for (int i = 0; i < p; ++i) {
+			double *bi = B + (c * p + i) * n;
+			for (int j = 0; j < i; ++j) {
+				const double *bj = B + (c * p + j) * n;
+				const double *rji = R + (i * p + j) * n;
+#pragma omp simd
+				for (int f = first; f < last; ++f)
+					bi[f] -= rji[f] * bj[f];
+			}
+			const double *rii = R + (i * p + i) * n;
+#pragma omp simd
+			for (int f = first; f < last; ++f)
+				bi[f] /= rii[f];
+		}
+}
+
+BatchROUKF::BatchROUKF(int nFilters, int nObservations, int nStates, int nParameters,
+		const double *observationsUncertainty, const double *parametersUncertainty,
+		SigmaPointsGenerator::SIGMA_DISTRIBUTION sigmaDistribution) {
+	this->nFilters = nFilters;
+	this->nObservations = nObservations;
+	this->nStates = nStates;
+	this->nParameters = nParameters;
+
+	shared_ptr<const SigmaPointsGenerator::SigmaPointsSet> set =
+			SigmaPointsGenerator::getSigmaPointsSet(nParameters, sigmaDistribution);
+	sigma = set->sigma;
+	Dsigma = set->Dsigma;
+	Pa = set->Pa;
+	nSigma = sigma.n_cols;
+
+	int p = nParameters;
+	X.zeros(nStates, nFilters);
+	Theta.zeros(p, nFilters);
+	U.zeros(nFilters, p * p);
+	R.zeros(nFilters, p * p);
+	for (int f = 0; f < nFilters; ++f)
+		for (int i = 0; i < p; ++i) {
+			U.at(f, i * p + i) = 1. / parametersUncertainty[f * p + i];
+			R.at(f, i * p + i) = sqrt(U.at(f, i * p + i));
+		}
+	LX.zeros(nStates, p, nFilters);
+	LTheta.zeros(p, p, nFilters);
+	for (int f = 0; f < nFilters; ++f)
+		LTheta.slice(f).eye();
+	invStd.set_size(nObservations, nFilters);
+	for (int f = 0; f < nFilters; ++f)
+		for (int i = 0; i < nObservations; ++i)
+			invStd.at(i, f) = 1. / sqrt(observationsUncertainty[f * nObservations + i]);
+
+	Xk.zeros(nStates, nSigma * nFilters);
+	Thetak.zeros(p, nSigma * nFilters);
+	Zk.zeros(nObservations, nSigma * nFilters);
+	S.set_size(nFilters, p * nSigma);
+	Un.set_size(nFilters, p * p);
+	Rn.set_size(nFilters, p * p);
+	gain.set_size(nFilters, p);
+	error.zeros(nObservations, nFilters);
+
+	failed.assign(nFilters, 0);
+	currError.zeros(nFilters);
+	prevError.zeros(nFilters);
+	currIt = 0;
+	tolerance = 1E-5;
+	maxIterations = 1000;
+
+	mapper = NULL;
+	pool = NULL;
+	setThreads(1);
+}
+
+BatchROUKF::~BatchROUKF() {
+	delete pool;
+	delete mapper;
+}
+
+void BatchROUKF::parallelFor(int n, const function<void(int, int)> &task) {
+	if (pool)
+		pool->parallelFor(n, task);
+	else
+		for (int i = 0; i < n; i++)
+			task(i, 0);
+}
+
+void BatchROUKF::sampleSigmaPoints() {
+	int p = nParameters, n = nFilters;
+	int nChunks = (nFilters + CHUNK - 1) / CHUNK;
+	parallelFor(nChunks, [&](int chunk, int thread) {
+		int first = chunk * CHUNK, last = min(first + CHUNK, nFilters);
+
+		//	S = R^{-T} sigma for the whole chunk
+		for (int c = 0; c < nSigma; ++c)
+			for (int i = 0; i < p; ++i) {
+				double *s = S.colptr(c * p + i);
+				double value = sigma.at(i, c);
+				for (int f = first; f < last; ++f)
+					s[f] = value;
+			}
+		batchSolveUpperTransposed(R.memptr(), S.memptr(), p, nSigma, n, first, last);
+
+		//	Sigma points of each filter around its estimate
+		mat &Sf = samplingScratch[thread];
+		for (int f = first; f < last; ++f) {
+			for (int k = 0; k < p * nSigma; ++k)
+				Sf[k] = S.at(f, k);
+			mat Xkf(Xk.colptr(f * nSigma), nStates, nSigma, false, true);
+			mat Thetakf(Thetak.colptr(f * nSigma), p, nSigma, false, true);
+			Xkf = LX.slice(f) * Sf;
+			Xkf.each_col() += X.col(f);
+			Thetakf = LTheta.slice(f) * Sf;
+			Thetakf.each_col() += Theta.col(f);
+		}
+	});
+}
+
+double BatchROUKF::assimilate(const double *zkhatc) {
+	int p = nParameters, n = nFilters, m = nObservations;
+	const mat zkhat(const_cast<double *>(zkhatc), m, nFilters, false, true);
+	int nChunks = (nFilters + CHUNK - 1) / CHUNK;
+	parallelFor(nChunks, [&](int chunk, int thread) {
+		int first = chunk * CHUNK, last = min(first + CHUNK, nFilters);
+
+		//	Observation terms of the update of each filter
+		mat &HL = observationScratch[thread];
+		for (int f = first; f < last; ++f) {
+			const mat Zkf(Zk.colptr(f * nSigma), m, nSigma, false, true);
+			error.col(f) = zkhat.col(f) - mean(Zkf, 1);
+			HL = Zkf * Dsigma;
+			HL.each_col() %= invStd.col(f);
+			for (int j = 0; j < p; ++j) {
+				for (int i = 0; i < p; ++i)
+					Un.at(f, j * p + i) = dot(HL.col(i), HL.col(j)) + Pa.at(i, j);
+				double g = 0;
+				for (int k = 0; k < m; ++k)
+					g += HL.at(k, j) * error.at(k, f) * invStd.at(k, f);
+				gain.at(f, j) = g;
+			}
+			failed[f] = 0;
+		}
+
+		//	Batched factorization of the new U and solution of the gains
+		batchCholeskyReversed(Un.memptr(), Rn.memptr(), &(failed[0]), p, n, first, last);
+		batchSolveUpper(Rn.memptr(), gain.memptr(), p, 1, n, first, last);
+		batchSolveUpperTransposed(Rn.memptr(), gain.memptr(), p, 1, n, first, last);
+
+		//	New covariance factors, parameters and states of the filters that did not fail
+		for (int f = first; f < last; ++f) {
+			prevError[f] = currError[f];
+			currError[f] = norm(error.col(f), 2);
+			if (failed[f])
+				continue;
+			for (int k = 0; k < p * p; ++k) {
+				U.at(f, k) = Un.at(f, k);
+				R.at(f, k) = Rn.at(f, k);
+			}
+			vec g(p);
+			for (int j = 0; j < p; ++j)
+				g[j] = gain.at(f, j);
+
+			const mat Thetakf(Thetak.colptr(f * nSigma), p, nSigma, false, true);
+			LTheta.slice(f) = Thetakf * Dsigma;
+			Theta.col(f) = mean(Thetakf, 1) + LTheta.slice(f) * g;
+
+			const mat Xkf(Xk.colptr(f * nSigma), nStates, nSigma, false, true);
+			LX.slice(f) = Xkf * Dsigma;
+			X.col(f) = mean(Xkf, 1) + LX.slice(f) * g;
+		}
+	});
+
+	++currIt;
+	double err = 0;
+	for (int f = 0; f < nFilters; ++f) {
+		if (failed[f]) {
+			cerr << "The covariance of the parameters of the filter " << f << " is not positive definite." << endl;
+			err = -1;
+		} else if (err >= 0)
+			err = max(err, currError[f]);
+	}
+	return err;
+}
+
+double BatchROUKF::executeStep(const double *zkhatc, const instanceForwardFunction &A,
+		const instanceObservationFunction &H) {
+	sampleSigmaPoints();
+
+	//	Each sigma point of each filter only touches its own columns
+	parallelFor(nSigma * nFilters, [&](int column, int) {
+		int f = column / nSigma;
+		double *xk = Xk.colptr(column), *thetak = Thetak.colptr(column);
+		if (mapper)
+			mapper->unmapBlock(thetak, nParameters, 1, nParameters);
+		A(f, xk, nStates, thetak, nParameters);
+		if (mapper)
+			mapper->mapBlock(thetak, nParameters, 1, nParameters);
+		H(f, xk, nStates, Zk.colptr(column), nObservations);
+	});
+
+	return assimilate(zkhatc);
+}
+
+double BatchROUKF::executeStep(const double *zkhatc, const batchForwardFunction &A,
+		const batchObservationFunction &H) {
+	sampleSigmaPoints();
+
+	//	Propagate and observe all sigma points of all filters at once in the problem space
+	int nColumns = nSigma * nFilters;
+	if (mapper)
+		mapper->unmapBlock(Thetak.memptr(), nParameters, nColumns, nParameters);
+	A(Xk.memptr(), nStates, Thetak.memptr(), nParameters, nColumns);
+	if (mapper)
+		mapper->mapBlock(Thetak.memptr(), nParameters, nColumns, nParameters);
+	H(Xk.memptr(), nStates, Zk.memptr(), nObservations, nColumns);
+
+	return assimilate(zkhatc);
+}
+
+void BatchROUKF::setThreads(int nThreads) {
+	nThreads = max(nThreads, 1);
+	delete pool;
+	pool = nThreads > 1 ? new ThreadPool(nThreads) : NULL;
+	samplingScratch.assign(nThreads, mat(nParameters, nSigma));
+	observationScratch.assign(nThreads, mat(nObservations, nParameters));
+}
+
+int BatchROUKF::getThreads() const {
+	return pool ? pool->getThreads() : 1;
+}
+
+void BatchROUKF::setParameterMapper(CompositeParameterMapper *mapper) {
+	delete this->mapper;
+	this->mapper = mapper;
+}
+
+void BatchROUKF::setState(int filter, const double *XC) {
+	memcpy(X.colptr(filter), XC, nStates * sizeof(double));
+}
+
+void BatchROUKF::copyState(int filter, double *XC) const {
+	memcpy(XC, X.colptr(filter), nStates * sizeof(double));
+}
+
+void BatchROUKF::setParameters(int filter, const double *ThetaC) {
+	memcpy(Theta.colptr(filter), ThetaC, nParameters * sizeof(double));
+	if (mapper)
+		mapper->mapBlock(Theta.colptr(filter), nParameters, 1, nParameters);
+}
+
+void BatchROUKF::copyParameters(int filter, double *ThetaC) const {
+	memcpy(ThetaC, Theta.colptr(filter), nParameters * sizeof(double));
+	if (mapper)
+		mapper->unmapBlock(ThetaC, nParameters, 1, nParameters);
+}
+
+vector<double> BatchROUKF::getParametersStd(int filter) const {
+	vector<double> std(nParameters);
+	for (int i = 0; i < nParameters; ++i)
+		std[i] = sqrt(1. / U.at(filter, i * nParameters + i));
+	return std;
+}
+
+void BatchROUKF::copyError(int filter, double *err) const {
+	memcpy(err, error.colptr(filter), nObservations * sizeof(double));
+}
+
+double BatchROUKF::getErrorNorm(int filter) const {
+	return currError[filter];
+}
+
+bool BatchROUKF::hasFailed(int filter) const {
+	return failed[filter] != 0;
+}
+
+bool BatchROUKF::hasConverged(int filter, bool isConvergenceRelative) const {
+	if (currIt > 1) {
+		double diff = abs(currError[filter] - prevError[filter]);
+
+		if (isConvergenceRelative)
+			diff /= prevError[filter];
+
+		return diff < tolerance;
+	}
+	return false;
+}
+
+int BatchROUKF::getFilters() const {
+	return nFilters;
+}
+
+int BatchROUKF::getObservations() const {
+	return nObservations;
+}
+
+int BatchROUKF::getStates() const {
+	return nStates;
+}
+
+int BatchROUKF::getParameters() const {
+	return nParameters;
+}
+
+int BatchROUKF::getSigmaPoints() const {
+	return nSigma;
+}
+
+double BatchROUKF::getMaxIterations() const {
+	return maxIterations;
+}
+
+void BatchROUKF::setMaxIterations(double maxIterations) {
+	this->maxIterations = maxIterations;
+}
+
+double BatchROUKF::getTolerance() const {
+	return tolerance;
+}
+
+void BatchROUKF::setTolerance(double tolerance) {
+	this->tolerance = tolerance;
+}
@@ -0,0 +1,315 @@
+/*
+ * BatchROUKF.h
+ *
+ *	Many independent reduced-order unscented Kalman filters of the same shape stepped together.
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef BATCHROUKF_H_
+#define BATCHROUKF_H_
+
+#include <armadillo>
+#include <functional>
+#include <vector>
+
+#include "AbstractROUKF.h"
+#include "mapping/CompositeParameterMapper.h"
+#include "parallel/ThreadPool.h"
+#include "SigmaPointsGenerator.h"
+
+using namespace arma;
+using namespace std;
+
+/**
+ *	Forward operator of one sigma point of a filter of the batch. The first argument is the index
+ *	of the filter, the others are the ones of forwardOp.
+ */
+typedef function<int(int, double *, int, double *, int)> instanceForwardFunction;
+/**
+ *	Observation operator of one sigma point of a filter of the batch. The first argument is the
+ *	index of the filter, the others are the ones of observationOp.
+ */
+typedef function<void(int, double *, int, double *, int)> instanceObservationFunction;
+
+/**
+ * Batch of independent ROUKF filters (e.g. one per patient or device) with the same quantity of
+ * states, parameters and observations and the same sigma points distribution. Each filter gives
+ * the same estimates as a ROUKF with a diagonal observation error model, but the batch is stepped
+ * at once:
+ *	- The sigma points of all filters are contiguous blocks, filter after filter, so that one
+ *	call to a batched operator evaluates the whole batch.
+ *	- The p x p factors (U, R) and the gains of all filters are stored as structure of
+ *	arrays, element after element with the filters contiguous, and the Cholesky factorization and
+ *	the triangular solves run as batched kernels that vectorize across filters.
+ *	- The per-filter products with the states and observations blocks are distributed among the
+ *	threads of a shared pool by chunks of filters.
+ *
+ *	@code
+ *	BatchROUKF batch(nFilters, nObservations, nStates, nParameters, observationsUncertainty,
+ *			parametersUncertainty, SigmaPointsGenerator::SIMPLEX);
+ *	batch.setThreads(8);
+ *	for (int it = 0; it < nSteps; it++)
+ *		batch.executeStep(observations, &forwardPatient, &observePatient);
+ *	@endcode
+ *
+ * The per-filter observations, states and parameters given to the batch are column-major blocks
+ * with one column per filter.
+ */
+class BatchROUKF {
+protected:
+	/**	Quantity of filters. */
+	int nFilters;
+	/**	Quantity of observations of each filter. */
+	int nObservations;
+	/**	Quantity of states of each filter. */
+	int nStates;
+	/**	Quantity of parameters of each filter. */
+	int nParameters;
+	/**	Quantity of sigma points of each filter. */
+	int nSigma;
+
+	/**	States of each filter as columns (nStates x nFilters). */
+	mat X;
+	/**	Parameters of each filter in the kalman space as columns (nParameters x nFilters). */
+	mat Theta;
+	/**	U part of the covariance of each filter, structure of arrays (nFilters x p*p). */
+	mat U;
+	/**	Upper triangular UL factor of each @p U (U = R R^T), structure of arrays (nFilters x p*p). */
+	mat R;
+	/**	L part of the covariance concerning to the states, one slice per filter. */
+	cube LX;
+	/**	L part of the covariance concerning to the parameters, one slice per filter. */
+	cube LTheta;
+	/**	Inverse of the standard deviation of each observation, one column per filter. */
+	mat invStd;
+
+	/**	Matrix with sigma points as columns. */
+	mat sigma;
+	/** Matrix with sigma points weighted as rows. */
+	mat Dsigma;
+	/** Matrix @p sigma times @p Dsigma . */
+	mat Pa;
+
+	/**	States of the sigma points, nSigma columns per filter. */
+	mat Xk;
+	/**	Parameters of the sigma points, nSigma columns per filter. */
+	mat Thetak;
+	/**	Observations of the sigma points, nSigma columns per filter. */
+	mat Zk;
+	/**	Sampling of the sigma points, structure of arrays (nFilters x p*nSigma). */
+	mat S;
+	/**	New U of each filter, structure of arrays (nFilters x p*p). */
+	mat Un;
+	/**	New Cholesky factor of each filter, structure of arrays (nFilters x p*p). */
+	mat Rn;
+	/**	Kalman gain of each filter, structure of arrays (nFilters x p). */
+	mat gain;
+	/**	Observations errors of each filter after the last step, one column per filter. */
+	mat error;
+	/**	Sampling of the sigma points of one filter, for each thread (nParameters x nSigma). */
+	vector<mat> samplingScratch;
+	/**	Whitened observations covariance factor of one filter, for each thread (nObservations x nParameters). */
+	vector<mat> observationScratch;
+
+	/**	If the update of each filter failed at the last step. */
+	vector<char> failed;
+	/**	Current error norm of each filter. */
+	vec currError;
+	/**	Previous error norm of each filter. */
+	vec prevError;
+	/** Current iteration. */
+	long long int currIt;
+	/**	Tolerance to assess the convergence of the filters. */
+	double tolerance;
+	/**	Maximum quantity of iterations. */
+	double maxIterations;
+
+	/**	Mapping between the problem and the kalman parameters, shared by all filters (NULL = identity). */
+	CompositeParameterMapper *mapper;
+	/**	Pool of threads shared by all filters, NULL for serial execution. */
+	ThreadPool *pool;
+
+	/**
+	 * Executes @p task(i, thread) for each i in [0, n) with the pool of threads.
+	 * @param n Quantity of tasks.
+	 * @param task Function executed for each task.
+	 */
+	void parallelFor(int n, const function<void(int, int)> &task);
+	/**
+	 * Samples the sigma points of all filters into @p Xk and @p Thetak , in the kalman space.
+	 */
+	void sampleSigmaPoints();
+	/**
+	 * Updates all filters with the evaluated sigma points.
+	 * @param zkhatc Observations of each filter as columns (nObservations x nFilters).
+	 * @return Largest error norm among the filters, or -1 if the update of any filter failed.
+	 */
+	double assimilate(const double *zkhatc);
+
+public:
+	/**	Quantity of filters processed together by each thread in the batched kernels. */
+	static const int CHUNK = 64;
+
+	/**
+	 *	Creates the covariance matrixes of all filters and their sigma points.
+	 * @param nFilters Quantity of filters.
+	 * @param nObservations Quantity of observations of each filter.
+	 * @param nStates Quantity of states of each filter.
+	 * @param nParameters Quantity of parameters of each filter.
+	 * @param observationsUncertainty Variance of each observation, one column per filter (nObservations x nFilters).
+	 * @param parametersUncertainty Uncertainty of each parameter, one column per filter (nParameters x nFilters).
+	 * @param sigmaDistribution	Type of sigmas applied to assess the unscented transform.
+	 */
+	BatchROUKF(int nFilters, int nObservations, int nStates, int nParameters,
+			const double *observationsUncertainty, const double *parametersUncertainty,
+			SigmaPointsGenerator::SIGMA_DISTRIBUTION sigmaDistribution);
+	/**
+	 * Releases the pool of threads and the mapper.
+	 */
+	~BatchROUKF();
+
+	/**
+	 * Performs one step of all filters calling the operators for each sigma point of each filter.
+	 * The sigma points are evaluated concurrently by the threads of the batch, hence the
+	 * operators must then be thread-safe.
+	 * @param Zkhatc Observations of each filter as columns (nObservations x nFilters).
+	 * @param A	Forward operator.
+	 * @param H	Observation operator.
+	 * @return Largest L2 norm of the errors among the filters, or -1 if the covariance of any
+	 * filter is no longer positive definite (that filter is then left unchanged, see hasFailed).
+	 */
+	double executeStep(const double *Zkhatc, const instanceForwardFunction &A, const instanceObservationFunction &H);
+	/**
+	 * Performs one step of all filters with a single call to the batched operators. The blocks
+	 * have nSigma * nFilters columns, the columns [f * nSigma, (f + 1) * nSigma) belong to the
+	 * filter f. The operators receive the problem parameters.
+	 * @param Zkhatc Observations of each filter as columns (nObservations x nFilters).
+	 * @param A	Batched forward operator.
+	 * @param H	Batched observation operator.
+	 * @return Largest L2 norm of the errors among the filters, or -1 if the covariance of any
+	 * filter is no longer positive definite (that filter is then left unchanged, see hasFailed).
+	 */
+	double executeStep(const double *Zkhatc, const batchForwardFunction &A, const batchObservationFunction &H);
+
+	/**
+	 * Sets the quantity of threads that step the batch.
+	 * @param nThreads Quantity of threads, 1 for serial execution.
+	 */
+	void setThreads(int nThreads);
+	/**
+	 * Returns the quantity of threads that step the batch.
+	 * @return Quantity of threads.
+	 */
+	int getThreads() const;
+	/**
+	 * Sets the mapping between the problem and the kalman parameters of all filters. The batch
+	 * takes ownership of the mapper. Parameters already set are kept in the kalman space.
+	 * @param mapper Mapper, or NULL for the identity.
+	 */
+	void setParameterMapper(CompositeParameterMapper *mapper);
+
+	/**
+	 * Sets the states of a filter.
+	 * @param filter Index of the filter.
+	 * @param XC Array of states.
+	 */
+	void setState(int filter, const double *XC);
+	/**
+	 * Copies the states of a filter.
+	 * @param filter Index of the filter.
+	 * @param XC Array with room for the states.
+	 */
+	void copyState(int filter, double *XC) const;
+	/**
+	 * Sets the parameters of a filter, given in the problem space.
+	 * @param filter Index of the filter.
+	 * @param ThetaC Array of parameters.
+	 */
+	void setParameters(int filter, const double *ThetaC);
+	/**
+	 * Copies the parameters of a filter in the problem space.
+	 * @param filter Index of the filter.
+	 * @param ThetaC Array with room for the parameters.
+	 */
+	void copyParameters(int filter, double *ThetaC) const;
+	/**
+	 * Returns the standard deviation of each parameter of a filter in the kalman space.
+	 * @param filter Index of the filter.
+	 * @return Standard deviations.
+	 */
+	vector<double> getParametersStd(int filter) const;
+	/**
+	 * Copies the observations errors of a filter after the last step.
+	 * @param filter Index of the filter.
+	 * @param err Array with room for the observations.
+	 */
+	void copyError(int filter, double *err) const;
+	/**
+	 * Returns the L2 norm of the observations errors of a filter after the last step.
+	 * @param filter Index of the filter.
+	 * @return Error norm.
+	 */
+	double getErrorNorm(int filter) const;
+	/**
+	 * Returns if the update of a filter failed at the last step.
+	 * @param filter Index of the filter.
+	 * @return If the covariance of the filter was no longer positive definite.
+	 */
+	bool hasFailed(int filter) const;
+	/**
+	 * Checks if a filter has converged.
+	 * @param filter Index of the filter.
+	 * @param isConvergenceRelative If the tolerance is relative to the error.
+	 * @return If the change of the error of the filter is under the tolerance.
+	 */
+	bool hasConverged(int filter, bool isConvergenceRelative) const;
+
+	/**
+	 * Getter of the field @p nFilters.
+	 * @return Field @p nFilters.
+	 */
+	int getFilters() const;
+	/**
+	 * Getter of the field @p nObservations.
+	 * @return Field @p nObservations.
+	 */
+	int getObservations() const;
+	/**
+	 * Getter of the field @p nStates.
+	 * @return Field @p nStates.
+	 */
+	int getStates() const;
+	/**
+	 * Getter of the field @p nParameters.
+	 * @return Field @p nParameters.
+	 */
+	int getParameters() const;
+	/**
+	 * Getter of the field @p nSigma.
+	 * @return Field @p nSigma.
+	 */
+	int getSigmaPoints() const;
+	/**
+	 * Getter of the field @p maxIterations.
+	 * @return Field @p maxIterations.
+	 */
+	double getMaxIterations() const;
+	/**
+	 * Setter of the field @p maxIterations.
+	 * @param maxIterations Maximum quantity of iterations.
+	 */
+	void setMaxIterations(double maxIterations);
+	/**
+	 * Getter of the field @p tolerance.
+	 * @return Field @p tolerance.
+	 */
+	double getTolerance() const;
+	/**
+	 * Setter of the field @p tolerance.
+	 * @param tolerance Maximum tolerance allowed.
+	 */
+	void setTolerance(double tolerance);
+};
+
+#endif /* BATCHROUKF_H_ */
@@ -0,0 +1,282 @@
+/*
+ * FixedROUKF.h
+ *
+ *	Reduce-order Unscent Kalman Filter with dimensions fixed at compile time.
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef FIXEDROUKF_H_
+#define FIXEDROUKF_H_
+
+#include <armadillo>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#include "AbstractROUKF.h"
+#include "SigmaPointsGenerator.h"
+#include "StepWorkspace.h"
+
+using namespace arma;
+using namespace std;
+
+/**
+ * Reduced order unscented Kalman filter for small problems (a few parameters and some dozens of
+ * observations) executed at high rates. All matrices are fixed-size armadillo matrices stored
+ * inside the instance, hence executeStep performs no allocation (checked by the allocation
+ * test). The operations are the same as in ROUKF::executeStep with a diagonal observation error
+ * model, so both filters give the same results. Since the matrices live inside the instance,
+ * large dimensions should be avoided (or the instance allocated in the heap).
+ *
+ *	@code
+ *	FixedROUKF<40, 3, 24, SigmaPointsGenerator::SIMPLEX> filter(observationsUncertainty, parametersUncertainty);
+ *	for (int it = 0; it < 3000; it++)
+ *		error = filter.executeStep(observation, ptA, ptH);
+ *	@endcode
+ *
+ * @tparam NStates Quantity of states.
+ * @tparam NParams Quantity of parameters.
+ * @tparam NObs Quantity of observations.
+ * @tparam Distribution Type of sigmas applied to assess the unscented transform.
+ */
+template<int NStates, int NParams, int NObs, SigmaPointsGenerator::SIGMA_DISTRIBUTION Distribution>
+class FixedROUKF {
+	static_assert(NStates > 0 && NParams > 0 && NObs > 0, "FixedROUKF needs states, parameters and observations.");
+
+public:
+	/**	Quantity of sigma points of @p Distribution . */
+	static const int NSigma = Distribution == SigmaPointsGenerator::CANONIC ? 2 * NParams
+			: Distribution == SigmaPointsGenerator::SIMPLEX ? NParams + 1
+			: Distribution == SigmaPointsGenerator::STAR ? 2 * NParams + 1
+			: NParams + 2;
+
+protected:
+	/**	States vector.	*/
+	arma::mat::fixed<NStates, 1> X;
+	/**	Parameters vector.	*/
+	arma::mat::fixed<NParams, 1> Theta;
+	/**	U part of the covariance matrix	after LU factorization.	*/
+	arma::mat::fixed<NParams, NParams> U;
+	/**	Upper triangular UL factor of @p U (U = R R^T).	*/
+	arma::mat::fixed<NParams, NParams> R;
+	/**	L part of the covariance matrix concerning to the state part of the extended state vector.	*/
+	arma::mat::fixed<NStates, NParams> LX;
+	/**	L part of the covariance matrix concerning to the parameter part of the extended state vector.	*/
+	arma::mat::fixed<NParams, NParams> LTheta;
+	/**	Inverse of the standard deviation of each observation.	*/
+	arma::mat::fixed<NObs, 1> invStd;
+
+	/**	Matrix with sigma points as columns. */
+	arma::mat::fixed<NParams, NSigma> sigma;
+	/** Matrix with sigma points weighted as rows. */
+	arma::mat::fixed<NSigma, NParams> Dsigma;
+	/** Matrix @p sigma times @p Dsigma . */
+	arma::mat::fixed<NParams, NParams> Pa;
+
+	/**	States of each sigma point as columns. */
+	arma::mat::fixed<NStates, NSigma> Xk;
+	/**	Parameters of each sigma point as columns. */
+	arma::mat::fixed<NParams, NSigma> Thetak;
+	/**	Observations of each sigma point as columns. */
+	arma::mat::fixed<NObs, NSigma> Zk;
+	/**	Sigma points scaled by the square root of the covariance. */
+	arma::mat::fixed<NParams, NSigma> S;
+	/**	Whitened observations covariance factor. */
+	arma::mat::fixed<NObs, NParams> HL;
+	/**	Mean of the states of the sigma points. */
+	arma::mat::fixed<NStates, 1> xkMean;
+	/**	Mean of the parameters of the sigma points. */
+	arma::mat::fixed<NParams, 1> thetakMean;
+	/**	Mean of the observations of the sigma points. */
+	arma::mat::fixed<NObs, 1> zkMean;
+	/**	Whitened observations errors. */
+	arma::mat::fixed<NObs, 1> whitenedError;
+	/**	Kalman gain applied to the errors. */
+	arma::mat::fixed<NParams, 1> gain;
+
+	/**	Vector with the observations errors after the last iteration. */
+	arma::mat::fixed<NObs, 1> error;
+
+	/**	Previous iteration error. */
+	double prevError;
+	/**	Current iteration error. */
+	double currError;
+	/** Current iteration. */
+	long long int currIt;
+
+public:
+	/**
+	 *	Creates the covariance matrixes and sigma points. This is the only place where memory is
+	 * allocated (by the sigma points generator).
+	 * @param observationsUncertainty Vector with the variance of each observation.
+	 * @param parametersUncertainty Vector with the uncertainty of each parameter in Theta.
+	 */
+	FixedROUKF(const double *observationsUncertainty, const double *parametersUncertainty) {
+		X.zeros();
+		Theta.zeros();
+		LTheta.eye();
+		LX.zeros();
+		U.eye();
+		for (int i = 0; i < NParams; ++i)
+			U.at(i, i) = 1. / parametersUncertainty[i];
+		StepWorkspace::cholReversed(R, U);
+		for (int i = 0; i < NObs; ++i)
+			invStd[i] = 1. / sqrt(observationsUncertainty[i]);
+
+		shared_ptr<const SigmaPointsGenerator::SigmaPointsSet> set =
+				SigmaPointsGenerator::getSigmaPointsSet(NParams, Distribution);
+		sigma = set->sigma;
+		Dsigma = set->Dsigma;
+		Pa = set->Pa;
+
+		error.zeros();
+		prevError = 0;
+		currError = 0;
+		currIt = 0;
+	}
+
+	/**
+	 * Performs one step of the Kalman filtering process in serial execution of the sigma points.
+	 * The operators are taken by value as any callable (functions, functors or lambdas with
+	 * captures), so that calls to inlineable functors are resolved at compile time.
+	 * @param zkhatc	Current observations estimations.
+	 * @param A	Forward operator, callable as forwardOp.
+	 * @param H	Observation operator, callable as observationOp.
+	 * @return	Current L2 norm of the errors across all observations, or -1 if the covariance
+	 * is no longer positive definite (the estimate is then left unchanged).
+	 */
+	template<typename Forward, typename Observation>
+	double executeStep(double *zkhatc, Forward A, Observation H) {
+		//	Sampling
+		S = sigma;
+		StepWorkspace::solveUpperTransposed(R, S.memptr(), NSigma);
+		Xk = LX * S;
+		Xk.each_col() += X;
+		Thetak = LTheta * S;
+		Thetak.each_col() += Theta;
+
+		//	Propagate and observe each sigma point
+		for (int i = 0; i < NSigma; ++i) {
+			A(Xk.colptr(i), NStates, Thetak.colptr(i), NParams);
+			H(Xk.colptr(i), NStates, Zk.colptr(i), NObs);
+		}
+
+		//	Associated observation
+		const mat zkhat(zkhatc, NObs, 1, false, true);
+		zkMean = mean(Zk, 1);
+		error = zkhat - zkMean;
+
+		//	Observation terms of the update
+		HL = Zk * Dsigma;
+		HL.each_col() %= invStd;
+		arma::mat::fixed<NParams, NParams> Un = HL.t() * HL;
+		whitenedError = error % invStd;
+		gain = HL.t() * whitenedError;
+
+		Un += Pa;
+		arma::mat::fixed<NParams, NParams> Rn;
+		if (!StepWorkspace::cholReversed(Rn, Un)) {
+			cerr << "The covariance of the parameters is not positive definite." << endl;
+			return -1;
+		}
+		U = Un;
+		R = Rn;
+
+		//	New parameters
+		thetakMean = mean(Thetak, 1);
+		LTheta = Thetak * Dsigma;
+		StepWorkspace::solveUpper(R, gain.memptr(), 1);
+		StepWorkspace::solveUpperTransposed(R, gain.memptr(), 1);
+		Theta = thetakMean;
+		Theta += LTheta * gain;
+
+		//	New state
+		xkMean = mean(Xk, 1);
+		LX = Xk * Dsigma;
+		X = xkMean;
+		X += LX * gain;
+
+		prevError = currError;
+		currError = norm(error, 2);
+		++currIt;
+		return currError;
+	}
+
+	/**
+	 * Prints the attributes of the filter.
+	 */
+	void toString() {
+		X.print("X:");
+		Theta.print("Theta:");
+		U.print("U:");
+		R.print("R:");
+		LX.print("LX:");
+		LTheta.print("LTheta:");
+		sigma.print("sigma:");
+		Dsigma.print("Dsigma:");
+		Pa.print("Pa:");
+	}
+
+	/**
+	 * Setter of the field @p X.
+	 * @param XC Array of states.
+	 */
+	void setState(const double *XC) {
+		memcpy(X.memptr(), XC, NStates * sizeof(double));
+	}
+	/**
+	 * Copies the field @p X into a caller-provided array.
+	 * @param XC Array with room for NStates elements.
+	 */
+	void copyState(double *XC) const {
+		memcpy(XC, X.memptr(), NStates * sizeof(double));
+	}
+	/**
+	 * Setter of the field @p Theta.
+	 * @param ThetaC Array of parameters.
+	 */
+	void setParameters(const double *ThetaC) {
+		memcpy(Theta.memptr(), ThetaC, NParams * sizeof(double));
+	}
+	/**
+	 * Copies the field @p Theta into a caller-provided array.
+	 * @param ThetaC Array with room for NParams elements.
+	 */
+	void copyParameters(double *ThetaC) const {
+		memcpy(ThetaC, Theta.memptr(), NParams * sizeof(double));
+	}
+	/**
+	 * Copies the standard deviation of each parameter at the current iteration into a
+	 * caller-provided array.
+	 * @param std Array with room for NParams elements.
+	 */
+	void copyParametersStd(double *std) const {
+		for (int i = 0; i < NParams; ++i)
+			std[i] = sqrt(1. / U.at(i, i));
+	}
+	/**
+	 * Copies the error associated to each observation at the current iteration into a
+	 * caller-provided array.
+	 * @param err Array with room for NObs elements.
+	 */
+	void copyError(double *err) const {
+		memcpy(err, error.memptr(), NObs * sizeof(double));
+	}
+	/**
+	 * Returns the L2 norm of the errors across all observations at the current iteration.
+	 * @return Current error.
+	 */
+	double getCurrentError() const {
+		return currError;
+	}
+	/**
+	 * Returns the quantity of executed steps.
+	 * @return Current iteration.
+	 */
+	long long int getIteration() const {
+		return currIt;
+	}
+};
+
+#endif /* FIXEDROUKF_H_ */
@@ -0,0 +1,129 @@
+/*
+ * ForwardCache.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "ForwardCache.h"
+
+#include <cmath>
+#include <cstring>
+
+ForwardCache::ForwardCache(size_t budget, double tolerance) {
+	this->budget = budget;
+	this->tolerance = tolerance > 0 ? tolerance : 0;
+	bytes = 0;
+	hits = 0;
+	misses = 0;
+	evictions = 0;
+}
+
+string ForwardCache::makeKey(const double *theta, int nParameters) const {
+	string key(nParameters * sizeof(double), '\0');
+	if (tolerance == 0) {
+		memcpy(&key[0], theta, nParameters * sizeof(double));
+		return key;
+	}
+	for (int i = 0; i < nParameters; ++i) {
+		//	Cell index stored as a double, it is exact up to 2^53 cells.
+		double cell = floor(theta[i] / tolerance);
+		memcpy(&key[i * sizeof(double)], &cell, sizeof(double));
+	}
+	return key;
+}
+
+bool ForwardCache::lookup(const double *theta, int nParameters, double *z, int nObservations) {
+	string key = makeKey(theta, nParameters);
+	lock_guard<mutex> lock(cacheMutex);
+	unordered_map<string, list<Entry>::iterator>::iterator found = index.find(key);
+	if (found == index.end() || (int) found->second->observations.size() != nObservations) {
+		++misses;
+		return false;
+	}
+	entries.splice(entries.begin(), entries, found->second);
+	memcpy(z, found->second->observations.data(), nObservations * sizeof(double));
+	++hits;
+	return true;
+}
+
+void ForwardCache::insert(const double *theta, int nParameters, const double *z, int nObservations) {
+	size_t entryBytes = nParameters * sizeof(double) + nObservations * sizeof(double);
+	if (entryBytes > budget)
+		return;
+
+	string key = makeKey(theta, nParameters);
+	lock_guard<mutex> lock(cacheMutex);
+	//	Another thread may have evaluated the same parameters meanwhile, the first one is kept.
+	if (index.find(key) != index.end())
+		return;
+
+	while (bytes + entryBytes > budget) {
+		Entry &last = entries.back();
+		bytes -= last.key.size() + last.observations.size() * sizeof(double);
+		index.erase(last.key);
+		entries.pop_back();
+		++evictions;
+	}
+
+	Entry entry;
+	entry.key = key;
+	entry.observations.assign(z, z + nObservations);
+	entries.push_front(entry);
+	index[key] = entries.begin();
+	bytes += entryBytes;
+}
+
+void ForwardCache::findShared(const double *Theta, int nParameters, int nColumns, char *shared) const {
+	vector<string> keys(nColumns);
+	for (int j = 0; j < nColumns; ++j) {
+		keys[j] = makeKey(Theta + (size_t) j * nParameters, nParameters);
+		shared[j] = 0;
+	}
+	for (int j = 0; j < nColumns; ++j)
+		for (int k = j + 1; k < nColumns; ++k)
+			if (keys[j] == keys[k])
+				shared[j] = shared[k] = 1;
+}
+
+void ForwardCache::clear() {
+	lock_guard<mutex> lock(cacheMutex);
+	entries.clear();
+	index.clear();
+	bytes = 0;
+	hits = 0;
+	misses = 0;
+	evictions = 0;
+}
+
+long long ForwardCache::getHits() const {
+	lock_guard<mutex> lock(cacheMutex);
+	return hits;
+}
+
+long long ForwardCache::getMisses() const {
+	lock_guard<mutex> lock(cacheMutex);
+	return misses;
+}
+
+long long ForwardCache::getEvictions() const {
+	lock_guard<mutex> lock(cacheMutex);
+	return evictions;
+}
+
+size_t ForwardCache::getEntries() const {
+	lock_guard<mutex> lock(cacheMutex);
+	return entries.size();
+}
+
+size_t ForwardCache::getBytes() const {
+	lock_guard<mutex> lock(cacheMutex);
+	return bytes;
+}
+
+size_t ForwardCache::getBudget() const {
+	return budget;
+}
+
+double ForwardCache::getTolerance() const {
+	return tolerance;
+}
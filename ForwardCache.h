@@ -0,0 +1,145 @@
+/*
+ * ForwardCache.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef FORWARDCACHE_H_
+#define FORWARDCACHE_H_
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Least recently used memory of the observations of the forward model keyed on the problem
+ * parameters. It is only valid for operators whose observations depend on the parameters alone,
+ * as the ones of StaticROUKF. The parameters are matched exactly or, with a quantization
+ * tolerance, by the cell of side @p tolerance that contains them (two parameters closer than
+ * the tolerance may still fall in neighbouring cells and miss). The observations returned for
+ * a quantized match are the ones of the first sample of the cell. Sigma points of the same step
+ * that fall in the same cell must not be answered by the cache (see findShared), otherwise their
+ * observations would be identical and the step would not update the parameters. The memory held
+ * by the observations and keys is bounded by a budget, the least recently used entries are
+ * evicted first. All methods may be called from the threads that evaluate the sigma points at
+ * once.
+ */
+class ForwardCache {
+	/**	Stored evaluation. */
+	struct Entry {
+		/**	Key of the parameters. */
+		string key;
+		/**	Observations of the forward model. */
+		vector<double> observations;
+	};
+
+	/**	Maximum bytes held by the keys and observations. */
+	size_t budget;
+	/**	Side of the quantization cells of the parameters, 0 for exact matches. */
+	double tolerance;
+	/**	Bytes currently held by the keys and observations. */
+	size_t bytes;
+	/**	Entries from the most to the least recently used. */
+	list<Entry> entries;
+	/**	Entry of each key. */
+	unordered_map<string, list<Entry>::iterator> index;
+	/**	Lookups that found the parameters. */
+	long long hits;
+	/**	Lookups that did not find the parameters. */
+	long long misses;
+	/**	Entries evicted to keep the budget. */
+	long long evictions;
+	/**	Serializes the accesses. */
+	mutable mutex cacheMutex;
+
+	/**
+	 * Builds the key of a parameters vector: the bytes of the values for exact matches or the
+	 * indexes of the quantization cell otherwise.
+	 * @param theta Problem parameters.
+	 * @param nParameters Quantity of parameters.
+	 * @return Key.
+	 */
+	string makeKey(const double *theta, int nParameters) const;
+
+public:
+	/**
+	 * Creates an empty cache.
+	 * @param budget Maximum bytes held by the keys and observations.
+	 * @param tolerance Side of the quantization cells of the parameters, 0 for exact matches.
+	 */
+	ForwardCache(size_t budget, double tolerance = 0);
+
+	/**
+	 * Looks up the observations of a parameters vector and marks them as the most recently used.
+	 * @param theta Problem parameters.
+	 * @param nParameters Quantity of parameters.
+	 * @param z Array with room for the observations, written on a hit.
+	 * @param nObservations Quantity of observations.
+	 * @return If the observations were found.
+	 */
+	bool lookup(const double *theta, int nParameters, double *z, int nObservations);
+	/**
+	 * Stores the observations of a parameters vector, evicting the least recently used entries
+	 * to keep the budget. Observations larger than the whole budget are not stored.
+	 * @param theta Problem parameters.
+	 * @param nParameters Quantity of parameters.
+	 * @param z Observations.
+	 * @param nObservations Quantity of observations.
+	 */
+	void insert(const double *theta, int nParameters, const double *z, int nObservations);
+	/**
+	 * Flags the columns of a block of parameters vectors whose key is the same as the one of
+	 * another column of the block, i.e. the sigma points of a step that would share an entry.
+	 * @param Theta Problem parameters, one column per sigma point.
+	 * @param nParameters Quantity of parameters.
+	 * @param nColumns Quantity of columns.
+	 * @param shared Returns 1 for the columns that share their key and 0 for the others.
+	 */
+	void findShared(const double *Theta, int nParameters, int nColumns, char *shared) const;
+	/**
+	 * Removes all entries and resets the statistics.
+	 */
+	void clear();
+
+	/**
+	 * Getter of the field @p hits.
+	 * @return Field @p hits.
+	 */
+	long long getHits() const;
+	/**
+	 * Getter of the field @p misses.
+	 * @return Field @p misses.
+	 */
+	long long getMisses() const;
+	/**
+	 * Getter of the field @p evictions.
+	 * @return Field @p evictions.
+	 */
+	long long getEvictions() const;
+	/**
+	 * Returns the quantity of stored evaluations.
+	 * @return Quantity of entries.
+	 */
+	size_t getEntries() const;
+	/**
+	 * Getter of the field @p bytes.
+	 * @return Field @p bytes.
+	 */
+	size_t getBytes() const;
+	/**
+	 * Getter of the field @p budget.
+	 * @return Field @p budget.
+	 */
+	size_t getBudget() const;
+	/**
+	 * Getter of the field @p tolerance.
+	 * @return Field @p tolerance.
+	 */
+	double getTolerance() const;
+};
+
+#endif /* FORWARDCACHE_H_ */
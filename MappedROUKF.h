@@ -42,9 +42,9 @@
  *	//	Set initial condition
  *	kalmanInstance->setState(initialGuess, nParameters);
  *
- *	for (int it = 0; it < 3000; it++) {
- *		error = kalmanInstance->executeStep(observation, nStates, ptA, ptH);
- *	}
+ *	//	Step until convergence, stagnation or divergence, at most MaxIterations steps
+ *	kalmanInstance->setMaxIterations(3000);
+ *	AbstractROUKF::RUN_STATUS status = kalmanInstance->run(&(observation[0]), ptA, ptH);
  *
  *	//	Get the Kalman estimation
  *	kalmanInstance->getState(&sol);			// -> XSol
@@ -56,8 +56,6 @@
  */
 class MappedROUKF : public AbstractROUKF {
 
-	/** Mapping function between the problem parameters and the kalman parameters. */
-	CompositeParameterMapper *mapper;
 public:
 
 	/**	Reparametrization type. */
@@ -74,10 +72,13 @@ public:
 	 * @param observationsUncertainty Vector with the uncertainty of each state in X.
 	 * @param parametersUncertainty Vector with the uncertainty of each parameter in Theta.
 	 * @param sigmaDistribution	Type of sigmas applied to assess the unscented transform.
+	 * @param stateStorage Directory of the file storing the states of the sigma points and
+	 * @p LX , created there directly so that they are never held in memory. See
+	 * setStateStorage. Empty to keep them in memory.
 	 */
 	MappedROUKF(int nObservations, int nStates, int nParameters,
 			vector<double> observationsUncertainty, vector<double> parametersUncertainty,
-			SigmaPointsGenerator::SIGMA_DISTRIBUTION sigmaDistribution);
+			SigmaPointsGenerator::SIGMA_DISTRIBUTION sigmaDistribution, const string &stateStorage = string());
 
 	/**
 	 *	Creates the covariance matrixes and sigma points associated with the extended
@@ -90,10 +91,14 @@ public:
 	 * @param sigmaDistribution	Type of sigmas applied to assess the unscented transform.
 	 * @param mappingType Type of mapping between the problem and the kalman parameters.
 	 * @param mappingParameters Parameters for the chosen mapping type.
+	 * @param stateStorage Directory of the file storing the states of the sigma points and
+	 * @p LX , created there directly so that they are never held in memory. See
+	 * setStateStorage. Empty to keep them in memory.
 	 */
 	MappedROUKF(int nObservations, int nStates, int nParameters,
 			vector<double> observationsUncertainty, vector<double> parametersUncertainty,
-			SigmaPointsGenerator::SIGMA_DISTRIBUTION sigmaDistribution, MappedROUKF::MAPPING_TYPE mappingType, vector<double > mappingParameters);
+			SigmaPointsGenerator::SIGMA_DISTRIBUTION sigmaDistribution, MappedROUKF::MAPPING_TYPE mappingType, vector<double > mappingParameters,
+			const string &stateStorage = string());
 
 	/**
 	 *	Creates the covariance matrixes and sigma points associated with the extended
@@ -106,24 +111,55 @@ public:
 	 * @param parametersUncertainty Vector with the uncertainty of each parameter in Theta.
 	 * @param sigmaDistribution	Type of sigmas applied to assess the unscented transform.
 	 * @param mapper User customized mapping function between the problem and the kalman parameters.
+	 * @param stateStorage Directory of the file storing the states of the sigma points and
+	 * @p LX , created there directly so that they are never held in memory. See
+	 * setStateStorage. Empty to keep them in memory.
 	 */
 	MappedROUKF(int nObservations, int nStates, int nParameters,
 			vector<double> observationsUncertainty, vector<double> parametersUncertainty,
-			SigmaPointsGenerator::SIGMA_DISTRIBUTION sigmaDistribution, CompositeParameterMapper *mapper);
+			SigmaPointsGenerator::SIGMA_DISTRIBUTION sigmaDistribution, CompositeParameterMapper *mapper,
+			const string &stateStorage = string());
 
 	/**
 	 * Void destructor.
 	 */
 	~MappedROUKF();
 
+	using AbstractROUKF::executeStep;
+	using AbstractROUKF::executeStepStreaming;
+	using AbstractROUKF::executeStepParallel;
+	using AbstractROUKF::executeStepScheduled;
+
 	/**
 	 * Performs one step of the Kalman filtering process in serial execution of the sigma points.
 	 * @param Zkhatc	Current observations estimations.
 	 * @param A	Forward operator.
 	 * @param H	Observation operator;
-	 * @return	Current L2 norm of the errors across all observations.
+	 * @return	Current L2 norm of the errors across all observations, or -1 if the covariance of the
+	 * parameters is no longer positive definite (the estimate is then unchanged).
 	 */
-	double executeStep(vector<double> Zkhatc, forwardOp A, observationOp H);
+	double executeStep(const vector<double> &Zkhatc, const forwardFunction &A, const observationFunction &H);
+	/**
+	 * Performs one step of the Kalman filtering process evaluating all sigma points with a single
+	 * call to the batched operators. The operators receive the problem parameters.
+	 * @param Zkhatc	Current observations estimations.
+	 * @param A	Batched forward operator.
+	 * @param H	Batched observation operator;
+	 * @return	Current L2 norm of the errors across all observations, or -1 if the covariance of the
+	 * parameters is no longer positive definite (the estimate is then unchanged).
+	 */
+	double executeStep(const vector<double> &Zkhatc, const batchForwardFunction &A, const batchObservationFunction &H);
+	/**
+	 * Performs one step of the Kalman filtering process evaluating the observations by blocks.
+	 * Only one block of observations of the sigma points is held in memory, hence it suits
+	 * problems with a very large quantity of observations.
+	 * @param Zkhatc	Current observations estimations.
+	 * @param A	Forward operator.
+	 * @param H	Block observation operator.
+	 * @return	Current L2 norm of the errors across all observations, or -1 if the covariance of the
+	 * parameters is no longer positive definite (the estimate is then unchanged).
+	 */
+	double executeStepStreaming(const vector<double> &Zkhatc, const forwardFunction &A, const blockObservationFunction &H);
 	/**
 	 * Performs one step of the Kalman filtering process with parallel execution of the sigma points.
 	 * @param Zkhatc	Current observations estimations.
@@ -132,10 +168,26 @@ public:
 	 * @param seed Sigma point ID for the current MPI process.
 	 * @param local_comm Communicator of all MPI processes that solve the sigma point @p seed.
 	 * @param masters_comm Communicator of the master MPI processes of each sigma point @p seed.
-	 * @return	Current L2 norm of the errors across all observations.
+	 * @return	Current L2 norm of the errors across all observations, or -1 if the covariance of the
+	 * parameters is no longer positive definite (the estimate is then unchanged).
 	 */
-	double executeStepParallel(vector<double> Zkhatc, forwardOp A, observationOp H,
+	double executeStepParallel(const vector<double> &Zkhatc, const forwardFunction &A, const observationFunction &H,
 			int seed, MPI_Comm local_comm, MPI_Comm masters_comm);
+	/**
+	 * Performs one step of the Kalman filtering process distributing the sigma points among any
+	 * quantity of MPI solver groups. Groups take sigma points from a shared queue, the slowest
+	 * sigma points of the previous step first. If threads are set, each group evaluates as many
+	 * sigma points as threads at a time (the operators must then be thread-safe).
+	 * @param Zkhatc	Current observations estimations.
+	 * @param A	Forward operator.
+	 * @param H	Observation operator;
+	 * @param group_comm Communicator of all MPI processes of this solver group (rank 0 is the master).
+	 * @param masters_comm Communicator of the master MPI processes of each group, MPI_COMM_NULL in the workers.
+	 * @return	Current L2 norm of the errors across all observations, or -1 if the covariance of the
+	 * parameters is no longer positive definite (the estimate is then unchanged).
+	 */
+	double executeStepScheduled(const vector<double> &Zkhatc, const forwardFunction &A, const observationFunction &H,
+			MPI_Comm group_comm, MPI_Comm masters_comm);
 
 	/**
 	 * Returns to the initial state of the kalman filter. Not fully tested
@@ -150,21 +202,18 @@ public:
 			vector<double> observationsUncertainty, vector<double> parametersUncertainty,
 			SigmaPointsGenerator::SIGMA_DISTRIBUTION sigmaDistribution);
 	/**
-	 *	Replaces the current @p mapper for the new CompositeParameterMapper instance.
+	 *	Replaces the current @p mapper for the new CompositeParameterMapper instance. Same as
+	 * setParameterMapper.
 	 * @param mapper New mapper instance.
 	 */
 	void replaceMapper(CompositeParameterMapper *mapper);
 
 	/**
-	 * Return the current parameter estimatives in the array @p ThetaC.
+	 * Return the current parameter estimatives in a new array @p ThetaC that must be released by
+	 * the caller. See copyParameters to avoid the allocation.
 	 * @param ThetaC Current parameter estimatives.
 	 */
 	virtual void getParameters(double **ThetaC) override;
-	/**
-	 * Sets the initial parameter estimatives.
-	 * @param ThetaC Initial parameter estimatives.
-	 */
-	virtual void setParameters(double *ThetaC) override;
 
 };
 
@@ -41,9 +41,10 @@
  *	//	Set initial condition
  *	kalmanInstance->setState(initialGuess, nParameters);
  *
- *	for (int it = 0; it < 3000; it++) {
- *		error = kalmanInstance->executeStep(observation, nStates, ptA, ptH);
- *	}
+ *	//	Step until convergence, stagnation or divergence, at most MaxIterations steps
+ *	kalmanInstance->setTolerance(1E-6);
+ *	kalmanInstance->setMaxIterations(3000);
+ *	AbstractROUKF::RUN_STATUS status = kalmanInstance->run(observation, ptA, ptH);
  *
  *	//	Get the Kalman estimation
  *	kalmanInstance->getState(&sol);			// -> XSol
@@ -65,34 +66,17 @@ public:
 	 * @param statesUncertainty Vector with the uncertainty of each state in X.
 	 * @param parametersUncertainty Vector with the uncertainty of each parameter in Theta.
 	 * @param sigmaDistribution	Type of sigmas applied to assess the unscented transform.
+	 * @param stateStorage Directory of the file storing the states of the sigma points and
+	 * @p LX , created there directly so that they are never held in memory. See
+	 * setStateStorage. Empty to keep them in memory.
 	 */
 	ROUKF(int nObservations, int nStates, int nParameters,
 			double *statesUncertainty, double *parametersUncertainty,
-			SigmaPointsGenerator::SIGMA_DISTRIBUTION sigmaDistribution);
+			SigmaPointsGenerator::SIGMA_DISTRIBUTION sigmaDistribution, const string &stateStorage = string());
 	/**
 	 * Void destructor.
 	 */
 	~ROUKF();
-	/**
-	 * Performs one step of the Kalman filtering process in serial execution of the sigma points.
-	 * @param Zkhatc	Current observations estimations.
-	 * @param A	Forward operator.
-	 * @param H	Observation operator;
-	 * @return	Current L2 norm of the errors across all observations.
-	 */
-	double executeStep(double *Zkhatc, forwardOp A, observationOp H);
-	/**
-	 * Performs one step of the Kalman filtering process with parallel execution of the sigma points.
-	 * @param Zkhatc	Current observations estimations.
-	 * @param A	Forward operator.
-	 * @param H	Observation operator;
-	 * @param seed Sigma point ID for the current MPI process.
-	 * @param local_comm Communicator of all MPI processes that solve the sigma point @p seed.
-	 * @param masters_comm Communicator of the master MPI processes of each sigma point @p seed.
-	 * @return	Current L2 norm of the errors across all observations.
-	 */
-	double executeStepParallel(double *Zkhatc, forwardOp A, observationOp H,
-			int seed, MPI_Comm local_comm, MPI_Comm masters_comm);
 
 	/**
 	 * Returns to the initial state of the kalman filter. Not fully tested
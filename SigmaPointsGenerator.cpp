@@ -9,6 +9,9 @@
 
 using namespace std;
 
+map<pair<int, int>, shared_ptr<const SigmaPointsGenerator::SigmaPointsSet> > SigmaPointsGenerator::cache;
+mutex SigmaPointsGenerator::cacheMutex;
+
 void SigmaPointsGenerator::generateSigmaPoints(int nParameters,
 		SIGMA_DISTRIBUTION distribution, arma::mat* sigma) {
 
@@ -31,6 +34,32 @@ void SigmaPointsGenerator::generateSigmaPoints(int nParameters,
 	}
 }
 
+shared_ptr<const SigmaPointsGenerator::SigmaPointsSet> SigmaPointsGenerator::getSigmaPointsSet(
+		int nParameters, SIGMA_DISTRIBUTION distribution) {
+	pair<int, int> key(nParameters, distribution);
+	{
+		lock_guard<mutex> lock(cacheMutex);
+		auto it = cache.find(key);
+		if (it != cache.end())
+			return it->second;
+	}
+
+	//	Generated without the lock, if two threads race the first inserted set is kept.
+	shared_ptr<SigmaPointsSet> set = make_shared<SigmaPointsSet>();
+	generateSigmaPoints(nParameters, distribution, &set->sigma);
+	set->alpha = 1. / set->sigma.n_cols;
+	set->Dsigma = set->alpha * set->sigma.t();
+	set->Pa = set->sigma * set->Dsigma;
+
+	lock_guard<mutex> lock(cacheMutex);
+	return cache.insert(make_pair(key, shared_ptr<const SigmaPointsSet>(set))).first->second;
+}
+
+void SigmaPointsGenerator::clearCache() {
+	lock_guard<mutex> lock(cacheMutex);
+	cache.clear();
+}
+
 void SigmaPointsGenerator::canonicSigmaPoints(int nParameters,
 		arma::mat* sigma) {
 	int nSigmas = 2 * nParameters;
@@ -66,18 +95,14 @@ arma::mat SigmaPointsGenerator::getSimplexSigmaPoints(int nPoints,
 
 	arma::mat sigma = arma::zeros(nPoints, nPoints + 1);
 
-	double currWeight = 1. / sqrt((double) (nPoints * (nPoints + 1)) * weight);
-	if (nPoints == 1) {
-		sigma.at(0, 0) = -currWeight;
-		sigma.at(0, 1) = currWeight;
-		return sigma;
+	//	Same values as the recursion sigma_n = [sigma_{n-1} 0; -w_n ... -w_n n*w_n]
+	for (int row = 0; row < nPoints; row++) {
+		int n = row + 1;
+		double currWeight = 1. / sqrt((double) n * (n + 1) * weight);
+		for (int col = 0; col < n; col++)
+			sigma.at(row, col) = -currWeight;
+		sigma.at(row, n) = n * currWeight;
 	}
-	sigma.submat(0, 0, nPoints - 2, nPoints - 1) = getSimplexSigmaPoints(
-			nPoints - 1, weight);
-	for (int col = 0; col < nPoints; col++)
-		sigma.at(nPoints - 1, col) = -currWeight;
-
-	sigma.at(nPoints - 1, nPoints) = nPoints * (currWeight);
 
 	return sigma;
 }
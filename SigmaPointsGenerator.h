@@ -9,6 +9,12 @@
 #define SIGMAPOINTSGENERATOR_H_
 
 #include <armadillo>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+using namespace std;
 
 /**
  * Static class which generates different distributions of sigma points.
@@ -18,6 +24,21 @@ public:
 	/**	Enumeration for the different kinds of sigma points distributions. */
 	enum SIGMA_DISTRIBUTION {SIMPLEX,CANONIC,STAR,SIMPLEX_STAR};
 
+	/**
+	 * Sigma points of a distribution together with the matrices that the filters derive from
+	 * them. Sets are shared among filters, hence they are immutable.
+	 */
+	struct SigmaPointsSet {
+		/**	Matrix with sigma points as columns. */
+		arma::mat sigma;
+		/** Matrix with sigma points weighted as rows. */
+		arma::mat Dsigma;
+		/** Matrix @p sigma times @p Dsigma . */
+		arma::mat Pa;
+		/**	Weight for each sigma point. */
+		double alpha;
+	};
+
 	/**
 	 * Generates the matrix sigma where each column is a sigma point of the type @p distribution.
 	 * @param nParameters	Quantity of parameters to estimate.
@@ -25,6 +46,19 @@ public:
 	 * @param sigma	Output matrix with one sigma point per column.
 	 */
 	static void generateSigmaPoints(int nParameters, SIGMA_DISTRIBUTION distribution, arma::mat*sigma);
+	/**
+	 * Returns the sigma points of the type @p distribution and their derived matrices. Sets are
+	 * generated once per process and cached, so that creating many filters with the same
+	 * dimensions costs a copy of the matrices. It can be called from several threads.
+	 * @param nParameters	Quantity of parameters to estimate.
+	 * @param distribution	Type of distribution used to generate the sigma points.
+	 * @return	Shared sigma points set.
+	 */
+	static shared_ptr<const SigmaPointsSet> getSigmaPointsSet(int nParameters, SIGMA_DISTRIBUTION distribution);
+	/**
+	 * Releases the cached sigma points sets. Sets still held by the callers stay valid.
+	 */
+	static void clearCache();
 
 protected:
 	/**
@@ -53,8 +87,14 @@ protected:
 	static void simplexStarSigmaPoints(int nParameters, arma::mat *sigma);
 
 private:
+	/**	Sigma points sets generated so far, by quantity of parameters and distribution. */
+	static map<pair<int, int>, shared_ptr<const SigmaPointsSet> > cache;
+	/**	Serializes the accesses to @p cache . */
+	static mutex cacheMutex;
+
 	/**
-	 * Recursive generation of simplex sigma points.
+	 * Generation of simplex sigma points in a single pass. Row k holds the point k+1 of the
+	 * simplex of dimension k+1, which is equivalent to the recursive construction.
 	 * @param nPoints	Quantity of points to generate.
 	 * @param weight	Weight for the current generated points.
 	 * @return	Matrix of sigma points.
@@ -15,51 +15,20 @@
 #define STATICROUKF_H_
 
 #include <armadillo>
-#include <mpi.h>
 #include <vector>
 
+#include "AbstractROUKF.h"
+#include "ForwardCache.h"
 #include "SigmaPointsGenerator.h"
 
 using namespace std;
 
-typedef int (*forwardOp)(double *, int, double *, int);
-typedef void (*observationOp)(double *, int, double *, int);
-
 /**
  * Class that implements the reduced order unscented Kalman filter without
- * statistical propagation of the internal state.
+ * statistical propagation of the internal state. The forward operator starts each sigma point
+ * from its own states, the states block it receives is scratch memory.
  */
-class StaticROUKF {
-
-	/**	Parameters vector.	*/
-	arma::mat Theta;
-	/**	U part of the covariance matrix	after LU factorization.	*/
-	arma::mat U;
-	/**	U squared.	*/
-	arma::mat U2;
-	/**	L part of the covariance matrix	after LU factorization concerning to the parameter part of the extended state vector.	*/
-	arma::mat LTheta;
-	/** Observations confidence matrix.	*/
-	arma::sp_mat Wi;
-
-	/**	Matrix with sigma points as columns. */
-	arma::mat sigma;
-	/** Matrix with sigma points weighted as rows. */
-	arma::mat Dsigma;
-	/** Matrix @p sigma times @p Dsigma . */
-	arma::mat Pa;
-
-	/**	Vector with the observations errors after the last iteration. */
-	arma::mat error;
-
-	/**	Quantity of observations. */
-	int nObservations;
-	/**	Quantity of parameters. */
-	int nParameters;
-	/**	Quantity of states. */
-	int nStates;
-	/**	Weight for each sigma point. */
-	double alpha;
+class StaticROUKF : public AbstractROUKF {
 
 public:
 
@@ -79,27 +48,10 @@ public:
 	StaticROUKF(int nObservations, int nStates, int nParameters,
 			double *statesUncertainty, double *parametersUncertainty,
 			SigmaPointsGenerator::SIGMA_DISTRIBUTION sigmaDistribution);
-
 	/**
-	 * Performs one step of the Kalman filtering process in serial execution of the sigma points.
-	 * @param Zkhatc	Current observations estimations.
-	 * @param A	Forward operator.
-	 * @param H	Observation operator;
-	 * @return	Current L2 norm of the errors across all observations.
+	 * Void destructor.
 	 */
-	double executeStep(double *Zkhatc, forwardOp A, observationOp H);
-	/**
-	 * Performs one step of the Kalman filtering process with parallel execution of the sigma points.
-	 * @param Zkhatc	Current observations estimations.
-	 * @param A	Forward operator.
-	 * @param H	Observation operator;
-	 * @param seed Sigma point ID for the current MPI process.
-	 * @param local_comm Communicator of all MPI processes that solve the sigma point @p seed.
-	 * @param masters_comm Communicator of the master MPI processes of each sigma point @p seed.
-	 * @return	Current L2 norm of the errors across all observations.
-	 */
-	double executeStepParallel(double *Zkhatc, forwardOp A, observationOp H,
-			int seed, MPI_Comm local_comm, MPI_Comm masters_comm);
+	~StaticROUKF();
 
 	/**
 	 * Returns to the initial state of the kalman filter. Not fully tested
@@ -115,47 +67,28 @@ public:
 			SigmaPointsGenerator::SIGMA_DISTRIBUTION sigmaDistribution);
 
 	/**
-	 * Prints the private attributes of the ROUKF instance.
-	 */
-	void toString();
-
-	/**
-	 * Returns a vector with the standard variation of each parameter at the current iteration.
-	 * @return Vector with the standard variation of each parameter at the current iteration.
+	 * Enables the memory of the observations of the evaluated parameters. Since each sigma point
+	 * starts from its own states, the observations only depend on the parameters and the sigma
+	 * points that repeat a stored parameters vector (or, with a tolerance, that fall in its
+	 * quantization cell) skip the forward and observation operators. It applies to the steps that
+	 * evaluate one sigma point at a time with an observation operator (not the batched, windowed
+	 * or streaming ones), with any execution backend, as the cache is looked up and filled by the
+	 * process of the filter. Sigma points of the same step that fall in the same cell are always
+	 * evaluated. The operators must not change while the cache is enabled, call
+	 * clearForwardCache otherwise.
+	 * @param budget Maximum bytes held by the stored observations, 0 disables the cache.
+	 * @param tolerance Side of the quantization cells of the problem parameters, 0 for exact matches.
 	 */
-	vector<double> getParametersStd();
-	/**
-	 * Getter of the field @p Theta.
-	 * @param ThetaC Field @p Theta converted to STL array.
-	 */
-	virtual void getParameters(double **ThetaC);
-	/**
-	 * Setter of the field @p Theta.
-	 * @param ThetaC Array of parameters.
-	 */
-	virtual void setParameters(double *ThetaC);
-
-	/**
-	 * Returns the error associated to each observation at the current iteration in a STL array.
-	 * @param err Error associated to each observation at the current iteration.
-	 */
-	void getError(double **err);
-	/**
-	 * Returns the error associated to the @p numObservation observation.
-	 * @param numObservation Index of the observation of interest.
-	 */
-	double getObsError(int numObservation);
-
+	void setForwardCache(size_t budget, double tolerance = 0);
 	/**
-	 * Return the number of observations used in this instance of the kalman filter.
-	 * @return Number of observations used in this instance of the kalman filter.
+	 * Removes the stored observations and resets the statistics of the cache, if enabled.
 	 */
-	int getObservations() const;
+	void clearForwardCache();
 	/**
-	 * Return the number of states used in this instance of the kalman filter.
-	 * @return Number of states used in this instance of the kalman filter.
+	 * Returns the memory of the observations, with its hit and miss statistics.
+	 * @return Cache, or NULL if disabled.
 	 */
-	int getStates() const;
+	const ForwardCache *getForwardCache() const;
 };
 
 #endif /* StatelessROUKF_H_ */
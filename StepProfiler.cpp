@@ -0,0 +1,101 @@
+/*
+ * StepProfiler.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "StepProfiler.h"
+
+#include <cstdio>
+#include <iostream>
+
+StepProfiler::StepProfiler() {
+	enabled = false;
+	tracing = false;
+	reset();
+}
+
+void StepProfiler::setEnabled(bool enabled, bool tracing) {
+	this->enabled = enabled;
+	this->tracing = enabled && tracing;
+}
+
+void StepProfiler::reset() {
+	for (int i = 0; i < PHASES; ++i)
+		times[i] = 0;
+	for (int i = 0; i < COUNTERS; ++i)
+		counters[i] = 0;
+	lock_guard<mutex> lock(eventsMutex);
+	events.clear();
+	origin = chrono::steady_clock::now();
+}
+
+void StepProfiler::record(PHASE phase, int thread, chrono::steady_clock::time_point start,
+		chrono::steady_clock::time_point end) {
+	times[phase] += chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+	if (!tracing)
+		return;
+
+	Event event;
+	event.phase = phase;
+	event.thread = thread;
+	event.start = chrono::duration<double, micro>(start - origin).count();
+	event.duration = chrono::duration<double, micro>(end - start).count();
+	lock_guard<mutex> lock(eventsMutex);
+	events.push_back(event);
+}
+
+double StepProfiler::getTime(PHASE phase) const {
+	return times[phase] * 1E-9;
+}
+
+long long StepProfiler::getCount(COUNTER counter) const {
+	return counters[counter];
+}
+
+void StepProfiler::copyCounts(long long *values) const {
+	for (int i = 0; i < PHASES; ++i)
+		values[i] = times[i];
+	for (int i = 0; i < COUNTERS; ++i)
+		values[PHASES + i] = counters[i];
+}
+
+void StepProfiler::addCounts(const long long *values) {
+	for (int i = 0; i < PHASES; ++i)
+		times[i] += values[i];
+	for (int i = 0; i < COUNTERS; ++i)
+		counters[i] += values[PHASES + i];
+}
+
+const char *StepProfiler::getName(PHASE phase) {
+	static const char *names[] = { "sampling", "forward", "observation", "assembly", "factorization",
+			"state_update", "communication" };
+	return phase < PHASES ? names[phase] : "";
+}
+
+const char *StepProfiler::getName(COUNTER counter) {
+	static const char *names[] = { "steps", "forward_calls", "observation_calls", "bytes_communicated",
+			"workspace_allocations", "forward_cache_hits",
+			"surrogate_predictions" };
+	return counter < COUNTERS ? names[counter] : "";
+}
+
+bool StepProfiler::writeChromeTrace(const string &filename, int process) {
+	FILE *file = fopen(filename.c_str(), "w");
+	if (!file) {
+		cerr << "Unable to write the trace " << filename << "." << endl;
+		return false;
+	}
+
+	lock_guard<mutex> lock(eventsMutex);
+	fprintf(file, "{\"traceEvents\": [\n");
+	for (size_t i = 0; i < events.size(); ++i)
+		fprintf(file, "{\"name\": \"%s\", \"cat\": \"kalman\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, "
+				"\"pid\": %d, \"tid\": %d}%s\n", getName(events[i].phase), events[i].start, events[i].duration,
+				process, events[i].thread, i + 1 < events.size() ? "," : "");
+	fprintf(file, "],\n\"otherData\": {");
+	for (int i = 0; i < COUNTERS; ++i)
+		fprintf(file, "%s\"%s\": %lld", i > 0 ? ", " : "", getName((COUNTER) i), (long long) counters[i]);
+	fprintf(file, "}}\n");
+	return fclose(file) == 0;
+}
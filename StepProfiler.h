@@ -0,0 +1,217 @@
+/*
+ * StepProfiler.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef STEPPROFILER_H_
+#define STEPPROFILER_H_
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Per-phase wall-clock timers and counters of the filter steps. Phases and counters may be
+ * recorded from the threads that evaluate the sigma points at once. When the profiler is
+ * disabled, recording costs a branch and no clock is read. Optionally each recorded interval
+ * is kept as an event to be exported as a Chrome trace (chrome://tracing or Perfetto).
+ */
+class StepProfiler {
+public:
+	/**	Phases of a step. */
+	enum PHASE {
+		/**	Sampling of the sigma points around the estimate. */
+		SAMPLING,
+		/**	Forward operator calls. */
+		FORWARD,
+		/**	Observation operator calls. */
+		OBSERVATION,
+		/**	Means, innovation and covariance terms of the update. */
+		ASSEMBLY,
+		/**	Cholesky factorization and triangular solves. */
+		FACTORIZATION,
+		/**	Update of the states and their covariance factor. */
+		STATE_UPDATE,
+		/**	Exchange of the sigma points among processes. */
+		COMMUNICATION,
+		PHASES
+	};
+	/**	Counters of a step. */
+	enum COUNTER {
+		/**	Executed steps. */
+		STEPS,
+		/**	Forward operator calls. */
+		FORWARD_CALLS,
+		/**	Observation operator calls. */
+		OBSERVATION_CALLS,
+		/**	Bytes sent and received by this process. */
+		BYTES_COMMUNICATED,
+		/**	Matrices of the step workspace (re)allocated. */
+		WORKSPACE_ALLOCATIONS,
+		/**	Sigma points whose observations were taken from the forward cache. */
+		FORWARD_CACHE_HITS,
+		/**	Sigma points whose observations were predicted by the surrogate model. */
+		SURROGATE_PREDICTIONS,
+		COUNTERS
+	};
+
+	/**
+	 * Records the wall-clock time of a phase from its construction to its destruction.
+	 */
+	class Scope {
+		/**	Profiler where the phase is recorded, NULL if disabled. */
+		StepProfiler *profiler;
+		/**	Recorded phase. */
+		PHASE phase;
+		/**	Thread that executes the phase. */
+		int thread;
+		/**	Time at the beginning of the phase. */
+		chrono::steady_clock::time_point start;
+
+	public:
+		/**
+		 * Starts the phase if @p profiler is enabled.
+		 * @param profiler Profiler, it may be NULL.
+		 * @param phase Recorded phase.
+		 * @param thread Thread that executes the phase.
+		 */
+		Scope(StepProfiler *profiler, PHASE phase, int thread = 0) {
+			this->profiler = profiler && profiler->isEnabled() ? profiler : NULL;
+			this->phase = phase;
+			this->thread = thread;
+			if (this->profiler)
+				start = chrono::steady_clock::now();
+		}
+		/**
+		 * Records the phase.
+		 */
+		~Scope() {
+			if (profiler)
+				profiler->record(phase, thread, start, chrono::steady_clock::now());
+		}
+	};
+
+private:
+	/**	Event of the Chrome trace. */
+	struct Event {
+		/**	Phase of the event. */
+		PHASE phase;
+		/**	Thread that executed the phase. */
+		int thread;
+		/**	Beginning of the event in microseconds since the profiler was reset. */
+		double start;
+		/**	Duration in microseconds. */
+		double duration;
+	};
+
+	/**	If the phases and counters are recorded. */
+	bool enabled;
+	/**	If the events are kept for the Chrome trace. */
+	bool tracing;
+	/**	Accumulated time of each phase in nanoseconds. */
+	atomic<long long> times[PHASES];
+	/**	Value of each counter. */
+	atomic<long long> counters[COUNTERS];
+	/**	Origin of the event times. */
+	chrono::steady_clock::time_point origin;
+	/**	Events of the Chrome trace. */
+	vector<Event> events;
+	/**	Serializes the insertion of events. */
+	mutex eventsMutex;
+
+public:
+	/**
+	 * Creates a disabled profiler.
+	 */
+	StepProfiler();
+
+	/**
+	 * Enables or disables the recording.
+	 * @param enabled If phases and counters are recorded.
+	 * @param tracing If the events are kept for the Chrome trace. Each event takes memory,
+	 * hence it should only be enabled for a limited quantity of steps.
+	 */
+	void setEnabled(bool enabled, bool tracing = false);
+	/**
+	 * Getter of the field @p enabled .
+	 * @return If the phases and counters are recorded.
+	 */
+	bool isEnabled() const {
+		return enabled;
+	}
+	/**
+	 * Zeroes the timers and counters and drops the events.
+	 */
+	void reset();
+
+	/**
+	 * Adds the interval [start, end] to the time of @p phase .
+	 * @param phase Recorded phase.
+	 * @param thread Thread that executed the phase.
+	 * @param start Beginning of the phase.
+	 * @param end End of the phase.
+	 */
+	void record(PHASE phase, int thread, chrono::steady_clock::time_point start,
+			chrono::steady_clock::time_point end);
+	/**
+	 * Adds @p amount to @p counter if the profiler is enabled.
+	 * @param counter Counter.
+	 * @param amount Amount added.
+	 */
+	void count(COUNTER counter, long long amount = 1) {
+		if (enabled)
+			counters[counter] += amount;
+	}
+
+	/**
+	 * Returns the accumulated time of a phase. Phases executed by several threads at once add
+	 * the time of each thread.
+	 * @param phase Phase.
+	 * @return Time in seconds.
+	 */
+	double getTime(PHASE phase) const;
+	/**
+	 * Returns the value of a counter.
+	 * @param counter Counter.
+	 * @return Value of @p counter .
+	 */
+	long long getCount(COUNTER counter) const;
+	/**
+	 * Copies the time of every phase in nanoseconds followed by every counter, so that they can
+	 * be transferred from another process.
+	 * @param values Array with room for PHASES + COUNTERS elements.
+	 */
+	void copyCounts(long long *values) const;
+	/**
+	 * Adds times and counters copied by copyCounts, e.g. the differences of a child process.
+	 * @param values Time of every phase in nanoseconds followed by every counter.
+	 */
+	void addCounts(const long long *values);
+	/**
+	 * Returns the name of a phase.
+	 * @param phase Phase.
+	 * @return Name of @p phase .
+	 */
+	static const char *getName(PHASE phase);
+	/**
+	 * Returns the name of a counter.
+	 * @param counter Counter.
+	 * @return Name of @p counter .
+	 */
+	static const char *getName(COUNTER counter);
+
+	/**
+	 * Writes the recorded events as a Chrome trace JSON file.
+	 * @param filename Path of the trace.
+	 * @param process Process ID of the events, e.g. the MPI rank.
+	 * @return If the trace was written.
+	 */
+	bool writeChromeTrace(const string &filename, int process = 0);
+};
+
+#endif /* STEPPROFILER_H_ */
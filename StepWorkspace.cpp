@@ -0,0 +1,84 @@
+/*
+ * StepWorkspace.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <algorithm>
+
+#include "StepWorkspace.h"
+
+using namespace arma;
+
+/**
+ * Sets the size of @p m .
+ * @param m Matrix.
+ * @param rows Quantity of rows.
+ * @param cols Quantity of columns.
+ * @return 1 if the memory of @p m was reallocated, 0 otherwise.
+ */
+static int setSize(mat &m, int rows, int cols) {
+	const double *memory = m.memptr();
+	uword n = m.n_elem;
+	m.set_size(rows, cols);
+	return m.n_elem != n || m.memptr() != memory ? 1 : 0;
+}
+
+int StepWorkspace::resize(int nStates, int nParameters, int nObservations, int nSigma, int nThreads) {
+	int allocations = setSize(Xk, nStates, nSigma);
+	allocations += setSize(Thetak, nParameters, nSigma);
+	allocations += setSize(problemThetak, nParameters, nSigma);
+	allocations += setSize(S, nParameters, nSigma);
+	allocations += setSize(xkMean, nStates, 1);
+	allocations += setSize(thetakMean, nParameters, 1);
+	allocations += setSize(Un, nParameters, nParameters);
+	allocations += setSize(Rn, nParameters, nParameters);
+	allocations += setSize(gain, nParameters, 1);
+	allocations += setSize(xkScratch, nStates, nThreads);
+	return allocations + resizeObservations(nObservations, nParameters, nSigma);
+}
+
+int StepWorkspace::resizeObservations(int rows, int nParameters, int nSigma) {
+	int allocations = setSize(Zk, rows, nSigma);
+	allocations += setSize(HL, rows, nParameters);
+	allocations += setSize(zkMean, rows, 1);
+	return allocations + setSize(whitenedError, rows, 1);
+}
+
+void StepWorkspace::solveUpper(const mat &R, double *B, int nCols) {
+	int n = R.n_rows;
+	for (int col = 0; col < nCols; ++col) {
+		double *b = B + col * n;
+		for (int i = n - 1; i >= 0; --i) {
+			//	Backward substitution by columns of R, contiguous in memory.
+			const double *r = R.colptr(i);
+			b[i] /= r[i];
+			for (int j = 0; j < i; ++j)
+				b[j] -= r[j] * b[i];
+		}
+	}
+}
+
+void StepWorkspace::solveUpperTransposed(const mat &R, double *B, int nCols) {
+	int n = R.n_rows;
+	for (int col = 0; col < nCols; ++col) {
+		double *b = B + col * n;
+		for (int i = 0; i < n; ++i) {
+			//	Column i of R holds row i of R^T, contiguous in memory.
+			const double *r = R.colptr(i);
+			double sum = b[i];
+			for (int j = 0; j < i; ++j)
+				sum -= r[j] * b[j];
+			b[i] = sum / r[i];
+		}
+	}
+}
+
+bool StepWorkspace::cholReversed(mat &R, mat &U) {
+	std::reverse(U.memptr(), U.memptr() + U.n_elem);
+	bool factored = chol(R, U, "lower");
+	std::reverse(U.memptr(), U.memptr() + U.n_elem);
+	if (factored)
+		std::reverse(R.memptr(), R.memptr() + R.n_elem);
+	return factored;
+}
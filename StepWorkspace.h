@@ -0,0 +1,95 @@
+/*
+ * StepWorkspace.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef STEPWORKSPACE_H_
+#define STEPWORKSPACE_H_
+
+#include <armadillo>
+
+/**
+ * Preallocated matrices used by one step of the filter. They are sized once when the
+ * filter is created or reset, so that the steady-state step does not allocate memory.
+ */
+class StepWorkspace {
+public:
+	/**	States of each sigma point as columns (nStates x nSigma). */
+	arma::mat Xk;
+	/**	Parameters of each sigma point as columns (nParameters x nSigma). */
+	arma::mat Thetak;
+	/**	Observations of each sigma point as columns (nObservations x nSigma). */
+	arma::mat Zk;
+	/**	Parameters of each sigma point in the problem space, to look up the forward cache (nParameters x nSigma). */
+	arma::mat problemThetak;
+	/**	Sigma points scaled by the square root of the covariance (nParameters x nSigma). */
+	arma::mat S;
+	/**	Observations covariance factor, whitened by the observation error model (nObservations x nParameters). */
+	arma::mat HL;
+	/**	Mean of the states of the sigma points. */
+	arma::mat xkMean;
+	/**	Mean of the parameters of the sigma points. */
+	arma::mat thetakMean;
+	/**	Mean of the observations of the sigma points, replaced by the residual in the windowed steps. */
+	arma::mat zkMean;
+	/**	Observations errors whitened by the observation error model. */
+	arma::mat whitenedError;
+	/**	New U of the update, kept apart so that a failed factorization leaves U unchanged (nParameters x nParameters). */
+	arma::mat Un;
+	/**	Upper triangular UL factor of @p Un , Un = Rn Rn^T (nParameters x nParameters). */
+	arma::mat Rn;
+	/**	Kalman gain applied to the errors (nParameters x 1). */
+	arma::mat gain;
+	/**	Per-thread scratch states for filters that do not keep the states (nStates x nThreads). */
+	arma::mat xkScratch;
+
+	/**
+	 * Sizes all matrices of the workspace. Matrices that already have the requested size keep
+	 * their memory.
+	 * @param nStates Quantity of states.
+	 * @param nParameters Quantity of parameters.
+	 * @param nObservations Quantity of observations.
+	 * @param nSigma Quantity of sigma points.
+	 * @param nThreads Quantity of threads evaluating the sigma points.
+	 * @return Quantity of matrices whose memory was reallocated.
+	 */
+	int resize(int nStates, int nParameters, int nObservations, int nSigma, int nThreads);
+	/**
+	 * Sizes the matrices indexed by observations (@p Zk , @p HL , @p zkMean and
+	 * @p whitenedError ) for @p rows observations. The streaming step sizes them for one block
+	 * of observations only.
+	 * @param rows Quantity of observations held at once.
+	 * @param nParameters Quantity of parameters.
+	 * @param nSigma Quantity of sigma points.
+	 * @return Quantity of matrices whose memory was reallocated.
+	 */
+	int resizeObservations(int rows, int nParameters, int nSigma);
+
+	/**
+	 * Solves in place R Y = B, with R upper triangular, without temporaries.
+	 * @param R Upper triangular matrix.
+	 * @param B Column-major right hand side with R.n_rows rows, overwritten with the solution.
+	 * @param nCols Quantity of columns of @p B .
+	 */
+	static void solveUpper(const arma::mat &R, double *B, int nCols);
+	/**
+	 * Solves in place R^T Y = B, with R upper triangular, without temporaries.
+	 * @param R Upper triangular matrix.
+	 * @param B Column-major right hand side with R.n_rows rows, overwritten with the solution.
+	 * @param nCols Quantity of columns of @p B .
+	 */
+	static void solveUpperTransposed(const arma::mat &R, double *B, int nCols);
+	/**
+	 * Factors U = R R^T with R upper triangular (UL Cholesky factorization). R^{-T} is then
+	 * the lower Cholesky factor of U^{-1}, so that the sigma points are sampled as with
+	 * chol(inv(U)) without inverting U. Reversing the rows and columns of a matrix reverses
+	 * its memory, so the factor is the reversed lower Cholesky factor of the reversed U.
+	 * @param R Returns the upper triangular factor, sized as @p U .
+	 * @param U Symmetric matrix, reversed during the factorization and restored.
+	 * @return If @p U is positive definite.
+	 */
+	static bool cholReversed(arma::mat &R, arma::mat &U);
+};
+
+#endif /* STEPWORKSPACE_H_ */
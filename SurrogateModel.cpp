@@ -0,0 +1,165 @@
+/*
+ * SurrogateModel.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "SurrogateModel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+SurrogateModel::SurrogateModel(int nParameters, int nObservations, double threshold, int capacity,
+		double lengthScale, double nugget) {
+	this->nParameters = nParameters;
+	this->nObservations = nObservations;
+	this->threshold = threshold;
+	this->capacity = capacity > 0 ? capacity : 10 * (nParameters + 1);
+	this->lengthScale = lengthScale;
+	this->nugget = nugget;
+	minSamples = nParameters + 2;
+
+	inputs = zeros(nParameters, this->capacity);
+	outputs = zeros(nObservations, this->capacity);
+	nSamples = 0;
+	next = 0;
+	fitted = false;
+	predictions = 0;
+	fallbacks = 0;
+}
+
+void SurrogateModel::addSample(const double *theta, const double *z) {
+	lock_guard<mutex> lock(pendingMutex);
+	pendingInputs.insert(pendingInputs.end(), theta, theta + nParameters);
+	pendingOutputs.insert(pendingOutputs.end(), z, z + nObservations);
+}
+
+void SurrogateModel::fit() {
+	{
+		lock_guard<mutex> lock(pendingMutex);
+		if (pendingInputs.empty())
+			return;
+		int nPending = pendingInputs.size() / nParameters;
+		for (int s = 0; s < nPending; ++s) {
+			std::copy(pendingInputs.begin() + s * nParameters, pendingInputs.begin() + (s + 1) * nParameters,
+					inputs.colptr(next));
+			std::copy(pendingOutputs.begin() + s * nObservations, pendingOutputs.begin() + (s + 1) * nObservations,
+					outputs.colptr(next));
+			next = (next + 1) % capacity;
+			nSamples = std::min(nSamples + 1, capacity);
+		}
+		pendingInputs.clear();
+		pendingOutputs.clear();
+	}
+
+	fitted = false;
+	if (nSamples < minSamples)
+		return;
+
+	//	Parameters normalized by the spread of the training set
+	mat X = inputs.cols(0, nSamples - 1);
+	center = mean(X, 1);
+	scale = stddev(X, 0, 1);
+	for (int j = 0; j < nParameters; ++j)
+		if (!(scale[j] > 0))
+			scale[j] = 1;
+	normalizedInputs = X;
+	normalizedInputs.each_col() -= center;
+	normalizedInputs.each_col() /= scale;
+
+	mat K(nSamples, nSamples);
+	double factor = -0.5 / (lengthScale * lengthScale);
+	for (int b = 0; b < nSamples; ++b)
+		for (int a = b; a < nSamples; ++a) {
+			double d2 = accu(square(normalizedInputs.col(a) - normalizedInputs.col(b)));
+			K.at(a, b) = K.at(b, a) = exp(factor * d2);
+		}
+	K.diag() += nugget;
+	if (!chol(L, K, "lower")) {
+		cerr << "The kernel matrix of the surrogate model is not positive definite, the true operators are used." << endl;
+		return;
+	}
+
+	//	Constant mean and maximum likelihood amplitude of each observation
+	mat Y = outputs.cols(0, nSamples - 1);
+	outputMean = mean(Y, 1);
+	Y.each_col() -= outputMean;
+	mat Yt = Y.t();
+	alpha = solve(trimatu(L.t()), solve(trimatl(L), Yt));
+	amplitude = sum(Yt % alpha, 0).t() / nSamples;
+	fitted = true;
+}
+
+bool SurrogateModel::predict(const double *theta, double *z) {
+	if (!fitted)
+		return false;
+
+	vec t(nParameters);
+	for (int j = 0; j < nParameters; ++j)
+		t[j] = (theta[j] - center[j]) / scale[j];
+	vec k(nSamples);
+	double factor = -0.5 / (lengthScale * lengthScale);
+	for (int a = 0; a < nSamples; ++a)
+		k[a] = exp(factor * accu(square(normalizedInputs.col(a) - t)));
+
+	//	Predicted variance of the normalized process, scaled by the amplitude of each observation
+	vec v = solve(trimatl(L), k);
+	double variance = std::max(0., 1. - dot(v, v));
+	if (sqrt(variance * amplitude.max()) > threshold) {
+		++fallbacks;
+		return false;
+	}
+
+	vec prediction = outputMean + alpha.t() * k;
+	std::copy(prediction.begin(), prediction.end(), z);
+	++predictions;
+	return true;
+}
+
+void SurrogateModel::clear() {
+	lock_guard<mutex> lock(pendingMutex);
+	pendingInputs.clear();
+	pendingOutputs.clear();
+	nSamples = 0;
+	next = 0;
+	fitted = false;
+	predictions = 0;
+	fallbacks = 0;
+}
+
+long long SurrogateModel::getSavedSolves() const {
+	return predictions;
+}
+
+long long SurrogateModel::getFallbacks() const {
+	return fallbacks;
+}
+
+int SurrogateModel::getSamples() const {
+	return nSamples;
+}
+
+int SurrogateModel::getMinSamples() const {
+	return minSamples;
+}
+
+void SurrogateModel::setMinSamples(int minSamples) {
+	this->minSamples = minSamples;
+}
+
+double SurrogateModel::getThreshold() const {
+	return threshold;
+}
+
+void SurrogateModel::setThreshold(double threshold) {
+	this->threshold = threshold;
+}
+
+int SurrogateModel::getParameters() const {
+	return nParameters;
+}
+
+int SurrogateModel::getObservations() const {
+	return nObservations;
+}
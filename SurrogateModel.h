@@ -0,0 +1,170 @@
+/*
+ * SurrogateModel.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef SURROGATEMODEL_H_
+#define SURROGATEMODEL_H_
+
+#include <armadillo>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+using namespace arma;
+using namespace std;
+
+/**
+ * Gaussian process emulator of the observations of the sigma points as a function of their
+ * kalman parameters. It is trained with the sigma points truly evaluated so far and answers the
+ * later ones when the predicted standard deviation of every observation is under a threshold,
+ * otherwise the filter falls back to the true operators.
+ *
+ * The emulator has a constant mean and a squared exponential kernel over the parameters
+ * normalized by the spread of the training set. The observations share the kernel and each one
+ * has its own amplitude, estimated by maximum likelihood. Only the most recent samples are kept
+ * (the ones around the current estimate). The model is refitted by fit, before each step, with
+ * the samples added during the previous one; predict does not modify it, hence it can be called
+ * from the threads that evaluate the sigma points at once and the results do not depend on the
+ * order of evaluation.
+ */
+class SurrogateModel {
+	/**	Quantity of parameters. */
+	int nParameters;
+	/**	Quantity of observations. */
+	int nObservations;
+	/**	Maximum predicted standard deviation of any observation to answer with the emulator. */
+	double threshold;
+	/**	Maximum quantity of training samples, the oldest ones are dropped first. */
+	int capacity;
+	/**	Length scale of the kernel in units of the spread of the training parameters. */
+	double lengthScale;
+	/**	Regularization added to the diagonal of the kernel matrix. */
+	double nugget;
+	/**	Minimum quantity of training samples to predict. */
+	int minSamples;
+
+	/**	Parameters of the training samples as columns, used as a ring (nParameters x capacity). */
+	mat inputs;
+	/**	Observations of the training samples as columns, used as a ring (nObservations x capacity). */
+	mat outputs;
+	/**	Quantity of training samples. */
+	int nSamples;
+	/**	Column of the ring where the next sample is stored. */
+	int next;
+	/**	Parameters of the samples added since the last fit. */
+	vector<double> pendingInputs;
+	/**	Observations of the samples added since the last fit. */
+	vector<double> pendingOutputs;
+	/**	Serializes the addition of samples. */
+	mutex pendingMutex;
+
+	/**	If the emulator can predict. */
+	bool fitted;
+	/**	Center of the training parameters. */
+	vec center;
+	/**	Spread of the training parameters. */
+	vec scale;
+	/**	Normalized training parameters as columns. */
+	mat normalizedInputs;
+	/**	Lower Cholesky factor of the kernel matrix. */
+	mat L;
+	/**	Mean of each observation. */
+	vec outputMean;
+	/**	Kernel matrix inverse times the centered observations (nSamples x nObservations). */
+	mat alpha;
+	/**	Amplitude (variance) of each observation. */
+	vec amplitude;
+
+	/**	Sigma points answered by the emulator. */
+	atomic<long long> predictions;
+	/**	Sigma points whose predicted error exceeded the threshold. */
+	atomic<long long> fallbacks;
+
+public:
+	/**
+	 * Creates an empty emulator.
+	 * @param nParameters Quantity of parameters.
+	 * @param nObservations Quantity of observations.
+	 * @param threshold Maximum predicted standard deviation of any observation, in the units of
+	 * the observations, to answer with the emulator.
+	 * @param capacity Maximum quantity of training samples, 0 for 10 times the quantity of
+	 * sigma points of a simplex distribution.
+	 * @param lengthScale Length scale of the kernel in units of the spread of the training parameters.
+	 * @param nugget Regularization added to the diagonal of the kernel matrix.
+	 */
+	SurrogateModel(int nParameters, int nObservations, double threshold, int capacity = 0,
+			double lengthScale = 1, double nugget = 1E-6);
+
+	/**
+	 * Queues a truly evaluated sigma point to be used from the next fit.
+	 * @param theta Kalman parameters.
+	 * @param z Observations.
+	 */
+	void addSample(const double *theta, const double *z);
+	/**
+	 * Refits the emulator with the queued samples, if any.
+	 */
+	void fit();
+	/**
+	 * Predicts the observations of a sigma point if their predicted error is under the threshold.
+	 * @param theta Kalman parameters.
+	 * @param z Array with room for the observations, written if the prediction is accepted.
+	 * @return If the prediction was accepted.
+	 */
+	bool predict(const double *theta, double *z);
+	/**
+	 * Drops the training samples and resets the statistics.
+	 */
+	void clear();
+
+	/**
+	 * Returns the quantity of sigma points answered by the emulator, i.e. the true solves saved.
+	 * @return Saved solves.
+	 */
+	long long getSavedSolves() const;
+	/**
+	 * Returns the quantity of sigma points that fell back to the true operators because of the
+	 * predicted error (the ones evaluated before the emulator could predict are not counted).
+	 * @return Fallbacks.
+	 */
+	long long getFallbacks() const;
+	/**
+	 * Returns the quantity of training samples of the current fit.
+	 * @return Training samples.
+	 */
+	int getSamples() const;
+	/**
+	 * Getter of the field @p minSamples.
+	 * @return Field @p minSamples.
+	 */
+	int getMinSamples() const;
+	/**
+	 * Setter of the field @p minSamples.
+	 * @param minSamples Minimum quantity of training samples to predict.
+	 */
+	void setMinSamples(int minSamples);
+	/**
+	 * Getter of the field @p threshold.
+	 * @return Field @p threshold.
+	 */
+	double getThreshold() const;
+	/**
+	 * Setter of the field @p threshold.
+	 * @param threshold Maximum predicted standard deviation of any observation.
+	 */
+	void setThreshold(double threshold);
+	/**
+	 * Returns the quantity of parameters.
+	 * @return Quantity of parameters.
+	 */
+	int getParameters() const;
+	/**
+	 * Returns the quantity of observations.
+	 * @return Quantity of observations.
+	 */
+	int getObservations() const;
+};
+
+#endif /* SURROGATEMODEL_H_ */
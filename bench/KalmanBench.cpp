@@ -0,0 +1,274 @@
+/*
+ * KalmanBench.cpp
+ *
+ *	Benchmark of the cost of a filter step on synthetic forward problems. Each case reports the
+ *	time per step split into operator time and filter overhead, the memory held by the filter
+ *	and the accuracy of the estimated parameters, one line per case in CSV or JSON lines.
+ *
+ *	Usage:
+ *		kalman_bench [--problems linear,heat,lorenz96] [--filters roukf,mapped,static]
+ *			[--distributions simplex,canonic,star,simplex_star] [--precisions double,single]
+ *			[--states 100,1000] [--parameters 4,16] [--observations 20] [--steps 20]
+ *			[--format csv|json]
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <mpi.h>
+#include <sstream>
+#include <string>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <vector>
+
+#include "../AbstractROUKF.h"
+#include "../MappedROUKF.h"
+#include "../ROUKF.h"
+#include "../StaticROUKF.h"
+#include "SyntheticProblems.h"
+
+using namespace std;
+
+/**	One configuration of the sweep. */
+struct BenchCase {
+	/**	Forward problem. */
+	SyntheticProblems::PROBLEM problem;
+	/**	Filter class: "roukf", "mapped" or "static". */
+	string filter;
+	/**	Sigma points distribution. */
+	SigmaPointsGenerator::SIGMA_DISTRIBUTION distribution;
+	/**	If the mixed precision mode is enabled. */
+	bool singlePrecision;
+	/**	Quantity of states. */
+	int nStates;
+	/**	Quantity of parameters. */
+	int nParameters;
+	/**	Quantity of observations. */
+	int nObservations;
+};
+
+/**	Names of the sigma points distributions, in the order of SIGMA_DISTRIBUTION. */
+static const char *DISTRIBUTIONS[] = { "simplex", "canonic", "star", "simplex_star" };
+
+/**
+ * Splits a comma separated list.
+ * @param list Comma separated list.
+ * @return Items of the list.
+ */
+static vector<string> split(const string &list) {
+	vector<string> items;
+	stringstream stream(list);
+	string item;
+	while (getline(stream, item, ','))
+		if (!item.empty())
+			items.push_back(item);
+	return items;
+}
+
+/**
+ * Returns the resident memory of the process.
+ * @return Resident memory in KiB.
+ */
+static long residentMemory() {
+	long pages = 0, resident = 0;
+	FILE *statm = fopen("/proc/self/statm", "r");
+	if (statm) {
+		if (fscanf(statm, "%ld %ld", &pages, &resident) != 2)
+			resident = 0;
+		fclose(statm);
+	}
+	return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/**
+ * Returns the peak resident memory of the process.
+ * @return Peak resident memory in KiB.
+ */
+static long peakMemory() {
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss;
+}
+
+/**
+ * Creates the filter of a case.
+ * @param benchCase Case to run.
+ * @return New filter, NULL if the filter class is not recognized.
+ */
+static AbstractROUKF *createFilter(const BenchCase &benchCase) {
+	vector<double> observationsUncertainty(benchCase.nObservations, 1E-4);
+	vector<double> parametersUncertainty(benchCase.nParameters, 0.25);
+	if (benchCase.filter == "roukf")
+		return new ROUKF(benchCase.nObservations, benchCase.nStates, benchCase.nParameters,
+				&(observationsUncertainty[0]), &(parametersUncertainty[0]), benchCase.distribution);
+	if (benchCase.filter == "static")
+		return new StaticROUKF(benchCase.nObservations, benchCase.nStates, benchCase.nParameters,
+				&(observationsUncertainty[0]), &(parametersUncertainty[0]), benchCase.distribution);
+	if (benchCase.filter == "mapped") {
+		//	Parameters are estimated in log space, with the uncertainty of the others
+		vector<double> logUncertainty(benchCase.nParameters, 0.1);
+		return new MappedROUKF(benchCase.nObservations, benchCase.nStates, benchCase.nParameters,
+				observationsUncertainty, logUncertainty, benchCase.distribution, MappedROUKF::POSITIVE,
+				vector<double>());
+	}
+	return NULL;
+}
+
+/**
+ * Runs a case and prints its results.
+ * @param benchCase Case to run.
+ * @param nSteps Quantity of filter steps.
+ * @param json If the results are printed as JSON lines instead of CSV.
+ * @return If the case could be run.
+ */
+static bool runCase(const BenchCase &benchCase, int nSteps, bool json) {
+	bool isStatic = benchCase.filter == "static";
+	SyntheticProblems::setup(benchCase.problem, benchCase.nStates, benchCase.nParameters, isStatic);
+
+	long memoryBefore = residentMemory();
+	AbstractROUKF *filter = createFilter(benchCase);
+	if (!filter) {
+		cerr << "Unrecognized filter " << benchCase.filter << "." << endl;
+		return false;
+	}
+	vector<double> theta = SyntheticProblems::initialParameters();
+	filter->setParameters(&(theta[0]));
+	vector<double> xt(benchCase.nStates);
+	SyntheticProblems::initialCondition(&(xt[0]));
+	if (!isStatic)
+		filter->setState(&(xt[0]));
+	filter->setSinglePrecision(benchCase.singlePrecision);
+
+	vector<double> trueTheta = SyntheticProblems::trueParameters();
+	vector<double> zt(benchCase.nObservations);
+	double stepTime = 0, operatorTime = 0, error = 0;
+	int steps = 0;
+	bool diverged = false;
+	for (; steps < nSteps; ++steps) {
+		//	Observations of the true model
+		SyntheticProblems::forward(&(xt[0]), benchCase.nStates, &(trueTheta[0]), benchCase.nParameters);
+		SyntheticProblems::observe(&(xt[0]), benchCase.nStates, &(zt[0]), benchCase.nObservations);
+
+		SyntheticProblems::resetOperatorTime();
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		error = filter->executeStep(&(zt[0]), &SyntheticProblems::forward, &SyntheticProblems::observe);
+		stepTime += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+		operatorTime += SyntheticProblems::getOperatorTime();
+		if (error < 0 || std::isnan(error)) {
+			diverged = true;
+			break;
+		}
+	}
+	long memory = residentMemory() - memoryBefore;
+
+	filter->copyParameters(&(theta[0]));
+	double parametersError = 0;
+	for (int j = 0; j < benchCase.nParameters; ++j)
+		parametersError += (theta[j] - trueTheta[j]) * (theta[j] - trueTheta[j]);
+	parametersError = sqrt(parametersError / benchCase.nParameters);
+	int nSigma = filter->getSigmaPoints();
+	delete filter;
+
+	//	Times per step in microseconds
+	double scale = steps > 0 ? 1E6 / steps : 0;
+	const char *status = diverged ? "diverged" : "ok";
+	const char *precision = benchCase.singlePrecision ? "single" : "double";
+	string problem = SyntheticProblems::getName(benchCase.problem);
+	if (json)
+		printf("{\"problem\": \"%s\", \"filter\": \"%s\", \"distribution\": \"%s\", \"precision\": \"%s\", "
+				"\"states\": %d, \"parameters\": %d, \"observations\": %d, \"sigma_points\": %d, \"steps\": %d, "
+				"\"step_us\": %.3f, \"operator_us\": %.3f, \"overhead_us\": %.3f, \"memory_kb\": %ld, "
+				"\"peak_memory_kb\": %ld, \"error\": %.10g, \"parameters_error\": %.10g, \"status\": \"%s\"}\n",
+				problem.c_str(), benchCase.filter.c_str(), DISTRIBUTIONS[benchCase.distribution], precision,
+				benchCase.nStates, benchCase.nParameters, benchCase.nObservations, nSigma, steps,
+				stepTime * scale, operatorTime * scale, (stepTime - operatorTime) * scale, memory,
+				peakMemory(), error, parametersError, status);
+	else
+		printf("%s,%s,%s,%s,%d,%d,%d,%d,%d,%.3f,%.3f,%.3f,%ld,%ld,%.10g,%.10g,%s\n",
+				problem.c_str(), benchCase.filter.c_str(), DISTRIBUTIONS[benchCase.distribution], precision,
+				benchCase.nStates, benchCase.nParameters, benchCase.nObservations, nSigma, steps,
+				stepTime * scale, operatorTime * scale, (stepTime - operatorTime) * scale, memory,
+				peakMemory(), error, parametersError, status);
+	fflush(stdout);
+	return true;
+}
+
+int main(int argc, char *argv[]) {
+	MPI_Init(&argc, &argv);
+
+	string problems = "linear,heat,lorenz96", filters = "roukf,mapped,static";
+	string distributions = "simplex,canonic,star,simplex_star", precisions = "double";
+	string states = "100,1000", parameters = "4,16", observations = "20";
+	int nSteps = 20;
+	bool json = false;
+	for (int i = 1; i + 1 < argc; i += 2) {
+		string option = argv[i], value = argv[i + 1];
+		if (option == "--problems")
+			problems = value;
+		else if (option == "--filters")
+			filters = value;
+		else if (option == "--distributions")
+			distributions = value;
+		else if (option == "--precisions")
+			precisions = value;
+		else if (option == "--states")
+			states = value;
+		else if (option == "--parameters")
+			parameters = value;
+		else if (option == "--observations")
+			observations = value;
+		else if (option == "--steps")
+			nSteps = atoi(value.c_str());
+		else if (option == "--format")
+			json = value == "json";
+		else
+			cerr << "Unrecognized option " << option << "." << endl;
+	}
+
+	if (!json)
+		printf("problem,filter,distribution,precision,states,parameters,observations,sigma_points,steps,"
+				"step_us,operator_us,overhead_us,memory_kb,peak_memory_kb,error,parameters_error,status\n");
+
+	BenchCase benchCase;
+	for (const string &problem : split(problems)) {
+		if (!SyntheticProblems::parse(problem, &benchCase.problem)) {
+			cerr << "Unrecognized problem " << problem << "." << endl;
+			continue;
+		}
+		for (const string &filter : split(filters))
+			for (const string &distribution : split(distributions)) {
+				int d = 0;
+				while (d < 4 && distribution != DISTRIBUTIONS[d])
+					++d;
+				if (d == 4) {
+					cerr << "Unrecognized distribution " << distribution << "." << endl;
+					continue;
+				}
+				for (const string &precision : split(precisions))
+					for (const string &nStates : split(states))
+						for (const string &nParameters : split(parameters))
+							for (const string &nObservations : split(observations)) {
+								benchCase.filter = filter;
+								benchCase.distribution = (SigmaPointsGenerator::SIGMA_DISTRIBUTION) d;
+								benchCase.singlePrecision = precision == "single";
+								benchCase.nStates = atoi(nStates.c_str());
+								benchCase.nParameters = atoi(nParameters.c_str());
+								benchCase.nObservations = atoi(nObservations.c_str());
+								if (benchCase.nStates < 4 || benchCase.nParameters < 1
+										|| benchCase.nObservations < 1) {
+									cerr << "Cases need at least 4 states, 1 parameter and 1 observation." << endl;
+									continue;
+								}
+								runCase(benchCase, nSteps, json);
+							}
+			}
+	}
+
+	MPI_Finalize();
+	return 0;
+}
@@ -0,0 +1,151 @@
+/*
+ * SyntheticProblems.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "SyntheticProblems.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+/**	Time steps integrated by the forward operator when it starts from the initial condition. */
+static const int WINDOW_STEPS = 10;
+/**	Time step of the Lorenz-96 integrator. */
+static const double LORENZ_DT = 0.005;
+
+SyntheticProblems::PROBLEM SyntheticProblems::problem = SyntheticProblems::LINEAR;
+int SyntheticProblems::nStates = 0;
+int SyntheticProblems::nParameters = 0;
+bool SyntheticProblems::fromInitialCondition = false;
+double SyntheticProblems::operatorTime = 0;
+vector<double> SyntheticProblems::scratch;
+
+void SyntheticProblems::setup(PROBLEM problem, int nStates, int nParameters, bool fromInitialCondition) {
+	SyntheticProblems::problem = problem;
+	SyntheticProblems::nStates = nStates;
+	SyntheticProblems::nParameters = nParameters;
+	SyntheticProblems::fromInitialCondition = fromInitialCondition;
+	scratch.assign(5 * nStates, 0.);
+}
+
+int SyntheticProblems::forward(double *x, int, double *theta, int) {
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	if (fromInitialCondition) {
+		initialCondition(x);
+		for (int step = 0; step < WINDOW_STEPS; ++step)
+			advance(x, theta);
+	} else
+		advance(x, theta);
+	operatorTime += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	return 0;
+}
+
+void SyntheticProblems::observe(double *x, int nStates, double *z, int nObservations) {
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (int j = 0; j < nObservations; ++j)
+		z[j] = x[(long long) j * nStates / nObservations];
+	operatorTime += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+void SyntheticProblems::advance(double *x, const double *theta) {
+	switch (problem) {
+	case LINEAR:
+		//	Each state relaxes towards its parameter
+		for (int i = 0; i < nStates; ++i)
+			x[i] = 0.9 * x[i] + 0.1 * theta[parameterOf(i)];
+		break;
+	case HEAT: {
+		//	Explicit finite differences with a heat source and zero boundaries, the diffusion
+		//	number is kept below 0.2 for any parameter.
+		double *previous = &(scratch[0]);
+		for (int substep = 0; substep < 4; ++substep) {
+			memcpy(previous, x, nStates * sizeof(double));
+			for (int i = 0; i < nStates; ++i) {
+				double kappa = fabs(theta[parameterOf(i)]);
+				double left = i > 0 ? previous[i - 1] : 0.;
+				double right = i < nStates - 1 ? previous[i + 1] : 0.;
+				x[i] = previous[i] + 0.2 * kappa / (1. + kappa) * (left - 2. * previous[i] + right) + 0.01;
+			}
+		}
+		break;
+	}
+	case LORENZ96: {
+		//	Classic fourth order Runge-Kutta
+		double *k1 = &(scratch[0]), *k2 = k1 + nStates, *k3 = k2 + nStates, *k4 = k3 + nStates;
+		double *y = k4 + nStates;
+		lorenz96(x, theta, k1);
+		for (int i = 0; i < nStates; ++i)
+			y[i] = x[i] + 0.5 * LORENZ_DT * k1[i];
+		lorenz96(y, theta, k2);
+		for (int i = 0; i < nStates; ++i)
+			y[i] = x[i] + 0.5 * LORENZ_DT * k2[i];
+		lorenz96(y, theta, k3);
+		for (int i = 0; i < nStates; ++i)
+			y[i] = x[i] + LORENZ_DT * k3[i];
+		lorenz96(y, theta, k4);
+		for (int i = 0; i < nStates; ++i)
+			x[i] += LORENZ_DT / 6. * (k1[i] + 2. * k2[i] + 2. * k3[i] + k4[i]);
+		break;
+	}
+	}
+}
+
+void SyntheticProblems::lorenz96(const double *x, const double *theta, double *dx) {
+	for (int i = 0; i < nStates; ++i) {
+		double next = x[(i + 1) % nStates];
+		double previous = x[(i + nStates - 1) % nStates];
+		double previous2 = x[(i + nStates - 2) % nStates];
+		dx[i] = (next - previous2) * previous - x[i] + theta[parameterOf(i)];
+	}
+}
+
+int SyntheticProblems::parameterOf(int i) {
+	return (long long) i * nParameters / nStates;
+}
+
+void SyntheticProblems::initialCondition(double *x) {
+	for (int i = 0; i < nStates; ++i)
+		x[i] = problem == LORENZ96 ? 8. + (i == 0 ? 0.01 : 0.) : 0.;
+}
+
+vector<double> SyntheticProblems::trueParameters() {
+	vector<double> theta(nParameters);
+	for (int j = 0; j < nParameters; ++j)
+		theta[j] = (problem == LORENZ96 ? 8. : 1.) + 0.5 * sin(j + 1.);
+	return theta;
+}
+
+vector<double> SyntheticProblems::initialParameters() {
+	return vector<double>(nParameters, problem == LORENZ96 ? 8. : 1.);
+}
+
+double SyntheticProblems::getOperatorTime() {
+	return operatorTime;
+}
+
+void SyntheticProblems::resetOperatorTime() {
+	operatorTime = 0;
+}
+
+bool SyntheticProblems::parse(const string &name, PROBLEM *problem) {
+	for (int p = LINEAR; p <= LORENZ96; ++p)
+		if (name == getName((PROBLEM) p)) {
+			*problem = (PROBLEM) p;
+			return true;
+		}
+	return false;
+}
+
+string SyntheticProblems::getName(PROBLEM problem) {
+	switch (problem) {
+	case LINEAR:
+		return "linear";
+	case HEAT:
+		return "heat";
+	case LORENZ96:
+		return "lorenz96";
+	}
+	return "";
+}
@@ -0,0 +1,128 @@
+/*
+ * SyntheticProblems.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef SYNTHETICPROBLEMS_H_
+#define SYNTHETICPROBLEMS_H_
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Static class with synthetic forward and observation operators used to benchmark the filters.
+ * The parameters are spread over the states, parameter j driving a contiguous range of states.
+ * The operators accumulate the time they spend, so that the cost of a step can be split into
+ * operator time and filter overhead. They are not reentrant.
+ */
+class SyntheticProblems {
+public:
+	/**	Enumeration for the synthetic forward problems. */
+	enum PROBLEM {LINEAR, HEAT, LORENZ96};
+
+	/**
+	 * Sets the problem evaluated by the operators.
+	 * @param problem Forward problem.
+	 * @param nStates Quantity of states.
+	 * @param nParameters Quantity of parameters.
+	 * @param fromInitialCondition If the forward operator restarts from the initial condition
+	 * and integrates a whole time window at each call, as needed by StaticROUKF.
+	 */
+	static void setup(PROBLEM problem, int nStates, int nParameters, bool fromInitialCondition);
+	/**
+	 * Forward operator of the current problem (forwardOp).
+	 * @param x States, advanced in place.
+	 * @param nStates Quantity of states.
+	 * @param theta Parameters.
+	 * @param nParameters Quantity of parameters.
+	 * @return 0.
+	 */
+	static int forward(double *x, int nStates, double *theta, int nParameters);
+	/**
+	 * Observation operator (observationOp), samples @p nObservations equispaced states.
+	 * @param x States.
+	 * @param nStates Quantity of states.
+	 * @param z Observations.
+	 * @param nObservations Quantity of observations.
+	 */
+	static void observe(double *x, int nStates, double *z, int nObservations);
+
+	/**
+	 * Fills the initial condition of the current problem.
+	 * @param x Array with room for the states.
+	 */
+	static void initialCondition(double *x);
+	/**
+	 * Returns the parameters used to generate the observations.
+	 * @return True parameters.
+	 */
+	static vector<double> trueParameters();
+	/**
+	 * Returns the first guess of the parameters given to the filters.
+	 * @return Initial parameters.
+	 */
+	static vector<double> initialParameters();
+
+	/**
+	 * Returns the time spent in the operators since the last reset.
+	 * @return Time in seconds.
+	 */
+	static double getOperatorTime();
+	/**
+	 * Resets the time spent in the operators.
+	 */
+	static void resetOperatorTime();
+
+	/**
+	 * Parses a problem name.
+	 * @param name "linear", "heat" or "lorenz96".
+	 * @param problem Parsed problem.
+	 * @return If the name was recognized.
+	 */
+	static bool parse(const string &name, PROBLEM *problem);
+	/**
+	 * Returns the name of a problem.
+	 * @param problem Forward problem.
+	 * @return Name of @p problem.
+	 */
+	static string getName(PROBLEM problem);
+
+private:
+	/**	Current problem. */
+	static PROBLEM problem;
+	/**	Quantity of states of the current problem. */
+	static int nStates;
+	/**	Quantity of parameters of the current problem. */
+	static int nParameters;
+	/**	If the forward operator integrates a whole window from the initial condition. */
+	static bool fromInitialCondition;
+	/**	Time spent in the operators. */
+	static double operatorTime;
+	/**	Scratch states of the integrators. */
+	static vector<double> scratch;
+
+	/**
+	 * Advances the states one time step.
+	 * @param x States, advanced in place.
+	 * @param theta Parameters.
+	 */
+	static void advance(double *x, const double *theta);
+	/**
+	 * Right hand side of Lorenz-96 with the forcing of each state given by the parameters.
+	 * @param x States.
+	 * @param theta Parameters.
+	 * @param dx Time derivative of the states.
+	 */
+	static void lorenz96(const double *x, const double *theta, double *dx);
+	/**
+	 * Returns the parameter that drives the state @p i .
+	 * @param i Index of the state.
+	 * @return Index of the parameter.
+	 */
+	static int parameterOf(int i);
+};
+
+#endif /* SYNTHETICPROBLEMS_H_ */
@@ -28,8 +28,12 @@ fi
 sudo mkdir /usr/local/include/kalman
 sudo mkdir /usr/local/include/kalman/mapping
 sudo mkdir /usr/local/include/kalman/io
+sudo mkdir /usr/local/include/kalman/observation
+sudo mkdir /usr/local/include/kalman/parallel
 
 sudo ln -sf ${PWD}/*.h /usr/local/include/kalman
 sudo ln -sf ${PWD}/mapping/*.h /usr/local/include/kalman/mapping
 sudo ln -sf ${PWD}/io/*.h /usr/local/include/kalman/io
+sudo ln -sf ${PWD}/observation/*.h /usr/local/include/kalman/observation
+sudo ln -sf ${PWD}/parallel/*.h /usr/local/include/kalman/parallel
 sudo ldconfig
@@ -0,0 +1,241 @@
+/*
+ * Checkpoint.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "Checkpoint.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**	File signature. */
+static const char MAGIC[8] = {'R', 'O', 'U', 'K', 'F', 'C', 'K', '\0'};
+/**	Version of the file format. */
+static const uint64_t VERSION = 1;
+
+/**	Header of the file. */
+struct FileHeader {
+	char magic[8];
+	uint64_t version;
+	uint64_t nEntries;
+};
+
+/**	Descriptor of an entry in the file, followed by rows * cols doubles. */
+struct FileEntry {
+	char name[Checkpoint::NAME_LENGTH];
+	uint64_t rows;
+	uint64_t cols;
+};
+
+Checkpoint::Checkpoint() {
+	mapping = NULL;
+	mappingSize = 0;
+	writable = false;
+}
+
+Checkpoint::~Checkpoint() {
+	close();
+}
+
+void Checkpoint::add(const string &name, const arma::mat &m, const vector<char> *columns) {
+	Entry entry = { name, m.memptr(), NULL, m.n_rows, m.n_cols, columns };
+	entries.push_back(entry);
+}
+
+void Checkpoint::add(const string &name, const arma::fmat &m) {
+	Entry entry = { name, NULL, m.memptr(), m.n_rows, m.n_cols, NULL };
+	entries.push_back(entry);
+}
+
+void Checkpoint::add(const string &name, const vector<double> &v) {
+	vectors.push_back(v);
+	const vector<double> &copy = vectors.back();
+	Entry entry = { name, copy.empty() ? NULL : &(copy[0]), NULL, copy.size(), 1, NULL };
+	entries.push_back(entry);
+}
+
+bool Checkpoint::write(const string &filename) const {
+	string tmpFilename = filename + ".tmp";
+	FILE *file = fopen(tmpFilename.c_str(), "wb");
+	if (!file) {
+		cerr << "Unable to write checkpoint " << tmpFilename << "." << endl;
+		return false;
+	}
+
+	FileHeader header;
+	memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = VERSION;
+	header.nEntries = entries.size();
+	bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+	vector<double> zeros;
+	for (vector<Entry>::const_iterator it = entries.begin(); ok && it != entries.end(); ++it) {
+		FileEntry fileEntry;
+		memset(&fileEntry, 0, sizeof(fileEntry));
+		strncpy(fileEntry.name, it->name.c_str(), NAME_LENGTH - 1);
+		fileEntry.rows = it->rows;
+		fileEntry.cols = it->cols;
+		ok = fwrite(&fileEntry, sizeof(fileEntry), 1, file) == 1;
+
+		if (it->singleData) {
+			//	Converted a column at a time
+			zeros.resize(it->rows);
+			for (uint64_t j = 0; ok && j < it->cols; ++j) {
+				const float *column = it->singleData + j * it->rows;
+				for (uint64_t k = 0; k < it->rows; ++k)
+					zeros[k] = column[k];
+				ok = fwrite(&(zeros[0]), sizeof(double), it->rows, file) == it->rows;
+			}
+			continue;
+		}
+		if (!it->columns) {
+			size_t n = it->rows * it->cols;
+			ok = ok && fwrite(it->data, sizeof(double), n, file) == n;
+			continue;
+		}
+		zeros.assign(it->rows, 0.);
+		for (uint64_t j = 0; ok && j < it->cols; ++j) {
+			const double *column = (*it->columns)[j] ? it->data + j * it->rows : &(zeros[0]);
+			ok = fwrite(column, sizeof(double), it->rows, file) == it->rows;
+		}
+	}
+
+	ok = (fclose(file) == 0) && ok;
+	if (ok)
+		ok = rename(tmpFilename.c_str(), filename.c_str()) == 0;
+	if (!ok)
+		cerr << "Error while writing checkpoint " << filename << "." << endl;
+	return ok;
+}
+
+bool Checkpoint::open(const string &filename, bool writable) {
+	close();
+
+	int fd = ::open(filename.c_str(), writable ? O_RDWR : O_RDONLY);
+	if (fd < 0) {
+		cerr << "Unable to open checkpoint " << filename << "." << endl;
+		return false;
+	}
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0 || fileStat.st_size < (off_t) sizeof(FileHeader)) {
+		cerr << "Checkpoint " << filename << " is truncated." << endl;
+		::close(fd);
+		return false;
+	}
+	mappingSize = fileStat.st_size;
+	void *address = mmap(NULL, mappingSize, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (address == MAP_FAILED) {
+		cerr << "Unable to map checkpoint " << filename << "." << endl;
+		mappingSize = 0;
+		return false;
+	}
+	mapping = (char *) address;
+	this->writable = writable;
+
+	const FileHeader *header = (const FileHeader *) mapping;
+	if (memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION) {
+		cerr << "File " << filename << " is not a valid checkpoint." << endl;
+		close();
+		return false;
+	}
+
+	size_t offset = sizeof(FileHeader);
+	for (uint64_t i = 0; i < header->nEntries; ++i) {
+		if (offset + sizeof(FileEntry) > mappingSize) {
+			cerr << "Checkpoint " << filename << " is truncated." << endl;
+			close();
+			return false;
+		}
+		const FileEntry *fileEntry = (const FileEntry *) (mapping + offset);
+		offset += sizeof(FileEntry);
+		size_t bytes = fileEntry->rows * fileEntry->cols * sizeof(double);
+		if (offset + bytes > mappingSize) {
+			cerr << "Checkpoint " << filename << " is truncated." << endl;
+			close();
+			return false;
+		}
+		Entry entry = { string(fileEntry->name, strnlen(fileEntry->name, NAME_LENGTH)),
+				(const double *) (mapping + offset), NULL, fileEntry->rows, fileEntry->cols, NULL };
+		mappedEntries.push_back(entry);
+		offset += bytes;
+	}
+	return true;
+}
+
+void Checkpoint::close() {
+	if (mapping)
+		munmap(mapping, mappingSize);
+	mapping = NULL;
+	mappingSize = 0;
+	writable = false;
+	mappedEntries.clear();
+}
+
+bool Checkpoint::has(const string &name) const {
+	uint64_t rows, cols;
+	return find(name, &rows, &cols) != NULL;
+}
+
+const double *Checkpoint::find(const string &name, uint64_t *rows, uint64_t *cols) const {
+	for (vector<Entry>::const_iterator it = mappedEntries.begin(); it != mappedEntries.end(); ++it)
+		if (it->name == name) {
+			*rows = it->rows;
+			*cols = it->cols;
+			return it->data;
+		}
+	return NULL;
+}
+
+double *Checkpoint::update(const string &name, uint64_t *rows, uint64_t *cols) {
+	//	The mapping is shared, hence the values are written to the file by the operating system
+	return writable ? (double *) find(name, rows, cols) : NULL;
+}
+
+bool Checkpoint::read(const string &name, arma::mat &m) const {
+	uint64_t rows, cols;
+	const double *data = find(name, &rows, &cols);
+	if (!data)
+		return false;
+	m.set_size(rows, cols);
+	memcpy(m.memptr(), data, rows * cols * sizeof(double));
+	return true;
+}
+
+bool Checkpoint::read(const string &name, arma::fmat &m) const {
+	uint64_t rows, cols;
+	const double *data = find(name, &rows, &cols);
+	if (!data)
+		return false;
+	m.set_size(rows, cols);
+	float *values = m.memptr();
+	for (uint64_t j = 0; j < rows * cols; ++j)
+		values[j] = data[j];
+	return true;
+}
+
+bool Checkpoint::read(const string &name, vector<double> &v) const {
+	uint64_t rows, cols;
+	const double *data = find(name, &rows, &cols);
+	if (!data)
+		return false;
+	v.assign(data, data + rows * cols);
+	return true;
+}
+
+bool Checkpoint::readColumns(const string &name, arma::mat &m, const vector<char> &columns) const {
+	uint64_t rows, cols;
+	const double *data = find(name, &rows, &cols);
+	if (!data || rows != m.n_rows || cols != m.n_cols)
+		return false;
+	for (uint64_t j = 0; j < cols; ++j)
+		if (columns[j])
+			memcpy(m.colptr(j), data + j * rows, rows * sizeof(double));
+	return true;
+}
@@ -0,0 +1,166 @@
+/*
+ * Checkpoint.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef CHECKPOINT_H_
+#define CHECKPOINT_H_
+
+#include <armadillo>
+#include <list>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Binary file with named dense matrices, used to save and restore the state of a Kalman filter.
+ * The file is a header followed by the entries, each one a fixed size descriptor and its values
+ * in column-major order, all of them aligned to 8 bytes. Files are read through a read-only
+ * shared memory mapping, so that many processes restarting from the same checkpoint share the
+ * pages of the operating system cache instead of parsing the file.
+ */
+class Checkpoint {
+public:
+	/**	Maximum length of an entry name (including the null character). */
+	static const int NAME_LENGTH = 16;
+
+private:
+	/**	Descriptor of a matrix to be written. */
+	struct Entry {
+		/**	Name of the entry. */
+		string name;
+		/**	Values of the matrix. */
+		const double *data;
+		/**	Values of a single precision matrix, converted to double when written. NULL if @p data is used. */
+		const float *singleData;
+		/**	Rows of the matrix. */
+		uint64_t rows;
+		/**	Columns of the matrix. */
+		uint64_t cols;
+		/**	Columns that are written, the others are written as zeros. NULL for all columns. */
+		const vector<char> *columns;
+	};
+
+	/**	Matrices added to be written. */
+	vector<Entry> entries;
+	/**	Copies of the vectors added to be written. */
+	list<vector<double> > vectors;
+
+	/**	Start of the memory mapping of the opened file, NULL if no file is opened. */
+	char *mapping;
+	/**	Size of the memory mapping. */
+	size_t mappingSize;
+	/**	If the opened file is mapped read-write. */
+	bool writable;
+	/**	Descriptors of the entries of the opened file. Data points into @p mapping . */
+	vector<Entry> mappedEntries;
+
+public:
+	/**
+	 * Creates an empty checkpoint.
+	 */
+	Checkpoint();
+	/**
+	 * Closes the opened file.
+	 */
+	~Checkpoint();
+
+	/**
+	 * Adds a matrix to be written. The matrix is not copied, so it must be valid until write.
+	 * @param name Name of the entry (shorter than NAME_LENGTH).
+	 * @param m Matrix.
+	 * @param columns If not NULL, only the columns flagged in it are written, the others are zeros.
+	 */
+	void add(const string &name, const arma::mat &m, const vector<char> *columns = NULL);
+	/**
+	 * Adds a single precision matrix to be written in double precision. The matrix is not copied,
+	 * so it must be valid until write.
+	 * @param name Name of the entry (shorter than NAME_LENGTH).
+	 * @param m Matrix.
+	 */
+	void add(const string &name, const arma::fmat &m);
+	/**
+	 * Adds a copy of a vector of values to be written as a column.
+	 * @param name Name of the entry (shorter than NAME_LENGTH).
+	 * @param v Values.
+	 */
+	void add(const string &name, const vector<double> &v);
+	/**
+	 * Writes all added matrices. The file is first written with the ".tmp" suffix and then
+	 * renamed, hence an interrupted write never corrupts a previous checkpoint.
+	 * @param filename Path of the checkpoint.
+	 * @return If the file was written.
+	 */
+	bool write(const string &filename) const;
+
+	/**
+	 * Maps a checkpoint file in memory.
+	 * @param filename Path of the checkpoint.
+	 * @param writable If the file is mapped read-write, so that its values can be updated in
+	 * place through update. Otherwise it is mapped read-only.
+	 * @return If the file could be opened and has a valid format.
+	 */
+	bool open(const string &filename, bool writable = false);
+	/**
+	 * Unmaps the opened file.
+	 */
+	void close();
+	/**
+	 * Returns if the opened file has the entry @p name .
+	 * @param name Name of the entry.
+	 * @return If the entry exists.
+	 */
+	bool has(const string &name) const;
+	/**
+	 * Returns the values of an entry of the opened file, without copying them.
+	 * @param name Name of the entry.
+	 * @param rows Returns the rows of the entry.
+	 * @param cols Returns the columns of the entry.
+	 * @return Read-only values of the entry, or NULL if it does not exist.
+	 */
+	const double *find(const string &name, uint64_t *rows, uint64_t *cols) const;
+	/**
+	 * Returns the values of an entry of a file opened read-write, so that they are updated in
+	 * the file without rewriting it.
+	 * @param name Name of the entry.
+	 * @param rows Returns the rows of the entry.
+	 * @param cols Returns the columns of the entry.
+	 * @return Values of the entry, or NULL if it does not exist or the file is read-only.
+	 */
+	double *update(const string &name, uint64_t *rows, uint64_t *cols);
+	/**
+	 * Copies an entry of the opened file into @p m , resizing it.
+	 * @param name Name of the entry.
+	 * @param m Destination matrix.
+	 * @return If the entry exists.
+	 */
+	bool read(const string &name, arma::mat &m) const;
+	/**
+	 * Copies an entry of the opened file into the single precision matrix @p m , resizing it.
+	 * @param name Name of the entry.
+	 * @param m Destination matrix.
+	 * @return If the entry exists.
+	 */
+	bool read(const string &name, arma::fmat &m) const;
+	/**
+	 * Copies an entry of the opened file into @p v , resizing it.
+	 * @param name Name of the entry.
+	 * @param v Destination vector.
+	 * @return If the entry exists.
+	 */
+	bool read(const string &name, vector<double> &v) const;
+	/**
+	 * Copies the flagged columns of an entry of the opened file into @p m , that must already
+	 * have the size of the entry.
+	 * @param name Name of the entry.
+	 * @param m Destination matrix.
+	 * @param columns Columns to be copied.
+	 * @return If the entry exists with the size of @p m .
+	 */
+	bool readColumns(const string &name, arma::mat &m, const vector<char> &columns) const;
+};
+
+#endif /* CHECKPOINT_H_ */
@@ -7,6 +7,7 @@
 
 #include "ConfigurationFileReader.h"
 
+#include "../BatchROUKF.h"
 #include "../MappedROUKF.h"
 #include "../ROUKF.h"
 
@@ -21,12 +22,71 @@
 
 using namespace libconfig;
 
+/**
+ * Reads the mappers of the parameters of the filters.
+ * @param config Configuration file.
+ * @return Composite of the mappers in the ParameterMapping list.
+ */
+static CompositeParameterMapper *readParameterMapping(const Config &config) {
+	vector<AbstractParameterMapper *> parameterMapping;
+	vector<int> parametersPerMapping;
+	try {
+		Setting& mapperList = config.lookup("ParameterMapping");
+		for (int i = 0; i < mapperList.getLength(); ++i) {
+			int mapType = (int) mapperList[i]["type"];
+			switch (mapType) {
+			case ConfigurationFileReader::IDENTITY:
+				parametersPerMapping.push_back(mapperList[i]["numParam"]);
+				parameterMapping.push_back(new IdentityParameterMapper());
+				break;
+			case ConfigurationFileReader::EXPONENTIAL:
+				parametersPerMapping.push_back((int) mapperList[i]["numParam"]);
+				parameterMapping.push_back(new ExponentialParameterMapper());
+				break;
+			case ConfigurationFileReader::SIGMOIDAL:
+				parametersPerMapping.push_back(mapperList[i]["numParam"]);
+				parameterMapping.push_back(new SigmoidParameterMapper((double) (mapperList[i]["min"]), (double) (mapperList[i]["max"])));
+				break;
+			default:
+				parametersPerMapping.push_back(mapperList[i]["numParam"]);
+				parameterMapping.push_back(new IdentityParameterMapper());
+				break;
+			}
+		}
+	} catch (const SettingNotFoundException &nfex) {
+		cerr << "Error while reading ParameterMapping fields." << endl;
+	}
+
+	return new CompositeParameterMapper(parametersPerMapping, parameterMapping);
+}
+
+/**
+ * Reads a list of doubles of a problem of a batch, or of the whole file if the problem does not
+ * define it.
+ * @param problem Problem of the batch.
+ * @param config Configuration file.
+ * @param name Name of the list.
+ * @param values Values of the list.
+ * @return If the list was found.
+ */
+static bool readProblemVector(const Setting &problem, const Config &config, const char *name,
+		vector<double> *values) {
+	if (!problem.exists(name) && !config.exists(name))
+		return false;
+	const Setting &list = problem.exists(name) ? problem[name] : config.lookup(name);
+	values->clear();
+	for (int i = 0; i < list.getLength(); ++i)
+		values->push_back((double) list[i]);
+	return true;
+}
+
 ConfigurationFileReader::ConfigurationFileReader(string filename) {
 	this->filename = filename;
 	this->nStates = 0;
 	this->nParameters = 0;
 	this->nObservations = 0;
 	this->roukfModel = NULL;
+	this->batchModel = NULL;
 }
 
 AbstractROUKF* ConfigurationFileReader::getInstance() {
@@ -75,35 +135,6 @@ AbstractROUKF* ConfigurationFileReader::getInstance() {
 		cerr << "Error while reading InitialGuess or ParameterUncertainty fields." << endl;
 	}
 
-	vector<AbstractParameterMapper *> parameterMapping;
-	vector<int> parametersPerMapping;
-	try {
-		Setting& mapperList = config.lookup("ParameterMapping");
-		for (int i = 0; i < mapperList.getLength(); ++i) {
-			int mapType = (int) mapperList[i]["type"];
-			switch (mapType) {
-			case IDENTITY:
-				parametersPerMapping.push_back(mapperList[i]["numParam"]);
-				parameterMapping.push_back(new IdentityParameterMapper());
-				break;
-			case EXPONENTIAL:
-				parametersPerMapping.push_back((int) mapperList[i]["numParam"]);
-				parameterMapping.push_back(new ExponentialParameterMapper());
-				break;
-			case SIGMOIDAL:
-				parametersPerMapping.push_back(mapperList[i]["numParam"]);
-				parameterMapping.push_back(new SigmoidParameterMapper((double) (mapperList[i]["min"]), (double) (mapperList[i]["max"])));
-				break;
-			default:
-				parametersPerMapping.push_back(mapperList[i]["numParam"]);
-				parameterMapping.push_back(new IdentityParameterMapper());
-				break;
-			}
-		}
-	} catch (const SettingNotFoundException &nfex) {
-		cerr << "Error while reading ParameterMapping fields." << endl;
-	}
-
 	vector<double> observationsUncertainty;
 	try {
 		Setting& sVectorDoubles = config.lookup("ObservationsValues");
@@ -149,7 +180,7 @@ AbstractROUKF* ConfigurationFileReader::getInstance() {
 	case MODEL_MAPPED_ROUKF:
 		roukfModel = new MappedROUKF(nObservations, nStates, nParameters,
 				observationsUncertainty, parameterUncertainty, sigmaDistribution,
-				new CompositeParameterMapper(parametersPerMapping, parameterMapping));
+				readParameterMapping(config));
 		break;
 	default:
 		roukfModel = new ROUKF(nObservations, nStates, nParameters,
@@ -183,3 +214,86 @@ int ConfigurationFileReader::getNObservations() const
 {
 	return nObservations;
 }
+
+BatchROUKF *ConfigurationFileReader::getBatch() {
+
+	if (batchModel)
+		return batchModel;
+
+	Config config;
+
+	try {
+		config.readFile(filename.c_str());
+	} catch (const FileIOException &fioex) {
+		std::cerr << "I/O error while reading configuration file for ROUKF." << std::endl;
+		return NULL;
+	} catch (const ParseException &pex) {
+		std::cerr << "Parse error at " << pex.getFile() << ":" << pex.getLine()
+				<< " - " << pex.getError() << std::endl;
+		return NULL;
+	}
+
+	int typeROUKF = MODEL_ROUKF;
+	config.lookupValue("FilterType", typeROUKF);
+	if (!config.lookupValue("States", nStates) || !config.lookupValue("Parameters", nParameters)
+			|| !config.lookupValue("Observations", nObservations)) {
+		cerr << "States, Parameters or Observations number is missing." << endl;
+		return NULL;
+	}
+	if (!config.exists("Problems")) {
+		cerr << "The batch needs the list of Problems." << endl;
+		return NULL;
+	}
+
+	//	Fields of each problem, or of the whole file when the problem does not define them
+	Setting &problems = config.lookup("Problems");
+	int nFilters = problems.getLength();
+	vector<double> initialGuess, parameterUncertainty, observationsValues, observationsUncertainty;
+	vector<double> initialGuesses, parametersUncertainty, allObservationsUncertainty;
+	batchObservations.clear();
+	for (int f = 0; f < nFilters; ++f) {
+		if (!readProblemVector(problems[f], config, "InitialGuess", &initialGuess)
+				|| !readProblemVector(problems[f], config, "ParameterUncertainty", &parameterUncertainty)
+				|| !readProblemVector(problems[f], config, "ObservationsValues", &observationsValues)
+				|| !readProblemVector(problems[f], config, "ObservationsUncertainty", &observationsUncertainty)) {
+			cerr << "Error while reading the InitialGuess, ParameterUncertainty, ObservationsValues or "
+					"ObservationsUncertainty fields of the problem " << f << "." << endl;
+			return NULL;
+		}
+		if ((int) initialGuess.size() != nParameters || (int) parameterUncertainty.size() != nParameters
+				|| (int) observationsValues.size() != nObservations
+				|| (int) observationsUncertainty.size() != nObservations) {
+			cerr << "The fields of the problem " << f << " do not match the Parameters and Observations numbers." << endl;
+			return NULL;
+		}
+		initialGuesses.insert(initialGuesses.end(), initialGuess.begin(), initialGuess.end());
+		parametersUncertainty.insert(parametersUncertainty.end(), parameterUncertainty.begin(),
+				parameterUncertainty.end());
+		batchObservations.insert(batchObservations.end(), observationsValues.begin(), observationsValues.end());
+		allObservationsUncertainty.insert(allObservationsUncertainty.end(), observationsUncertainty.begin(),
+				observationsUncertainty.end());
+	}
+
+	int sigmaType = SigmaPointsGenerator::SIMPLEX;
+	config.lookupValue("SigmaDistribution", sigmaType);
+	double tol = 1E-5;
+	config.lookupValue("ConvergenceTol", tol);
+	int maxIt = 1000;
+	config.lookupValue("MaxIterations", maxIt);
+
+	batchModel = new BatchROUKF(nFilters, nObservations, nStates, nParameters,
+			&(allObservationsUncertainty[0]), &(parametersUncertainty[0]),
+			static_cast<SigmaPointsGenerator::SIGMA_DISTRIBUTION>(sigmaType));
+	if (typeROUKF == MODEL_MAPPED_ROUKF)
+		batchModel->setParameterMapper(readParameterMapping(config));
+	for (int f = 0; f < nFilters; ++f)
+		batchModel->setParameters(f, &(initialGuesses[f * nParameters]));
+	batchModel->setTolerance(tol);
+	batchModel->setMaxIterations(maxIt);
+
+	return batchModel;
+}
+
+vector<double> ConfigurationFileReader::getBatchObservations() {
+	return batchObservations;
+}
@@ -9,6 +9,7 @@
 #define CONFIGURATIONFILEREADER_H_
 
 #include "../AbstractROUKF.h"
+#include "../BatchROUKF.h"
 #include <iostream>
 
 using namespace std;
@@ -30,6 +31,10 @@ class ConfigurationFileReader {
 	int nObservations;
 	/**	Singleton attribute of the generated kalman filter. */
 	AbstractROUKF *roukfModel;
+	/**	Observations of each problem of the batch as columns, loaded from configuration file. */
+	vector<double> batchObservations;
+	/**	Singleton attribute of the generated batch of kalman filters. */
+	BatchROUKF *batchModel;
 
 public:
 
@@ -46,6 +51,30 @@ public:
 	 * @return Kalman model.
 	 */
 	AbstractROUKF *getInstance();
+	/**
+	 * Returns the batch of kalman filters described by the list of Problems of the configuration
+	 * file. Each problem defines its InitialGuess, ParameterUncertainty, ObservationsValues and
+	 * ObservationsUncertainty, the fields it omits are taken from the file, as well as the
+	 * dimensions, the FilterType (ROUKF or MappedROUKF), the ParameterMapping and the
+	 * SigmaDistribution shared by all filters.
+	 *
+	 *	@code
+	 *	FilterType = 1; States = 100; Parameters = 2; Observations = 10;
+	 *	ParameterMapping = ( { type = 1; numParam = 2; } );
+	 *	ObservationsUncertainty = [ 0.01, ... ];
+	 *	Problems = ( { InitialGuess = [ 1.0, 2.0 ]; ParameterUncertainty = [ 0.5, 0.5 ]; ObservationsValues = [ ... ]; },
+	 *			{ InitialGuess = [ 1.5, 2.0 ]; ParameterUncertainty = [ 0.5, 0.5 ]; ObservationsValues = [ ... ]; } );
+	 *	@endcode
+	 * @return Batch of kalman models, or NULL if the file does not describe a valid batch.
+	 */
+	BatchROUKF *getBatch();
+
+	/**
+	 * Returns the observations of each problem of the batch as columns (nObservations x
+	 * nFilters) after executing getBatch.
+	 * @return	Observations of the batch.
+	 */
+	vector<double> getBatchObservations();
 
 	/**
 	 * Returns the observations read from the configuration file after executing getInstance.
@@ -0,0 +1,73 @@
+/*
+ * MappedFile.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "MappedFile.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <vector>
+
+MappedFile::MappedFile() {
+	mapping = NULL;
+	size = 0;
+}
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+bool MappedFile::create(const string &directory, size_t bytes) {
+	close();
+
+	string pattern = directory + "/roukf-XXXXXX";
+	vector<char> filename(pattern.begin(), pattern.end());
+	filename.push_back('\0');
+	int fd = mkstemp(&(filename[0]));
+	if (fd < 0) {
+		cerr << "Unable to create a storage file in " << directory << "." << endl;
+		return false;
+	}
+	unlink(&(filename[0]));
+
+	if (bytes == 0 || ftruncate(fd, bytes) != 0) {
+		cerr << "Unable to allocate " << bytes << " bytes of storage in " << directory << "." << endl;
+		::close(fd);
+		return false;
+	}
+	void *address = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (address == MAP_FAILED) {
+		cerr << "Unable to map the storage file in " << directory << "." << endl;
+		return false;
+	}
+	madvise(address, bytes, MADV_SEQUENTIAL);
+
+	mapping = (char *) address;
+	size = bytes;
+	return true;
+}
+
+void MappedFile::close() {
+	if (mapping)
+		munmap(mapping, size);
+	mapping = NULL;
+	size = 0;
+}
+
+void MappedFile::swap(MappedFile &other) {
+	std::swap(mapping, other.mapping);
+	std::swap(size, other.size);
+}
+
+double *MappedFile::data() const {
+	return (double *) mapping;
+}
+
+bool MappedFile::isOpen() const {
+	return mapping != NULL;
+}
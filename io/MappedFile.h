@@ -0,0 +1,68 @@
+/*
+ * MappedFile.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef MAPPEDFILE_H_
+#define MAPPEDFILE_H_
+
+#include <cstddef>
+#include <string>
+
+using namespace std;
+
+/**
+ * Anonymous read-write memory mapping backed by a temporary file, used to keep large matrices
+ * out of the main memory. The file is removed as soon as it is mapped, so it never outlives the
+ * process even if it is killed.
+ */
+class MappedFile {
+	/**	Start of the mapping, NULL if no file is mapped. */
+	char *mapping;
+	/**	Size of the mapping in bytes. */
+	size_t size;
+
+	MappedFile(const MappedFile &);
+	MappedFile &operator=(const MappedFile &);
+
+public:
+	/**
+	 * Creates an empty mapping.
+	 */
+	MappedFile();
+	/**
+	 * Unmaps the file.
+	 */
+	~MappedFile();
+
+	/**
+	 * Creates a zero-filled temporary file and maps it for sequential access.
+	 * @param directory Directory of the temporary file.
+	 * @param bytes Size of the file.
+	 * @return If the file was created and mapped.
+	 */
+	bool create(const string &directory, size_t bytes);
+	/**
+	 * Unmaps the file, its content is discarded.
+	 */
+	void close();
+	/**
+	 * Exchanges the mappings of two objects.
+	 * @param other Other mapped file.
+	 */
+	void swap(MappedFile &other);
+
+	/**
+	 * Returns the start of the mapping.
+	 * @return Mapped memory, or NULL if no file is mapped.
+	 */
+	double *data() const;
+	/**
+	 * Returns if a file is mapped.
+	 * @return If a file is mapped.
+	 */
+	bool isOpen() const;
+};
+
+#endif /* MAPPEDFILE_H_ */
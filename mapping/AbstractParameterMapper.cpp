@@ -7,9 +7,29 @@
 
 #include "AbstractParameterMapper.h"
 
+#include <algorithm>
+
 AbstractParameterMapper::AbstractParameterMapper()
 {
 	// TODO Auto-generated constructor stub
 
 }
 
+AbstractParameterMapper::~AbstractParameterMapper() {
+}
+
+void AbstractParameterMapper::mapBlock(double *block, int nRows, int nColumns, int stride) {
+	for (int j = 0; j < nColumns; ++j) {
+		double *column = block + (size_t) j * stride;
+		vector<double> parameters = map(vector<double>(column, column + nRows));
+		copy(parameters.begin(), parameters.end(), column);
+	}
+}
+
+void AbstractParameterMapper::unmapBlock(double *block, int nRows, int nColumns, int stride) {
+	for (int j = 0; j < nColumns; ++j) {
+		double *column = block + (size_t) j * stride;
+		vector<double> parameters = unmap(vector<double>(column, column + nRows));
+		copy(parameters.begin(), parameters.end(), column);
+	}
+}
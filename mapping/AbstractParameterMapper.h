@@ -22,6 +22,8 @@ class AbstractParameterMapper {
 public:
 	/**	Dummy constructor. */
 	AbstractParameterMapper();
+	/**	Dummy destructor. */
+	virtual ~AbstractParameterMapper();
 
 	/**
 	 * Maps the problem parameters into the space of parameters where kalman filter optimize
@@ -36,6 +38,27 @@ public:
 	 * @return Set of problem parameters.
 	 */
 	virtual vector<double> unmap(vector<double> kalmanParameter) = 0;
+
+	/**
+	 * Maps in place a block of problem parameters into kalman parameters. The block has
+	 * @p nColumns columns (one per sigma point) of @p nRows parameters, consecutive columns
+	 * being @p stride elements apart, so that a subset of rows of a larger block is mapped
+	 * without copies. By default each column goes through map, mappers should override it
+	 * with a loop over the block.
+	 * @param block First parameter of the block.
+	 * @param nRows Quantity of parameters of each column.
+	 * @param nColumns Quantity of columns.
+	 * @param stride Distance between the first parameters of consecutive columns.
+	 */
+	virtual void mapBlock(double *block, int nRows, int nColumns, int stride);
+	/**
+	 * Maps in place a block of kalman parameters into problem parameters. See mapBlock.
+	 * @param block First parameter of the block.
+	 * @param nRows Quantity of parameters of each column.
+	 * @param nColumns Quantity of columns.
+	 * @param stride Distance between the first parameters of consecutive columns.
+	 */
+	virtual void unmapBlock(double *block, int nRows, int nColumns, int stride);
 };
 
 #endif /* ABSTRACTPARAMETERMAPPER_H_ */
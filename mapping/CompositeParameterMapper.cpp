@@ -7,6 +7,7 @@
 
 #include "CompositeParameterMapper.h"
 #include "iostream"
+#include <algorithm>
 
 CompositeParameterMapper::CompositeParameterMapper(vector<int> paramsPerMapper, vector<AbstractParameterMapper *> mappers) : AbstractParameterMapper() {
 	this->mappers = mappers;
@@ -18,27 +19,32 @@ CompositeParameterMapper::~CompositeParameterMapper() {
 }
 
 vector<double> CompositeParameterMapper::map(vector<double> problemParameters) {
-	vector<double> kalmanParameters;
-	int currentParameter = 0;
-	for(unsigned int i = 0; i < paramsPerMapper.size(); ++i) {
-		vector<double> currentMapping(problemParameters.begin()+currentParameter, problemParameters.begin()+currentParameter+paramsPerMapper[i]);
-		vector<double> currentParameters = mappers[i]->map(currentMapping);
-		kalmanParameters.insert( kalmanParameters.end(), currentParameters.begin(), currentParameters.end() );
-		currentParameter += paramsPerMapper[i];
-	}
+	if (!problemParameters.empty())
+		mapBlock(&(problemParameters[0]), problemParameters.size(), 1, problemParameters.size());
+	return problemParameters;
+}
 
+vector<double> CompositeParameterMapper::unmap(vector<double> kalmanParameters) {
+	if (!kalmanParameters.empty())
+		unmapBlock(&(kalmanParameters[0]), kalmanParameters.size(), 1, kalmanParameters.size());
 	return kalmanParameters;
 }
 
-vector<double> CompositeParameterMapper::unmap(vector<double> kalmanParameters) {
-	vector<double> problemParameters;
+void CompositeParameterMapper::mapBlock(double *block, int nRows, int nColumns, int stride) {
+	//	Each mapper transforms its rows of all columns, the block is never copied.
 	int currentParameter = 0;
-	for(unsigned int i = 0; i < paramsPerMapper.size(); ++i) {
-		vector<double> currentMapping(kalmanParameters.begin()+currentParameter, kalmanParameters.begin()+currentParameter+paramsPerMapper[i]);
-		vector<double> currentParameters = mappers[i]->unmap(currentMapping);
-		problemParameters.insert( problemParameters.end(), currentParameters.begin(), currentParameters.end() );
+	for (unsigned int i = 0; i < paramsPerMapper.size() && currentParameter < nRows; ++i) {
+		mappers[i]->mapBlock(block + currentParameter, std::min(paramsPerMapper[i], nRows - currentParameter),
+				nColumns, stride);
 		currentParameter += paramsPerMapper[i];
 	}
+}
 
-	return problemParameters;
+void CompositeParameterMapper::unmapBlock(double *block, int nRows, int nColumns, int stride) {
+	int currentParameter = 0;
+	for (unsigned int i = 0; i < paramsPerMapper.size() && currentParameter < nRows; ++i) {
+		mappers[i]->unmapBlock(block + currentParameter, std::min(paramsPerMapper[i], nRows - currentParameter),
+				nColumns, stride);
+		currentParameter += paramsPerMapper[i];
+	}
 }
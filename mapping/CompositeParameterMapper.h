@@ -48,6 +48,9 @@ public:
 	 * @return Set of problem parameters.
 	 */
 	vector<double> unmap(vector<double> kalmanParameters);
+
+	void mapBlock(double *block, int nRows, int nColumns, int stride) override;
+	void unmapBlock(double *block, int nRows, int nColumns, int stride) override;
 };
 
 #endif /* COMPOSITEPARAMETERMAPPER_H_ */
@@ -12,19 +12,29 @@ ExponentialParameterMapper::ExponentialParameterMapper() : AbstractParameterMapp
 }
 
 vector<double> ExponentialParameterMapper::map(vector<double> problemParameters){
-	vector<double> kalmanParameters;
-	for(vector<double>::iterator it = problemParameters.begin(); it != problemParameters.end(); ++it) {
-		kalmanParameters.push_back(log(*it));
-	}
+	if (!problemParameters.empty())
+		mapBlock(&(problemParameters[0]), problemParameters.size(), 1, problemParameters.size());
+	return problemParameters;
+}
 
+vector<double> ExponentialParameterMapper::unmap(vector<double> kalmanParameters){
+	if (!kalmanParameters.empty())
+		unmapBlock(&(kalmanParameters[0]), kalmanParameters.size(), 1, kalmanParameters.size());
 	return kalmanParameters;
 }
 
-vector<double> ExponentialParameterMapper::unmap(vector<double> kalmanParameters){
-	vector<double> problemParameters;
-	for(vector<double>::iterator it = kalmanParameters.begin(); it != kalmanParameters.end(); ++it) {
-		problemParameters.push_back(exp(*it));
+void ExponentialParameterMapper::mapBlock(double *block, int nRows, int nColumns, int stride) {
+	for (int j = 0; j < nColumns; ++j) {
+		double *column = block + (size_t) j * stride;
+		for (int i = 0; i < nRows; ++i)
+			column[i] = log(column[i]);
 	}
+}
 
-	return problemParameters;
+void ExponentialParameterMapper::unmapBlock(double *block, int nRows, int nColumns, int stride) {
+	for (int j = 0; j < nColumns; ++j) {
+		double *column = block + (size_t) j * stride;
+		for (int i = 0; i < nRows; ++i)
+			column[i] = exp(column[i]);
+	}
 }
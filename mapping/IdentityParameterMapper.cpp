@@ -17,3 +17,9 @@ vector<double> IdentityParameterMapper::map(vector<double> problemParameters){
 vector<double> IdentityParameterMapper::unmap(vector<double> kalmanParameters){
 	return kalmanParameters;
 }
+
+void IdentityParameterMapper::mapBlock(double *, int, int, int) {
+}
+
+void IdentityParameterMapper::unmapBlock(double *, int, int, int) {
+}
@@ -34,6 +34,9 @@ public:
 	 * @return Set of problem parameters.
 	 */
 	vector<double> unmap(vector<double> kalmanParameters);
+
+	void mapBlock(double *block, int nRows, int nColumns, int stride) override;
+	void unmapBlock(double *block, int nRows, int nColumns, int stride) override;
 };
 
 #endif /* IDENTITYPARAMETERMAPPER_H_ */
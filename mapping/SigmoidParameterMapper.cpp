@@ -15,19 +15,32 @@ SigmoidParameterMapper::SigmoidParameterMapper(double min, double max) : Abstrac
 }
 
 vector<double> SigmoidParameterMapper::map(vector<double> problemParameters){
-	vector<double> kalmanParameters;
-	for(vector<double>::iterator it = problemParameters.begin(); it != problemParameters.end(); ++it) {
-		kalmanParameters.push_back( -log( (max-min) / (*it-min) - 1 ) );
-	}
+	if (!problemParameters.empty())
+		mapBlock(&(problemParameters[0]), problemParameters.size(), 1, problemParameters.size());
+	return problemParameters;
+}
 
+vector<double> SigmoidParameterMapper::unmap(vector<double> kalmanParameters){
+	if (!kalmanParameters.empty())
+		unmapBlock(&(kalmanParameters[0]), kalmanParameters.size(), 1, kalmanParameters.size());
 	return kalmanParameters;
 }
 
-vector<double> SigmoidParameterMapper::unmap(vector<double> kalmanParameters){
-	vector<double> problemParameters;
-	for(vector<double>::iterator it = kalmanParameters.begin(); it != kalmanParameters.end(); ++it) {
-		problemParameters.push_back( 1 / (1+exp(-*it)) * (max - min) + min );
+void SigmoidParameterMapper::mapBlock(double *block, int nRows, int nColumns, int stride) {
+	//	-log((max - min) / (x - min) - 1) with a single division
+	const double min = this->min, max = this->max;
+	for (int j = 0; j < nColumns; ++j) {
+		double *column = block + (size_t) j * stride;
+		for (int i = 0; i < nRows; ++i)
+			column[i] = log((column[i] - min) / (max - column[i]));
 	}
+}
 
-	return problemParameters;
+void SigmoidParameterMapper::unmapBlock(double *block, int nRows, int nColumns, int stride) {
+	const double min = this->min, range = this->max - this->min;
+	for (int j = 0; j < nColumns; ++j) {
+		double *column = block + (size_t) j * stride;
+		for (int i = 0; i < nRows; ++i)
+			column[i] = min + range / (1 + exp(-column[i]));
+	}
 }
@@ -0,0 +1,60 @@
+/*
+ * AbstractObservationErrorModel.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "AbstractObservationErrorModel.h"
+
+#include "BlockDiagonalObservationErrorModel.h"
+#include "DenseObservationErrorModel.h"
+#include "DiagonalObservationErrorModel.h"
+
+AbstractObservationErrorModel::AbstractObservationErrorModel() {
+}
+
+AbstractObservationErrorModel::~AbstractObservationErrorModel() {
+}
+
+void AbstractObservationErrorModel::whiten(double *B, int nCols) const {
+	int n = getObservations();
+	whitenRows(B, n, nCols, 0, n);
+}
+
+AbstractObservationErrorModel *AbstractObservationErrorModel::restore(const Checkpoint &checkpoint) {
+	vector<double> variances, blockSizes, blocks;
+	arma::mat covariance;
+
+	if (checkpoint.read("obsVariance", variances))
+		return new DiagonalObservationErrorModel(variances.size(), &(variances[0]));
+
+	if (checkpoint.read("obsBlockSizes", blockSizes) && checkpoint.read("obsBlocks", blocks)) {
+		vector<arma::mat> covariances;
+		size_t offset = 0;
+		for (size_t b = 0; b < blockSizes.size(); ++b) {
+			int n = blockSizes[b];
+			covariances.push_back(arma::mat(&(blocks[offset]), n, n));
+			offset += n * n;
+		}
+		return new BlockDiagonalObservationErrorModel(covariances);
+	}
+
+	if (checkpoint.read("obsCovariance", covariance))
+		return new DenseObservationErrorModel(covariance);
+
+	return NULL;
+}
+
+void AbstractObservationErrorModel::solveLower(const double *L, int n, double *B, int ldB, int nCols) {
+	//	Column oriented forward substitution, so that L is traversed contiguously.
+	for (int c = 0; c < nCols; ++c) {
+		double *b = B + c * ldB;
+		for (int k = 0; k < n; ++k) {
+			const double *l = L + k * n;
+			double bk = b[k] / l[k];
+			b[k] = bk;
+			for (int i = k + 1; i < n; ++i)
+				b[i] -= l[i] * bk;
+		}
+	}
+}
@@ -0,0 +1,84 @@
+/*
+ * AbstractObservationErrorModel.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef ABSTRACTOBSERVATIONERRORMODEL_H_
+#define ABSTRACTOBSERVATIONERRORMODEL_H_
+
+#include <armadillo>
+
+#include "../io/Checkpoint.h"
+
+/**
+ * Abstract class that models the covariance C of the observation errors. The filter never
+ * forms C^{-1}: the models factorize C = L L^T once at construction and the filter whitens
+ * the observation quantities with L^{-1}, since HL^T C^{-1} HL = (L^{-1} HL)^T (L^{-1} HL).
+ */
+class AbstractObservationErrorModel {
+public:
+	/**	Dummy constructor. */
+	AbstractObservationErrorModel();
+	/**	Virtual destructor. */
+	virtual ~AbstractObservationErrorModel();
+
+	/**
+	 * Returns the quantity of observations of the model.
+	 * @return Quantity of observations.
+	 */
+	virtual int getObservations() const = 0;
+	/**
+	 * Whitens observation vectors in place, B = L^{-1} B.
+	 * @param B Column-major matrix with one observation vector per column.
+	 * @param nCols Quantity of columns of @p B .
+	 */
+	void whiten(double *B, int nCols) const;
+	/**
+	 * Whitens in place the rows [@p firstRow , @p firstRow + @p nRows ) of observation vectors.
+	 * The range must start and end at independent rows (see nextIndependentRow).
+	 * @param B Column-major matrix with the @p nRows observations of the range per column.
+	 * @param ldB Distance between columns of @p B .
+	 * @param nCols Quantity of columns of @p B .
+	 * @param firstRow First observation of the range.
+	 * @param nRows Quantity of observations of the range.
+	 */
+	virtual void whitenRows(double *B, int ldB, int nCols, int firstRow, int nRows) const = 0;
+	/**
+	 * Returns the first observation after @p row whose error is uncorrelated with the errors of
+	 * all the previous observations, so that ranges of rows can be whitened independently.
+	 * @param row Index of an observation.
+	 * @return Index of the next independent observation (at most the quantity of observations).
+	 */
+	virtual int nextIndependentRow(int row) const = 0;
+	/**
+	 * Returns the dense covariance matrix C.
+	 * @return Covariance of the observation errors.
+	 */
+	virtual arma::mat getCovariance() const = 0;
+	/**
+	 * Adds the model to a checkpoint.
+	 * @param checkpoint Checkpoint to be written.
+	 */
+	virtual void save(Checkpoint &checkpoint) const = 0;
+
+	/**
+	 * Creates the model saved in an opened checkpoint.
+	 * @param checkpoint Opened checkpoint.
+	 * @return New model, or NULL if the checkpoint has no observation error model.
+	 */
+	static AbstractObservationErrorModel *restore(const Checkpoint &checkpoint);
+
+protected:
+	/**
+	 * Solves in place L Y = B, with L lower triangular, by forward substitution.
+	 * @param L Column-major lower triangular matrix of size @p n x @p n .
+	 * @param n Size of @p L .
+	 * @param B Column-major right hand side with @p n rows, overwritten with the solution.
+	 * @param ldB Distance between columns of @p B .
+	 * @param nCols Quantity of columns of @p B .
+	 */
+	static void solveLower(const double *L, int n, double *B, int ldB, int nCols);
+};
+
+#endif /* ABSTRACTOBSERVATIONERRORMODEL_H_ */
@@ -0,0 +1,60 @@
+/*
+ * BlockDiagonalObservationErrorModel.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "BlockDiagonalObservationErrorModel.h"
+
+#include <algorithm>
+#include <iostream>
+
+BlockDiagonalObservationErrorModel::BlockDiagonalObservationErrorModel(const vector<arma::mat> &blocks) :
+		AbstractObservationErrorModel() {
+	nObservations = 0;
+	for (vector<arma::mat>::const_iterator it = blocks.begin(); it != blocks.end(); ++it) {
+		arma::mat L;
+		if (!arma::chol(L, *it, "lower")) {
+			cerr << "Observation covariance block " << sizes.size()
+					<< " is not positive definite, its correlations are ignored." << endl;
+			L = arma::diagmat(arma::sqrt(it->diag()));
+		}
+		sizes.push_back(it->n_rows);
+		offsets.push_back(nObservations);
+		factorOffsets.push_back(factors.size());
+		nObservations += it->n_rows;
+		covariances.insert(covariances.end(), it->begin(), it->end());
+		factors.insert(factors.end(), L.begin(), L.end());
+	}
+}
+
+int BlockDiagonalObservationErrorModel::getObservations() const {
+	return nObservations;
+}
+
+void BlockDiagonalObservationErrorModel::whitenRows(double *B, int ldB, int nCols, int firstRow, int nRows) const {
+	size_t b = lower_bound(offsets.begin(), offsets.end(), firstRow) - offsets.begin();
+	for (; b < sizes.size() && offsets[b] < firstRow + nRows; ++b)
+		solveLower(&(factors[factorOffsets[b]]), sizes[b], B + offsets[b] - firstRow, ldB, nCols);
+}
+
+int BlockDiagonalObservationErrorModel::nextIndependentRow(int row) const {
+	size_t b = upper_bound(offsets.begin(), offsets.end(), row) - offsets.begin() - 1;
+	return offsets[b] + sizes[b];
+}
+
+arma::mat BlockDiagonalObservationErrorModel::getCovariance() const {
+	arma::mat C = arma::zeros(nObservations, nObservations);
+	const double *c = &(covariances[0]);
+	for (size_t b = 0; b < sizes.size(); ++b) {
+		C.submat(offsets[b], offsets[b], offsets[b] + sizes[b] - 1, offsets[b] + sizes[b] - 1) =
+				arma::mat(c, sizes[b], sizes[b]);
+		c += sizes[b] * sizes[b];
+	}
+	return C;
+}
+
+void BlockDiagonalObservationErrorModel::save(Checkpoint &checkpoint) const {
+	checkpoint.add("obsBlockSizes", vector<double>(sizes.begin(), sizes.end()));
+	checkpoint.add("obsBlocks", covariances);
+}
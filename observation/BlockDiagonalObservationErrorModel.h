@@ -0,0 +1,50 @@
+/*
+ * BlockDiagonalObservationErrorModel.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef BLOCKDIAGONALOBSERVATIONERRORMODEL_H_
+#define BLOCKDIAGONALOBSERVATIONERRORMODEL_H_
+
+#include <vector>
+
+#include "AbstractObservationErrorModel.h"
+
+using namespace std;
+
+/**
+ * Implementation of the AbstractObservationErrorModel class for observation errors correlated
+ * only within groups of consecutive observations (e.g. the sensors of one array). Each block is
+ * factorized and whitened independently.
+ */
+class BlockDiagonalObservationErrorModel: public AbstractObservationErrorModel {
+	/**	Size of each block. */
+	vector<int> sizes;
+	/**	First observation of each block. */
+	vector<int> offsets;
+	/**	Position of each block in @p covariances and @p factors . */
+	vector<int> factorOffsets;
+	/**	Quantity of observations. */
+	int nObservations;
+	/**	Covariance blocks stored consecutively in column-major order. */
+	vector<double> covariances;
+	/**	Lower Cholesky factors of the blocks, stored as @p covariances . */
+	vector<double> factors;
+
+public:
+	/**
+	 * Creates the model and factorizes each block. A block that is not positive definite
+	 * discards its correlations and only uses its diagonal.
+	 * @param blocks Covariance blocks along the diagonal, in order of observations.
+	 */
+	BlockDiagonalObservationErrorModel(const vector<arma::mat> &blocks);
+
+	int getObservations() const;
+	void whitenRows(double *B, int ldB, int nCols, int firstRow, int nRows) const;
+	int nextIndependentRow(int row) const;
+	arma::mat getCovariance() const;
+	void save(Checkpoint &checkpoint) const;
+};
+
+#endif /* BLOCKDIAGONALOBSERVATIONERRORMODEL_H_ */
@@ -0,0 +1,41 @@
+/*
+ * DenseObservationErrorModel.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "DenseObservationErrorModel.h"
+
+#include <iostream>
+
+using namespace std;
+
+DenseObservationErrorModel::DenseObservationErrorModel(const arma::mat &covariance) :
+		AbstractObservationErrorModel() {
+	this->covariance = covariance;
+	if (!arma::chol(L, covariance, "lower")) {
+		cerr << "Observation covariance is not positive definite, its correlations are ignored." << endl;
+		L = arma::diagmat(arma::sqrt(covariance.diag()));
+	}
+}
+
+int DenseObservationErrorModel::getObservations() const {
+	return L.n_rows;
+}
+
+void DenseObservationErrorModel::whitenRows(double *B, int ldB, int nCols, int, int) const {
+	//	All observations are correlated, hence the range is always the whole vector.
+	solveLower(L.memptr(), L.n_rows, B, ldB, nCols);
+}
+
+int DenseObservationErrorModel::nextIndependentRow(int) const {
+	return L.n_rows;
+}
+
+arma::mat DenseObservationErrorModel::getCovariance() const {
+	return covariance;
+}
+
+void DenseObservationErrorModel::save(Checkpoint &checkpoint) const {
+	checkpoint.add("obsCovariance", covariance);
+}
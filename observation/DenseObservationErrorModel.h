@@ -0,0 +1,37 @@
+/*
+ * DenseObservationErrorModel.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef DENSEOBSERVATIONERRORMODEL_H_
+#define DENSEOBSERVATIONERRORMODEL_H_
+
+#include "AbstractObservationErrorModel.h"
+
+/**
+ * Implementation of the AbstractObservationErrorModel class for a dense symmetric positive
+ * definite covariance of the observation errors.
+ */
+class DenseObservationErrorModel: public AbstractObservationErrorModel {
+	/**	Covariance of the observation errors. */
+	arma::mat covariance;
+	/**	Lower Cholesky factor of @p covariance . */
+	arma::mat L;
+
+public:
+	/**
+	 * Creates the model and factorizes the covariance. If it is not positive definite, the
+	 * correlations are discarded and only its diagonal is used.
+	 * @param covariance Covariance of the observation errors.
+	 */
+	DenseObservationErrorModel(const arma::mat &covariance);
+
+	int getObservations() const;
+	void whitenRows(double *B, int ldB, int nCols, int firstRow, int nRows) const;
+	int nextIndependentRow(int row) const;
+	arma::mat getCovariance() const;
+	void save(Checkpoint &checkpoint) const;
+};
+
+#endif /* DENSEOBSERVATIONERRORMODEL_H_ */
@@ -0,0 +1,42 @@
+/*
+ * DiagonalObservationErrorModel.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "DiagonalObservationErrorModel.h"
+
+#include <cmath>
+
+DiagonalObservationErrorModel::DiagonalObservationErrorModel(int nObservations, const double *variances) :
+		AbstractObservationErrorModel() {
+	this->variances.assign(variances, variances + nObservations);
+	invStd.resize(nObservations);
+	for (int i = 0; i < nObservations; ++i)
+		invStd[i] = 1. / sqrt(variances[i]);
+}
+
+int DiagonalObservationErrorModel::getObservations() const {
+	return invStd.size();
+}
+
+void DiagonalObservationErrorModel::whitenRows(double *B, int ldB, int nCols, int firstRow, int nRows) const {
+	const double *s = &(invStd[firstRow]);
+	for (int c = 0; c < nCols; ++c) {
+		double *b = B + c * ldB;
+		for (int i = 0; i < nRows; ++i)
+			b[i] *= s[i];
+	}
+}
+
+int DiagonalObservationErrorModel::nextIndependentRow(int row) const {
+	return row + 1;
+}
+
+arma::mat DiagonalObservationErrorModel::getCovariance() const {
+	return arma::diagmat(arma::vec(variances));
+}
+
+void DiagonalObservationErrorModel::save(Checkpoint &checkpoint) const {
+	checkpoint.add("obsVariance", variances);
+}
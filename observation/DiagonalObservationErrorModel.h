@@ -0,0 +1,41 @@
+/*
+ * DiagonalObservationErrorModel.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef DIAGONALOBSERVATIONERRORMODEL_H_
+#define DIAGONALOBSERVATIONERRORMODEL_H_
+
+#include <vector>
+
+#include "AbstractObservationErrorModel.h"
+
+using namespace std;
+
+/**
+ * Implementation of the AbstractObservationErrorModel class for independent observation errors.
+ * Whitening is a plain scaling of each row by the inverse of its standard deviation.
+ */
+class DiagonalObservationErrorModel: public AbstractObservationErrorModel {
+	/**	Variance of each observation. */
+	vector<double> variances;
+	/**	Inverse of the standard deviation of each observation. */
+	vector<double> invStd;
+
+public:
+	/**
+	 * Creates the model from the variance of each observation.
+	 * @param nObservations Quantity of observations.
+	 * @param variances Variance of each observation.
+	 */
+	DiagonalObservationErrorModel(int nObservations, const double *variances);
+
+	int getObservations() const;
+	void whitenRows(double *B, int ldB, int nCols, int firstRow, int nRows) const;
+	int nextIndependentRow(int row) const;
+	arma::mat getCovariance() const;
+	void save(Checkpoint &checkpoint) const;
+};
+
+#endif /* DIAGONALOBSERVATIONERRORMODEL_H_ */
@@ -0,0 +1,45 @@
+/*
+ * AbstractExecutionBackend.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "AbstractExecutionBackend.h"
+
+#include <algorithm>
+
+AbstractExecutionBackend::~AbstractExecutionBackend() {
+}
+
+int AbstractExecutionBackend::getLocalSigmaPoint() const {
+	return -1;
+}
+
+int AbstractExecutionBackend::getThreads() const {
+	return 1;
+}
+
+ThreadPool *AbstractExecutionBackend::getThreadPool() {
+	return NULL;
+}
+
+bool AbstractExecutionBackend::sharesMemory() const {
+	return true;
+}
+
+void AbstractExecutionBackend::waitParametersAndObservations(const Blocks &) {
+}
+
+void AbstractExecutionBackend::waitStates(const Blocks &) {
+}
+
+bool AbstractExecutionBackend::anyFailed(const Blocks &blocks) {
+	return std::find(blocks.failed, blocks.failed + blocks.nSigma, 1) != blocks.failed + blocks.nSigma;
+}
+
+long long AbstractExecutionBackend::getBlocksBytes(const Blocks &blocks) {
+	size_t payload = blocks.singlePrecision ? sizeof(float) : sizeof(double);
+	size_t bytes = (blocks.Xk ? blocks.nStates : 0) * payload + blocks.nParameters * sizeof(double)
+			+ blocks.nObservations * payload;
+	return (long long) bytes * blocks.nSigma;
+}
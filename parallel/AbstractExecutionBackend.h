@@ -0,0 +1,120 @@
+/*
+ * AbstractExecutionBackend.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef ABSTRACTEXECUTIONBACKEND_H_
+#define ABSTRACTEXECUTIONBACKEND_H_
+
+#include <functional>
+
+#include "../StepProfiler.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+/**
+ * Strategy that evaluates the sigma points of a filter step (serially, with threads, among MPI
+ * solvers or in forked processes). When waitStates returns, every process of the filter holds
+ * the evaluated columns of all sigma points, hence the filter update does not depend on the
+ * backend.
+ */
+class AbstractExecutionBackend {
+public:
+	/**	Blocks of the sigma points, column-major with one column per sigma point. */
+	struct Blocks {
+		/**	States (nStates x nSigma), NULL if the filter does not keep them. */
+		double *Xk;
+		/**	Parameters (nParameters x nSigma). */
+		double *Thetak;
+		/**	Observations (nObservations x nSigma). */
+		double *Zk;
+		/**	Quantity of states. */
+		int nStates;
+		/**	Quantity of parameters. */
+		int nParameters;
+		/**	Quantity of observations. */
+		int nObservations;
+		/**	Quantity of sigma points. */
+		int nSigma;
+		/**	If states and observations are communicated in single precision. */
+		bool singlePrecision;
+		/**	Profiler of the filter step, where the communications are recorded. */
+		StepProfiler *profiler;
+		/**	Flags of the sigma points whose forward or observation operator failed (one per sigma
+		 * point), set by the evaluation function in the process that evaluates each sigma point.
+		 * Read through anyFailed. */
+		char *failed;
+	};
+
+	/**
+	 * Virtual destructor.
+	 */
+	virtual ~AbstractExecutionBackend();
+
+	/**
+	 * Returns the only sigma point evaluated by this process, whose column is the only one that
+	 * must be sampled, or -1 if the process may evaluate any sigma point.
+	 * @return Index of the sigma point or -1.
+	 */
+	virtual int getLocalSigmaPoint() const;
+	/**
+	 * Returns the quantity of threads that evaluate sigma points at once in this process. Thread
+	 * IDs given to the evaluation function are lower than it.
+	 * @return Quantity of threads.
+	 */
+	virtual int getThreads() const;
+	/**
+	 * Returns the pool of threads of this process, that the filter also uses for its other
+	 * parallel loops.
+	 * @return Pool of threads, or NULL for serial execution.
+	 */
+	virtual ThreadPool *getThreadPool();
+	/**
+	 * Returns if the sigma points are evaluated in the memory of this process, so that the filter
+	 * can record (and checkpoint) each one as soon as it is evaluated.
+	 * @return If the evaluations write the memory of this process.
+	 */
+	virtual bool sharesMemory() const;
+
+	/**
+	 * Evaluates the sigma points and starts sharing the results among the processes.
+	 * @param blocks Blocks of the sigma points, already sampled.
+	 * @param evaluate Function that evaluates the sigma point i in the thread threadId, writing
+	 * its columns of @p blocks .
+	 * @return If all sigma points were evaluated.
+	 */
+	virtual bool evaluate(const Blocks &blocks, const function<void(int, int)> &evaluate) = 0;
+	/**
+	 * Waits until the parameters and observations of all sigma points are available.
+	 * @param blocks Blocks of the sigma points.
+	 */
+	virtual void waitParametersAndObservations(const Blocks &blocks);
+	/**
+	 * Waits until the states of all sigma points are available.
+	 * @param blocks Blocks of the sigma points.
+	 */
+	virtual void waitStates(const Blocks &blocks);
+	/**
+	 * Returns if the forward or observation operator failed for any sigma point of the step,
+	 * with the same answer in every process of the filter so that they all keep or all discard
+	 * the step. The default reads the flags of @p blocks , which hold all failures when the
+	 * evaluations share the memory of the filter; backends that do not share it and do not
+	 * override this method must report the failures through the result of evaluate. Called by
+	 * every process after waitParametersAndObservations.
+	 * @param blocks Blocks of the sigma points.
+	 * @return If any sigma point failed.
+	 */
+	virtual bool anyFailed(const Blocks &blocks);
+
+protected:
+	/**
+	 * Returns the size of the blocks of all sigma points as they are communicated.
+	 * @param blocks Blocks of the sigma points.
+	 * @return Size in bytes.
+	 */
+	static long long getBlocksBytes(const Blocks &blocks);
+};
+
+#endif /* ABSTRACTEXECUTIONBACKEND_H_ */
@@ -0,0 +1,58 @@
+/*
+ * MPIGroupsBackend.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "MPIGroupsBackend.h"
+
+#include <algorithm>
+
+MPIGroupsBackend::MPIGroupsBackend() :
+		AbstractExecutionBackend() {
+	groupComm = MPI_COMM_NULL;
+	mastersComm = MPI_COMM_NULL;
+	pool = NULL;
+}
+
+void MPIGroupsBackend::setup(MPI_Comm group_comm, MPI_Comm masters_comm, ThreadPool *pool) {
+	groupComm = group_comm;
+	mastersComm = masters_comm;
+	this->pool = pool;
+}
+
+const vector<double> &MPIGroupsBackend::getTimings() const {
+	return scheduler.getTimings();
+}
+
+int MPIGroupsBackend::getThreads() const {
+	return pool ? pool->getThreads() : 1;
+}
+
+ThreadPool *MPIGroupsBackend::getThreadPool() {
+	return pool;
+}
+
+bool MPIGroupsBackend::evaluate(const Blocks &blocks, const function<void(int, int)> &evaluate) {
+	scheduler.setup(groupComm, mastersComm, blocks.nSigma);
+	scheduler.run(evaluate, pool);
+
+	StepProfiler::Scope scope(blocks.profiler, StepProfiler::COMMUNICATION);
+	if (blocks.profiler)
+		blocks.profiler->count(StepProfiler::BYTES_COMMUNICATED, getBlocksBytes(blocks));
+	if (blocks.Xk)
+		scheduler.share(blocks.Xk, blocks.nStates, blocks.singlePrecision);
+	scheduler.share(blocks.Thetak, blocks.nParameters);
+	scheduler.share(blocks.Zk, blocks.nObservations, blocks.singlePrecision);
+	return true;
+}
+
+bool MPIGroupsBackend::anyFailed(const Blocks &blocks) {
+	StepProfiler::Scope scope(blocks.profiler, StepProfiler::COMMUNICATION);
+	int failed = std::find(blocks.failed, blocks.failed + blocks.nSigma, 1) != blocks.failed + blocks.nSigma;
+	MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_MAX, groupComm);
+	if (mastersComm != MPI_COMM_NULL)
+		MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_MAX, mastersComm);
+	MPI_Bcast(&failed, 1, MPI_INT, 0, groupComm);
+	return failed;
+}
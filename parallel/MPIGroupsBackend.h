@@ -0,0 +1,65 @@
+/*
+ * MPIGroupsBackend.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef MPIGROUPSBACKEND_H_
+#define MPIGROUPSBACKEND_H_
+
+#include <mpi.h>
+#include <vector>
+
+#include "AbstractExecutionBackend.h"
+#include "SigmaPointsScheduler.h"
+
+using namespace std;
+
+/**
+ * Distributes the sigma points among any quantity of MPI solver groups with a
+ * SigmaPointsScheduler. Groups take sigma points from a shared queue, the slowest sigma points of
+ * the previous step first. If a pool of threads is given, each group evaluates as many sigma
+ * points as threads at a time.
+ */
+class MPIGroupsBackend: public AbstractExecutionBackend {
+	/**	Dynamic distribution of the sigma points among MPI solver groups. */
+	SigmaPointsScheduler scheduler;
+	/**	Communicator of all MPI processes of this solver group. */
+	MPI_Comm groupComm;
+	/**	Communicator of the master MPI processes of each group, MPI_COMM_NULL in the workers. */
+	MPI_Comm mastersComm;
+	/**	Pool of threads of each group, not owned. NULL for serial execution. */
+	ThreadPool *pool;
+
+public:
+	/**
+	 * Creates a backend without groups, setup must be called before evaluating.
+	 */
+	MPIGroupsBackend();
+
+	/**
+	 * Sets the communicators of the groups and the threads of this group.
+	 * @param group_comm Communicator of all MPI processes of this solver group (rank 0 is the master).
+	 * @param masters_comm Communicator of the master MPI processes of each group, MPI_COMM_NULL in the workers.
+	 * @param pool Pool of threads of this group (not owned), or NULL.
+	 */
+	void setup(MPI_Comm group_comm, MPI_Comm masters_comm, ThreadPool *pool);
+	/**
+	 * Returns the time spent evaluating each sigma point at the last step.
+	 * @return Time in seconds of each sigma point.
+	 */
+	const vector<double> &getTimings() const;
+
+	int getThreads() const;
+	ThreadPool *getThreadPool();
+	bool evaluate(const Blocks &blocks, const function<void(int, int)> &evaluate);
+	/**
+	 * Reduces the failure flags within each group and then among the masters of the groups,
+	 * as the sigma points are shared.
+	 * @param blocks Blocks of the sigma points.
+	 * @return If any sigma point failed.
+	 */
+	bool anyFailed(const Blocks &blocks);
+};
+
+#endif /* MPIGROUPSBACKEND_H_ */
@@ -0,0 +1,79 @@
+/*
+ * MPISigmaPointBackend.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "MPISigmaPointBackend.h"
+
+MPISigmaPointBackend::MPISigmaPointBackend() :
+		AbstractExecutionBackend() {
+	sigmaPoint = 0;
+	worldComm = MPI_COMM_NULL;
+	mastersComm = MPI_COMM_NULL;
+	communicationMode = SigmaPointsExchange::GATHER_BROADCAST;
+}
+
+void MPISigmaPointBackend::setup(int sigmaPoint, MPI_Comm world_comm, MPI_Comm masters_comm,
+		SigmaPointsExchange::COMMUNICATION_MODE communicationMode) {
+	this->sigmaPoint = sigmaPoint;
+	worldComm = world_comm;
+	mastersComm = masters_comm;
+	this->communicationMode = communicationMode;
+}
+
+int MPISigmaPointBackend::getLocalSigmaPoint() const {
+	return sigmaPoint;
+}
+
+bool MPISigmaPointBackend::evaluate(const Blocks &blocks, const function<void(int, int)> &evaluate) {
+	evaluate(sigmaPoint, 0);
+
+	StepProfiler::Scope scope(blocks.profiler, StepProfiler::COMMUNICATION);
+	if (blocks.profiler)
+		blocks.profiler->count(StepProfiler::BYTES_COMMUNICATED, getBlocksBytes(blocks));
+	if (communicationMode == SigmaPointsExchange::ALLGATHER) {
+		//	States are sent in place, parameters and observations are packed to overtake them.
+		if (!exchange.setup(mastersComm, worldComm, blocks.Xk, blocks.Xk ? blocks.nStates : 0,
+				blocks.nParameters, blocks.nObservations, blocks.nSigma, blocks.singlePrecision))
+			return false;
+		exchange.pack(sigmaPoint, blocks.Thetak + (size_t) blocks.nParameters * sigmaPoint,
+				blocks.Zk + (size_t) blocks.nObservations * sigmaPoint);
+		exchange.start();
+		return true;
+	}
+
+	//	Masters of each solver (rank < (nParameters + 1)) interchange data from executions and the
+	//	main master broadcasts them to all the workers in all solvers.
+	if (blocks.Xk)
+		SigmaPointsExchange::gatherAndBroadcast(blocks.Xk, blocks.nStates, blocks.nSigma, sigmaPoint,
+				mastersComm, worldComm, blocks.singlePrecision, singlePayload);
+	SigmaPointsExchange::gatherAndBroadcast(blocks.Thetak, blocks.nParameters, blocks.nSigma, sigmaPoint,
+			mastersComm, worldComm, false, singlePayload);
+	SigmaPointsExchange::gatherAndBroadcast(blocks.Zk, blocks.nObservations, blocks.nSigma, sigmaPoint,
+			mastersComm, worldComm, blocks.singlePrecision, singlePayload);
+	return true;
+}
+
+void MPISigmaPointBackend::waitParametersAndObservations(const Blocks &blocks) {
+	StepProfiler::Scope scope(blocks.profiler, StepProfiler::COMMUNICATION);
+	if (communicationMode == SigmaPointsExchange::ALLGATHER)
+		exchange.waitParametersAndObservations(blocks.Thetak, blocks.Zk);
+}
+
+void MPISigmaPointBackend::waitStates(const Blocks &blocks) {
+	StepProfiler::Scope scope(blocks.profiler, StepProfiler::COMMUNICATION);
+	if (communicationMode == SigmaPointsExchange::ALLGATHER)
+		exchange.waitStates();
+}
+
+bool MPISigmaPointBackend::anyFailed(const Blocks &blocks) {
+	StepProfiler::Scope scope(blocks.profiler, StepProfiler::COMMUNICATION);
+	//	The broadcast communicator may span all processes or only those of this solver
+	int failed = blocks.failed[sigmaPoint] ? 1 : 0;
+	MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_MAX, worldComm);
+	if (mastersComm != MPI_COMM_NULL)
+		MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_MAX, mastersComm);
+	MPI_Bcast(&failed, 1, MPI_INT, 0, worldComm);
+	return failed;
+}
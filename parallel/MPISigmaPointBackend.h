@@ -0,0 +1,66 @@
+/*
+ * MPISigmaPointBackend.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef MPISIGMAPOINTBACKEND_H_
+#define MPISIGMAPOINTBACKEND_H_
+
+#include <mpi.h>
+#include <vector>
+
+#include "AbstractExecutionBackend.h"
+#include "SigmaPointsExchange.h"
+
+using namespace std;
+
+/**
+ * Evaluates one sigma point per MPI solver: the solver of the sigma point i evaluates only that
+ * sigma point, and its master (rank i in the masters communicator) shares it with the other
+ * solvers according to the communication mode.
+ */
+class MPISigmaPointBackend: public AbstractExecutionBackend {
+	/**	Sigma point evaluated by this process. */
+	int sigmaPoint;
+	/**	Communicator used to broadcast the sigma points from its rank 0. */
+	MPI_Comm worldComm;
+	/**	Communicator of the master MPI processes of each sigma point, MPI_COMM_NULL in the workers. */
+	MPI_Comm mastersComm;
+	/**	Exchange of the sigma points among the MPI solvers. */
+	SigmaPointsExchange::COMMUNICATION_MODE communicationMode;
+	/**	Collectives used in the ALLGATHER communication mode. */
+	SigmaPointsExchange exchange;
+	/**	Single precision messages of the GATHER_BROADCAST communication mode. */
+	vector<float> singlePayload;
+
+public:
+	/**
+	 * Creates a backend for the sigma point 0 of a single process.
+	 */
+	MPISigmaPointBackend();
+
+	/**
+	 * Sets the sigma point of this process and its communicators.
+	 * @param sigmaPoint Sigma point ID for the current MPI process.
+	 * @param world_comm Communicator used to broadcast the sigma points from its rank 0.
+	 * @param masters_comm Communicator of the master MPI processes of each sigma point.
+	 * @param communicationMode Exchange of the sigma points among the MPI solvers.
+	 */
+	void setup(int sigmaPoint, MPI_Comm world_comm, MPI_Comm masters_comm,
+			SigmaPointsExchange::COMMUNICATION_MODE communicationMode);
+
+	int getLocalSigmaPoint() const;
+	bool evaluate(const Blocks &blocks, const function<void(int, int)> &evaluate);
+	void waitParametersAndObservations(const Blocks &blocks);
+	void waitStates(const Blocks &blocks);
+	/**
+	 * Reduces the failure flag of the sigma point of each process within its broadcast
+	 * communicator and then among the masters of the sigma points.
+	 * @param blocks Blocks of the sigma points.
+	 * @return If any sigma point failed.
+	 */
+	bool anyFailed(const Blocks &blocks);
+};
+
+#endif /* MPISIGMAPOINTBACKEND_H_ */
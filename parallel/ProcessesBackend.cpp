@@ -0,0 +1,126 @@
+/*
+ * ProcessesBackend.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "ProcessesBackend.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+ProcessesBackend::ProcessesBackend(int nProcesses) :
+		AbstractExecutionBackend() {
+	this->nProcesses = nProcesses > 1 ? nProcesses : 1;
+	shared = NULL;
+	sharedSize = 0;
+	counts = NULL;
+	ThreadPool::setBLASThreads(1);
+}
+
+ProcessesBackend::~ProcessesBackend() {
+	if (shared)
+		munmap(shared, sharedSize);
+}
+
+bool ProcessesBackend::sharesMemory() const {
+	return false;
+}
+
+void ProcessesBackend::copyColumns(const Blocks &blocks, int i, bool toShared) {
+	const int nStates = blocks.Xk ? blocks.nStates : 0;
+	double *column = shared + (size_t) (nStates + blocks.nParameters + blocks.nObservations) * i;
+	double *sources[3] = { blocks.Xk, blocks.Thetak, blocks.Zk };
+	const int rows[3] = { nStates, blocks.nParameters, blocks.nObservations };
+	for (int b = 0; b < 3; ++b) {
+		if (!rows[b])
+			continue;
+		double *block = sources[b] + (size_t) rows[b] * i;
+		if (toShared)
+			memcpy(column, block, rows[b] * sizeof(double));
+		else
+			memcpy(block, column, rows[b] * sizeof(double));
+		column += rows[b];
+	}
+}
+
+bool ProcessesBackend::evaluate(const Blocks &blocks, const function<void(int, int)> &evaluate) {
+	if (ThreadPool::getLiveWorkers() > 0) {
+		cerr << "Unable to fork the sigma points processes while " << ThreadPool::getLiveWorkers()
+				<< " pool threads are running." << endl;
+		return false;
+	}
+
+	const int nStates = blocks.Xk ? blocks.nStates : 0;
+	const int nCounts = StepProfiler::PHASES + StepProfiler::COUNTERS;
+	size_t columnsSize = (size_t) (nStates + blocks.nParameters + blocks.nObservations) * blocks.nSigma
+			* sizeof(double);
+	size_t size = columnsSize + (size_t) nProcesses * nCounts * sizeof(long long);
+	if (size != sharedSize) {
+		if (shared)
+			munmap(shared, sharedSize);
+		void *address = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+		shared = address == MAP_FAILED ? NULL : (double *) address;
+		sharedSize = shared ? size : 0;
+		if (!shared) {
+			cerr << "Unable to map " << size << " bytes shared with the sigma points processes." << endl;
+			return false;
+		}
+		counts = (long long *) ((char *) shared + columnsSize);
+	}
+
+	vector<pid_t> children;
+	for (int k = 0; k < nProcesses && k < blocks.nSigma; ++k) {
+		pid_t pid = fork();
+		if (pid == 0) {
+			//	The counts inherited from the parent are subtracted, so that only the ones of this
+			//	child are added back
+			long long *childCounts = counts + (size_t) k * nCounts;
+			vector<long long> before(nCounts);
+			if (blocks.profiler)
+				blocks.profiler->copyCounts(&(before[0]));
+			bool failed = false;
+			for (int i = k; i < blocks.nSigma; i += nProcesses) {
+				evaluate(i, 0);
+				copyColumns(blocks, i, true);
+				failed = failed || (blocks.failed && blocks.failed[i]);
+			}
+			if (blocks.profiler) {
+				blocks.profiler->copyCounts(childCounts);
+				for (int c = 0; c < nCounts; ++c)
+					childCounts[c] -= before[c];
+			}
+			_exit(failed ? 1 : 0);
+		}
+		if (pid < 0) {
+			cerr << "Unable to fork the process of the sigma points " << k << "." << endl;
+			break;
+		}
+		children.push_back(pid);
+	}
+
+	bool ok = (int) children.size() == std::min(nProcesses, blocks.nSigma);
+	for (size_t k = 0; k < children.size(); ++k) {
+		int status;
+		if (waitpid(children[k], &status, 0) < 0 || !WIFEXITED(status)) {
+			cerr << "The process of the sigma points " << k << " failed." << endl;
+			ok = false;
+		} else if (WEXITSTATUS(status) != 0) {
+			cerr << "The forward or observation operator failed in the process of the sigma points " << k
+					<< "." << endl;
+			ok = false;
+		} else if (blocks.profiler)
+			blocks.profiler->addCounts(counts + k * nCounts);
+	}
+	if (!ok)
+		return false;
+
+	for (int i = 0; i < blocks.nSigma; ++i)
+		copyColumns(blocks, i, false);
+	return true;
+}
@@ -0,0 +1,62 @@
+/*
+ * ProcessesBackend.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef PROCESSESBACKEND_H_
+#define PROCESSESBACKEND_H_
+
+#include <cstddef>
+
+#include "AbstractExecutionBackend.h"
+
+/**
+ * Evaluates the sigma points in forked child processes, for operators that are not reentrant
+ * (e.g. solvers with global state) and thus cannot run in threads. The child k evaluates the
+ * sigma points k, k + nProcesses, ... and writes their columns into a shared anonymous mapping,
+ * from where the parent copies them back, together with the profiler counts recorded by each
+ * child. Children inherit the memory of the parent when the step starts and leave with _exit, so
+ * nothing they do besides the operators survives them; a child whose forward operator fails
+ * exits with status 1 and the step fails.
+ *
+ * Only the forking thread survives in the children, hence the process must not run other threads
+ * when the step starts: evaluate refuses to fork while a ThreadPool has workers, and the backend
+ * limits BLAS to 1 thread. In MPI executions, the MPI library must support fork, and the children
+ * must not call MPI.
+ */
+class ProcessesBackend: public AbstractExecutionBackend {
+	/**	Quantity of child processes per step. */
+	int nProcesses;
+	/**	Shared mapping with the columns of all sigma points. */
+	double *shared;
+	/**	Size of @p shared in bytes. */
+	size_t sharedSize;
+	/**	Profiler counts of each child (PHASES + COUNTERS values), after the columns in @p shared. */
+	long long *counts;
+
+	/**
+	 * Copies the columns of the sigma point @p i between @p blocks and @p shared .
+	 * @param blocks Blocks of the sigma points.
+	 * @param i Index of the sigma point.
+	 * @param toShared If the columns are copied into @p shared (or from it).
+	 */
+	void copyColumns(const Blocks &blocks, int i, bool toShared);
+
+public:
+	/**
+	 * Creates the backend and limits BLAS to 1 thread, as forking a process with running BLAS
+	 * threads can deadlock its children.
+	 * @param nProcesses Quantity of child processes per step.
+	 */
+	ProcessesBackend(int nProcesses);
+	/**
+	 * Releases the shared mapping.
+	 */
+	~ProcessesBackend();
+
+	bool sharesMemory() const;
+	bool evaluate(const Blocks &blocks, const function<void(int, int)> &evaluate);
+};
+
+#endif /* PROCESSESBACKEND_H_ */
@@ -0,0 +1,13 @@
+/*
+ * SerialBackend.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "SerialBackend.h"
+
+bool SerialBackend::evaluate(const Blocks &blocks, const function<void(int, int)> &evaluate) {
+	for (int i = 0; i < blocks.nSigma; i++)
+		evaluate(i, 0);
+	return true;
+}
@@ -0,0 +1,20 @@
+/*
+ * SerialBackend.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef SERIALBACKEND_H_
+#define SERIALBACKEND_H_
+
+#include "AbstractExecutionBackend.h"
+
+/**
+ * Evaluates the sigma points one after the other in the calling thread.
+ */
+class SerialBackend: public AbstractExecutionBackend {
+public:
+	bool evaluate(const Blocks &blocks, const function<void(int, int)> &evaluate);
+};
+
+#endif /* SERIALBACKEND_H_ */
@@ -0,0 +1,233 @@
+/*
+ * SigmaPointsExchange.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "SigmaPointsExchange.h"
+
+#include <climits>
+#include <cstring>
+#include <iostream>
+
+SigmaPointsExchange::SigmaPointsExchange() {
+	mastersComm = MPI_COMM_NULL;
+	broadcastComm = MPI_COMM_NULL;
+	Xk = NULL;
+	nStates = 0;
+	nParameters = 0;
+	nObservations = 0;
+	nSigma = 0;
+	singlePrecision = false;
+	packedBytes = 0;
+	statesColumn = MPI_DATATYPE_NULL;
+	packedColumn = MPI_DATATYPE_NULL;
+	persistent = false;
+	for (int i = 0; i < 2; ++i) {
+		statesRequests[i] = MPI_REQUEST_NULL;
+		packedRequests[i] = MPI_REQUEST_NULL;
+	}
+}
+
+SigmaPointsExchange::~SigmaPointsExchange() {
+	int finalized;
+	MPI_Finalized(&finalized);
+	if (!finalized)
+		release();
+}
+
+void SigmaPointsExchange::release() {
+	if (persistent) {
+		for (int i = 0; i < 2; ++i) {
+			if (statesRequests[i] != MPI_REQUEST_NULL)
+				MPI_Request_free(&statesRequests[i]);
+			if (packedRequests[i] != MPI_REQUEST_NULL)
+				MPI_Request_free(&packedRequests[i]);
+		}
+	}
+	persistent = false;
+	if (statesColumn != MPI_DATATYPE_NULL)
+		MPI_Type_free(&statesColumn);
+	if (packedColumn != MPI_DATATYPE_NULL)
+		MPI_Type_free(&packedColumn);
+	packedBytes = 0;
+}
+
+bool SigmaPointsExchange::setup(MPI_Comm masters_comm, MPI_Comm broadcast_comm, double* Xk,
+		int nStates, int nParameters, int nObservations, int nSigma, bool singlePrecision) {
+	if (packedBytes > 0 && masters_comm == mastersComm && broadcast_comm == broadcastComm
+			&& Xk == this->Xk && nStates == this->nStates && nParameters == this->nParameters
+			&& nObservations == this->nObservations && nSigma == this->nSigma
+			&& singlePrecision == this->singlePrecision)
+		return true;
+
+	release();
+	//	Counts of the messages are in columns, only the bytes of one packed column must fit an int
+	size_t bytes = nParameters * sizeof(double)
+			+ nObservations * (singlePrecision ? sizeof(float) : sizeof(double));
+	if (bytes > INT_MAX) {
+		cerr << "The parameters and observations of a sigma point exceed the size of an MPI message." << endl;
+		return false;
+	}
+
+	mastersComm = masters_comm;
+	broadcastComm = broadcast_comm;
+	this->Xk = Xk;
+	this->nStates = nStates;
+	this->nParameters = nParameters;
+	this->nObservations = nObservations;
+	this->nSigma = nSigma;
+	this->singlePrecision = singlePrecision;
+	packedBytes = bytes;
+	packed.assign(bytes * nSigma, 0);
+	states.assign(singlePrecision ? (size_t) nStates * nSigma : 0, 0.f);
+
+	//	One element of these types is the column of a sigma point, so that no count overflows
+	if (nStates > 0) {
+		MPI_Type_contiguous(nStates, singlePrecision ? MPI_FLOAT : MPI_DOUBLE, &statesColumn);
+		MPI_Type_commit(&statesColumn);
+	}
+	MPI_Type_contiguous(packedBytes, MPI_BYTE, &packedColumn);
+	MPI_Type_commit(&packedColumn);
+
+#if MPI_VERSION >= 4
+	if (mastersComm != MPI_COMM_NULL) {
+		if (nStates > 0)
+			MPI_Allgather_init(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, statesBuffer(), 1, statesColumn,
+					mastersComm, MPI_INFO_NULL, &statesRequests[0]);
+		MPI_Allgather_init(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, &(packed[0]), 1, packedColumn,
+				mastersComm, MPI_INFO_NULL, &packedRequests[0]);
+	}
+	if (broadcastComm != MPI_COMM_NULL) {
+		if (nStates > 0)
+			MPI_Bcast_init(statesBuffer(), nSigma, statesColumn, 0, broadcastComm, MPI_INFO_NULL,
+					&statesRequests[1]);
+		MPI_Bcast_init(&(packed[0]), nSigma, packedColumn, 0, broadcastComm, MPI_INFO_NULL,
+				&packedRequests[1]);
+	}
+	persistent = true;
+#endif
+	return true;
+}
+
+void *SigmaPointsExchange::statesBuffer() {
+	return singlePrecision ? (void *) &(states[0]) : (void *) Xk;
+}
+
+void SigmaPointsExchange::start() {
+	//	The large states message is started first, the packed one overtakes it.
+	if (nStates > 0)
+		begin(statesRequests, statesBuffer(), statesColumn);
+	begin(packedRequests, &(packed[0]), packedColumn);
+}
+
+void SigmaPointsExchange::pack(int sigmaPoint, const double* thetak, const double* zk) {
+	char *column = &(packed[(size_t) packedBytes * sigmaPoint]);
+	memcpy(column, thetak, nParameters * sizeof(double));
+	column += nParameters * sizeof(double);
+	if (!singlePrecision) {
+		memcpy(column, zk, nObservations * sizeof(double));
+		return;
+	}
+
+	float *zkf = (float *) column;
+	for (int j = 0; j < nObservations; ++j)
+		zkf[j] = zk[j];
+	const double *xk = Xk + (size_t) nStates * sigmaPoint;
+	float *xkf = &(states[(size_t) nStates * sigmaPoint]);
+	for (int j = 0; j < nStates; ++j)
+		xkf[j] = xk[j];
+}
+
+void SigmaPointsExchange::waitParametersAndObservations(double* Thetak, double* Zk) {
+	complete(packedRequests, &(packed[0]), packedColumn);
+
+	const char *column = &(packed[0]);
+	for (int i = 0; i < nSigma; ++i) {
+		memcpy(Thetak + (size_t) i * nParameters, column, nParameters * sizeof(double));
+		const char *zk = column + nParameters * sizeof(double);
+		double *Zki = Zk + (size_t) i * nObservations;
+		if (singlePrecision) {
+			const float *zkf = (const float *) zk;
+			for (int j = 0; j < nObservations; ++j)
+				Zki[j] = zkf[j];
+		} else
+			memcpy(Zki, zk, nObservations * sizeof(double));
+		column += packedBytes;
+	}
+}
+
+void SigmaPointsExchange::waitStates() {
+	if (nStates == 0)
+		return;
+	complete(statesRequests, statesBuffer(), statesColumn);
+	if (singlePrecision)
+		for (size_t j = 0; j < states.size(); ++j)
+			Xk[j] = states[j];
+}
+
+void SigmaPointsExchange::begin(MPI_Request* requests, void* buffer, MPI_Datatype column) {
+	if (mastersComm == MPI_COMM_NULL)
+		return;
+	if (persistent)
+		MPI_Start(&requests[0]);
+	else
+		MPI_Iallgather(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, buffer, 1, column,
+				mastersComm, &requests[0]);
+}
+
+void SigmaPointsExchange::complete(MPI_Request* requests, void* buffer, MPI_Datatype column) {
+	if (mastersComm != MPI_COMM_NULL)
+		MPI_Wait(&requests[0], MPI_STATUS_IGNORE);
+
+	//	Masters forward the sigma points to the workers of the solvers.
+	if (broadcastComm != MPI_COMM_NULL) {
+		if (persistent)
+			MPI_Start(&requests[1]);
+		else
+			MPI_Ibcast(buffer, nSigma, column, 0, broadcastComm, &requests[1]);
+		MPI_Wait(&requests[1], MPI_STATUS_IGNORE);
+	}
+}
+
+void SigmaPointsExchange::gatherAndBroadcast(double* block, int rows, int nSigma, int sigmaPoint,
+		MPI_Comm masters_comm, MPI_Comm world_comm, bool singlePrecision, vector<float>& buffer) {
+	int rank = 0;
+	if (masters_comm != MPI_COMM_NULL)
+		MPI_Comm_rank(masters_comm, &rank);
+	const size_t n = (size_t) rows * nSigma;
+
+	//	The block is broadcast as nSigma columns, since rows * nSigma may not fit an int
+	MPI_Datatype column;
+	MPI_Type_contiguous(rows, singlePrecision ? MPI_FLOAT : MPI_DOUBLE, &column);
+	MPI_Type_commit(&column);
+
+	if (!singlePrecision) {
+		//	The main master already holds its sigma point in place.
+		if (masters_comm != MPI_COMM_NULL) {
+			if (rank == 0)
+				MPI_Gather(MPI_IN_PLACE, 1, column, block, 1, column, 0, masters_comm);
+			else
+				MPI_Gather(block + (size_t) rows * sigmaPoint, 1, column, NULL, 1, column, 0, masters_comm);
+		}
+		MPI_Bcast(block, nSigma, column, 0, world_comm);
+		MPI_Type_free(&column);
+		return;
+	}
+
+	buffer.resize(n);
+	if (masters_comm != MPI_COMM_NULL) {
+		float *columnf = &(buffer[(size_t) rows * sigmaPoint]);
+		const double *source = block + (size_t) rows * sigmaPoint;
+		for (int j = 0; j < rows; ++j)
+			columnf[j] = source[j];
+		if (rank == 0)
+			MPI_Gather(MPI_IN_PLACE, 1, column, &(buffer[0]), 1, column, 0, masters_comm);
+		else
+			MPI_Gather(columnf, 1, column, NULL, 1, column, 0, masters_comm);
+	}
+	MPI_Bcast(&(buffer[0]), nSigma, column, 0, world_comm);
+	MPI_Type_free(&column);
+	for (size_t j = 0; j < n; ++j)
+		block[j] = buffer[j];
+}
@@ -0,0 +1,167 @@
+/*
+ * SigmaPointsExchange.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef SIGMAPOINTSEXCHANGE_H_
+#define SIGMAPOINTSEXCHANGE_H_
+
+#include <mpi.h>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Exchange of the evaluated sigma points among the MPI solvers with allgather-style collectives.
+ * The parameters and observations of each sigma point are packed in a single message, which
+ * travels in a collective of its own so that it completes while the (larger) states are still
+ * in flight. The collectives are persistent when the MPI library supports them (MPI >= 4) and
+ * non-blocking otherwise. They are set up once, since the message sizes never change.
+ *
+ * In single precision, states and observations travel as floats, halving the message sizes,
+ * and all processes receive the same rounded values (including the sender of each column).
+ *
+ * The master of the solver of sigma point i must have rank i in the masters communicator.
+ */
+class SigmaPointsExchange {
+public:
+	/**	Exchange of the sigma points among the MPI solvers in executeStepParallel. */
+	enum COMMUNICATION_MODE {
+		/**	Gathers each block at the main master and broadcasts it to all processes. */
+		GATHER_BROADCAST,
+		/**	Allgathers the blocks among the masters with this class, overlapping the states
+		 * transfer with the update of the parameters. */
+		ALLGATHER
+	};
+
+private:
+	/**	Communicator of the master MPI processes of each sigma point. */
+	MPI_Comm mastersComm;
+	/**	Communicator used to broadcast the sigma points from its rank 0 to the workers. */
+	MPI_Comm broadcastComm;
+	/**	States of all sigma points as columns, owned by the caller. */
+	double *Xk;
+	/**	Quantity of states. */
+	int nStates;
+	/**	Quantity of parameters. */
+	int nParameters;
+	/**	Quantity of observations. */
+	int nObservations;
+	/**	Quantity of sigma points. */
+	int nSigma;
+	/**	If states and observations are sent in single precision. */
+	bool singlePrecision;
+	/**	Bytes of the parameters and observations of one sigma point in @p packed , 0 if the
+	 * exchange is not set up. */
+	int packedBytes;
+	/**	Parameters and observations of all sigma points, packed per column. */
+	vector<char> packed;
+	/**	States of all sigma points in single precision, empty in double precision. */
+	vector<float> states;
+
+	/**	MPI type of the states of one sigma point. */
+	MPI_Datatype statesColumn;
+	/**	MPI type of the packed parameters and observations of one sigma point. */
+	MPI_Datatype packedColumn;
+
+	/**	Requests of the states exchange (allgather among masters, broadcast to workers). */
+	MPI_Request statesRequests[2];
+	/**	Requests of the packed parameters and observations exchange. */
+	MPI_Request packedRequests[2];
+	/**	If the requests are persistent and must be freed. */
+	bool persistent;
+
+	/**
+	 * Releases the persistent requests and the column types.
+	 */
+	void release();
+	/**
+	 * Starts one of the exchanges.
+	 * @param requests Requests of the exchange.
+	 * @param buffer Buffer with one column per sigma point.
+	 * @param column MPI type of the column of a sigma point.
+	 */
+	void begin(MPI_Request *requests, void *buffer, MPI_Datatype column);
+	/**
+	 * Waits for one of the exchanges and broadcasts it to the workers.
+	 * @param requests Requests of the exchange.
+	 * @param buffer Buffer with one column per sigma point.
+	 * @param column MPI type of the column of a sigma point.
+	 */
+	void complete(MPI_Request *requests, void *buffer, MPI_Datatype column);
+	/**
+	 * Returns the buffer that travels with the states.
+	 * @return @p states in single precision, @p Xk otherwise.
+	 */
+	void *statesBuffer();
+
+public:
+	/**
+	 * Creates an exchange that is not set up.
+	 */
+	SigmaPointsExchange();
+	/**
+	 * Releases the persistent requests and the column types.
+	 */
+	~SigmaPointsExchange();
+
+	/**
+	 * Sets up the exchange. Nothing is done if it is already set up with the same arguments.
+	 * @param masters_comm Communicator of the master MPI processes of each sigma point.
+	 * @param broadcast_comm Communicator whose rank 0 is a master, used to reach the workers.
+	 * @param Xk States of all sigma points as columns (nStates x nSigma).
+	 * @param nStates Quantity of states (0 if the states are not exchanged).
+	 * @param nParameters Quantity of parameters.
+	 * @param nObservations Quantity of observations.
+	 * @param nSigma Quantity of sigma points.
+	 * @param singlePrecision If states and observations are sent in single precision.
+	 * @return If the exchange could be set up, the parameters and observations of a sigma point
+	 * must fit in a single MPI message.
+	 */
+	bool setup(MPI_Comm masters_comm, MPI_Comm broadcast_comm, double *Xk, int nStates,
+			int nParameters, int nObservations, int nSigma, bool singlePrecision = false);
+
+	/**
+	 * Starts the exchange. Masters must have written their states in their column of @p Xk
+	 * and their parameters and observations with pack.
+	 */
+	void start();
+	/**
+	 * Packs the parameters and observations of a sigma point evaluated in this process (and its
+	 * states in single precision).
+	 * @param sigmaPoint Index of the sigma point.
+	 * @param thetak Parameters of the sigma point.
+	 * @param zk Observations of the sigma point.
+	 */
+	void pack(int sigmaPoint, const double *thetak, const double *zk);
+	/**
+	 * Waits for the parameters and observations of all sigma points and unpacks them.
+	 * @param Thetak Output parameters of all sigma points as columns.
+	 * @param Zk Output observations of all sigma points as columns.
+	 */
+	void waitParametersAndObservations(double *Thetak, double *Zk);
+	/**
+	 * Waits for the states of all sigma points, received in place in @p Xk .
+	 */
+	void waitStates();
+
+	/**
+	 * Exchanges one block of the sigma points in the GATHER_BROADCAST mode: the columns are
+	 * gathered at the main master and broadcast to all processes.
+	 * @param block Column-major matrix with one column per sigma point, where this process
+	 * holds the column @p sigmaPoint .
+	 * @param rows Rows of @p block .
+	 * @param nSigma Quantity of sigma points.
+	 * @param sigmaPoint Sigma point evaluated by this process.
+	 * @param masters_comm Communicator of the master MPI processes of each sigma point.
+	 * @param world_comm Communicator used to broadcast the block from its rank 0.
+	 * @param singlePrecision If the columns are sent in single precision (all processes then
+	 * hold the same rounded values).
+	 * @param buffer Scratch buffer for the single precision messages.
+	 */
+	static void gatherAndBroadcast(double *block, int rows, int nSigma, int sigmaPoint,
+			MPI_Comm masters_comm, MPI_Comm world_comm, bool singlePrecision, vector<float> &buffer);
+};
+
+#endif /* SIGMAPOINTSEXCHANGE_H_ */
@@ -0,0 +1,155 @@
+/*
+ * SigmaPointsScheduler.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "SigmaPointsScheduler.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+SigmaPointsScheduler::SigmaPointsScheduler() {
+	groupComm = MPI_COMM_NULL;
+	mastersComm = MPI_COMM_NULL;
+	counterWindow = MPI_WIN_NULL;
+	counter = NULL;
+	nSigma = 0;
+}
+
+SigmaPointsScheduler::~SigmaPointsScheduler() {
+	int finalized;
+	MPI_Finalized(&finalized);
+	if (!finalized)
+		release();
+}
+
+void SigmaPointsScheduler::release() {
+	if (counterWindow != MPI_WIN_NULL) {
+		MPI_Win_unlock_all(counterWindow);
+		MPI_Win_free(&counterWindow);
+	}
+	counter = NULL;
+}
+
+void SigmaPointsScheduler::setup(MPI_Comm group_comm, MPI_Comm masters_comm, int nSigma) {
+	if (group_comm == groupComm && masters_comm == mastersComm && nSigma == this->nSigma)
+		return;
+
+	release();
+	groupComm = group_comm;
+	mastersComm = masters_comm;
+	this->nSigma = nSigma;
+
+	queue.resize(nSigma);
+	for (int i = 0; i < nSigma; ++i)
+		queue[i] = i;
+	timings.assign(nSigma, 0.);
+	owned.assign(nSigma, 0);
+
+	if (mastersComm != MPI_COMM_NULL) {
+		int rank;
+		MPI_Comm_rank(mastersComm, &rank);
+		MPI_Aint size = rank == 0 ? sizeof(int) : 0;
+		MPI_Win_allocate(size, sizeof(int), MPI_INFO_NULL, mastersComm, &counter, &counterWindow);
+		MPI_Win_lock_all(0, counterWindow);
+	}
+}
+
+void SigmaPointsScheduler::sortQueue() {
+	const vector<double> &t = timings;
+	stable_sort(queue.begin(), queue.end(), [&t](int a, int b) {return t[a] > t[b];});
+}
+
+void SigmaPointsScheduler::run(const function<void(int, int)> &evaluate, ThreadPool *pool) {
+	int chunk = pool ? pool->getThreads() : 1;
+	vector<int> taken(chunk);
+	vector<double> elapsed(chunk);
+	fill(owned.begin(), owned.end(), 0);
+
+	if (mastersComm != MPI_COMM_NULL) {
+		//	Resets the queue before any master takes work from it.
+		int zero = 0, previous;
+		MPI_Fetch_and_op(&zero, &previous, MPI_INT, 0, 0, MPI_REPLACE, counterWindow);
+		MPI_Win_flush(0, counterWindow);
+		MPI_Barrier(mastersComm);
+	}
+
+	while (true) {
+		//	The master takes the next sigma points of the queue and tells its workers.
+		if (mastersComm != MPI_COMM_NULL) {
+			int first;
+			MPI_Fetch_and_op(&chunk, &first, MPI_INT, 0, 0, MPI_SUM, counterWindow);
+			MPI_Win_flush(0, counterWindow);
+			for (int j = 0; j < chunk; ++j)
+				taken[j] = first + j < nSigma ? queue[first + j] : -1;
+		}
+		MPI_Bcast(&(taken[0]), chunk, MPI_INT, 0, groupComm);
+		if (taken[0] < 0)
+			break;
+
+		auto evaluateTaken = [&](int j, int thread) {
+			if (taken[j] < 0)
+				return;
+			double start = MPI_Wtime();
+			evaluate(taken[j], thread);
+			elapsed[j] = MPI_Wtime() - start;
+		};
+		if (pool)
+			pool->parallelFor(chunk, evaluateTaken);
+		else
+			evaluateTaken(0, 0);
+
+		for (int j = 0; j < chunk && taken[j] >= 0; ++j) {
+			owned[taken[j]] = 1;
+			timings[taken[j]] = elapsed[j];
+		}
+	}
+
+	//	Masters share the timings to order the queue of the next step.
+	if (mastersComm != MPI_COMM_NULL) {
+		for (int i = 0; i < nSigma; ++i)
+			if (!owned[i])
+				timings[i] = 0.;
+		MPI_Allreduce(MPI_IN_PLACE, &(timings[0]), nSigma, MPI_DOUBLE, MPI_SUM, mastersComm);
+		sortQueue();
+	}
+}
+
+void SigmaPointsScheduler::share(double* block, int rows, bool singlePrecision) {
+	if (mastersComm != MPI_COMM_NULL) {
+		//	Each column is owned by exactly one group, the others contribute exact zeros.
+		for (int i = 0; i < nSigma; ++i)
+			if (!owned[i])
+				memset(block + (size_t) i * rows, 0, rows * sizeof(double));
+	}
+	if (!singlePrecision) {
+		exchange(block, sizeof(double), rows, MPI_DOUBLE);
+		return;
+	}
+
+	const size_t n = (size_t) rows * nSigma;
+	payload.resize(n);
+	for (size_t j = 0; j < n; ++j)
+		payload[j] = block[j];
+	exchange(&(payload[0]), sizeof(float), rows, MPI_FLOAT);
+	for (size_t j = 0; j < n; ++j)
+		block[j] = payload[j];
+}
+
+void SigmaPointsScheduler::exchange(void* block, size_t elementBytes, int rows, MPI_Datatype type) {
+	//	Whole columns per message, so that rows * nSigma never overflows the int counts of MPI
+	int columns = max(1, min(nSigma, INT_MAX / max(rows, 1)));
+	for (int first = 0; first < nSigma; first += columns) {
+		char *part = (char *) block + elementBytes * rows * first;
+		int count = min(columns, nSigma - first) * rows;
+		if (mastersComm != MPI_COMM_NULL)
+			MPI_Allreduce(MPI_IN_PLACE, part, count, type, MPI_SUM, mastersComm);
+		MPI_Bcast(part, count, type, 0, groupComm);
+	}
+}
+
+const vector<double> &SigmaPointsScheduler::getTimings() const {
+	return timings;
+}
@@ -0,0 +1,107 @@
+/*
+ * SigmaPointsScheduler.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef SIGMAPOINTSSCHEDULER_H_
+#define SIGMAPOINTSSCHEDULER_H_
+
+#include <functional>
+#include <mpi.h>
+#include <vector>
+
+#include "ThreadPool.h"
+
+using namespace std;
+
+/**
+ * Dynamic distribution of the sigma points among any quantity of MPI solver groups. The masters
+ * of the groups take sigma points from a shared work queue (an atomic counter exposed through
+ * an MPI window on the rank 0 of the masters communicator) until it is empty, so faster groups
+ * evaluate more points. The queue is ordered longest-first according to the times recorded for
+ * each sigma point in the previous step.
+ */
+class SigmaPointsScheduler {
+	/**	Communicator of all MPI processes of this solver group. */
+	MPI_Comm groupComm;
+	/**	Communicator of the master MPI processes of each group, MPI_COMM_NULL in the workers. */
+	MPI_Comm mastersComm;
+	/**	Window exposing the queue counter. */
+	MPI_Win counterWindow;
+	/**	Memory of the queue counter (only meaningful in rank 0 of @p mastersComm ). */
+	int *counter;
+	/**	Quantity of sigma points. */
+	int nSigma;
+
+	/**	Sigma points in the order they are handed out. */
+	vector<int> queue;
+	/**	Time spent by the forward and observation operators in each sigma point at the last step. */
+	vector<double> timings;
+	/**	If each sigma point was evaluated by this group in the current step. */
+	vector<char> owned;
+	/**	Single precision copy of the shared block. */
+	vector<float> payload;
+
+	/**
+	 * Releases the counter window.
+	 */
+	void release();
+	/**
+	 * Sorts @p queue by decreasing @p timings .
+	 */
+	void sortQueue();
+	/**
+	 * Sums the columns of all groups among the masters and broadcasts them to the workers.
+	 * @param block Column-major matrix with one column per sigma point.
+	 * @param elementBytes Bytes of an element of @p block .
+	 * @param rows Rows of @p block .
+	 * @param type MPI type of the elements.
+	 */
+	void exchange(void *block, size_t elementBytes, int rows, MPI_Datatype type);
+
+public:
+	/**
+	 * Creates a scheduler that is not set up.
+	 */
+	SigmaPointsScheduler();
+	/**
+	 * Releases the counter window.
+	 */
+	~SigmaPointsScheduler();
+
+	/**
+	 * Sets up the scheduler. Nothing is done if it is already set up with the same arguments.
+	 * Collective over all processes of all groups.
+	 * @param group_comm Communicator of all MPI processes of this solver group (rank 0 is the master).
+	 * @param masters_comm Communicator of the master MPI processes of each group.
+	 * @param nSigma Quantity of sigma points.
+	 */
+	void setup(MPI_Comm group_comm, MPI_Comm masters_comm, int nSigma);
+
+	/**
+	 * Evaluates all sigma points among the groups. Every process of a group calls
+	 * @p evaluate(i, threadId) for the sigma points taken by its group. If @p pool is not NULL,
+	 * each group takes as many sigma points as threads at a time and evaluates them concurrently.
+	 * @param evaluate Function that evaluates one sigma point.
+	 * @param pool Pool of threads of this process, or NULL.
+	 */
+	void run(const function<void(int, int)> &evaluate, ThreadPool *pool);
+
+	/**
+	 * Shares the columns evaluated by each group, so that all processes hold every column.
+	 * @param block Column-major matrix with one column per sigma point.
+	 * @param rows Rows of @p block .
+	 * @param singlePrecision If the columns are sent in single precision (all processes then
+	 * hold the same rounded values).
+	 */
+	void share(double *block, int rows, bool singlePrecision = false);
+
+	/**
+	 * Returns the time spent in each sigma point at the last step.
+	 * @return Time in seconds of each sigma point.
+	 */
+	const vector<double> &getTimings() const;
+};
+
+#endif /* SIGMAPOINTSSCHEDULER_H_ */
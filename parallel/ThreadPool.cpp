@@ -0,0 +1,138 @@
+/*
+ * ThreadPool.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "ThreadPool.h"
+
+#include <cstdlib>
+#include <string>
+
+//	Thread controls of the usual BLAS backends. Declared weak so that only the symbols of the
+//	backend actually linked are resolved.
+extern "C" {
+void openblas_set_num_threads(int) __attribute__((weak));
+void MKL_Set_Num_Threads(int) __attribute__((weak));
+void bli_thread_set_num_threads(long) __attribute__((weak));
+void omp_set_num_threads(int) __attribute__((weak));
+}
+
+atomic<int> ThreadPool::liveWorkers(0);
+
+ThreadPool::ThreadPool(int nThreads) {
+	task = NULL;
+	nTasks = 0;
+	nextTask = 0;
+	activeWorkers = 0;
+	generation = 0;
+	stopping = false;
+
+	for (int i = 1; i < nThreads; ++i)
+		workers.push_back(thread(&ThreadPool::workerLoop, this, i));
+	liveWorkers += workers.size();
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		lock_guard<mutex> lock(loopMutex);
+		stopping = true;
+	}
+	loopPosted.notify_all();
+	for (unsigned int i = 0; i < workers.size(); ++i)
+		workers[i].join();
+	liveWorkers -= workers.size();
+}
+
+int ThreadPool::getThreads() const {
+	return workers.size() + 1;
+}
+
+void ThreadPool::parallelFor(int nTasks, const function<void(int, int)> &task) {
+	if (workers.empty()) {
+		for (int i = 0; i < nTasks; ++i)
+			task(i, 0);
+		return;
+	}
+
+	{
+		lock_guard<mutex> lock(loopMutex);
+		this->task = &task;
+		this->nTasks = nTasks;
+		nextTask = 0;
+		activeWorkers = workers.size();
+		taskException = NULL;
+		++generation;
+	}
+	loopPosted.notify_all();
+
+	consumeTasks(0);
+
+	unique_lock<mutex> lock(loopMutex);
+	loopFinished.wait(lock, [this] {return activeWorkers == 0;});
+	this->task = NULL;
+	if (taskException)
+		rethrow_exception(taskException);
+}
+
+void ThreadPool::workerLoop(int threadId) {
+	long long int lastGeneration = 0;
+	while (true) {
+		{
+			unique_lock<mutex> lock(loopMutex);
+			loopPosted.wait(lock, [this, lastGeneration] {return stopping || generation != lastGeneration;});
+			if (stopping)
+				return;
+			lastGeneration = generation;
+		}
+
+		consumeTasks(threadId);
+
+		{
+			lock_guard<mutex> lock(loopMutex);
+			--activeWorkers;
+		}
+		loopFinished.notify_one();
+	}
+}
+
+void ThreadPool::consumeTasks(int threadId) {
+	while (true) {
+		int i;
+		{
+			lock_guard<mutex> lock(loopMutex);
+			if (nextTask >= nTasks)
+				return;
+			i = nextTask++;
+		}
+		try {
+			(*task)(i, threadId);
+		} catch (...) {
+			lock_guard<mutex> lock(loopMutex);
+			if (!taskException)
+				taskException = current_exception();
+			nextTask = nTasks;
+		}
+	}
+}
+
+int ThreadPool::getLiveWorkers() {
+	return liveWorkers;
+}
+
+void ThreadPool::setBLASThreads(int nThreads) {
+	//	Backends not yet initialized read their environment variables.
+	string value = to_string(nThreads);
+	setenv("OPENBLAS_NUM_THREADS", value.c_str(), 1);
+	setenv("MKL_NUM_THREADS", value.c_str(), 1);
+	setenv("BLIS_NUM_THREADS", value.c_str(), 1);
+
+	if (openblas_set_num_threads)
+		openblas_set_num_threads(nThreads);
+	if (MKL_Set_Num_Threads)
+		MKL_Set_Num_Threads(nThreads);
+	if (bli_thread_set_num_threads)
+		bli_thread_set_num_threads(nThreads);
+	if (omp_set_num_threads)
+		omp_set_num_threads(nThreads);
+}
@@ -0,0 +1,104 @@
+/*
+ * ThreadPool.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Fixed-size pool of threads that executes indexed tasks in shared memory. It is used
+ * to evaluate the sigma points of one filter step concurrently.
+ */
+class ThreadPool {
+	/**	Worker threads. The calling thread acts as the thread 0 of each parallel loop. */
+	vector<thread> workers;
+	/**	Guards the state of the current parallel loop. */
+	mutex loopMutex;
+	/**	Wakes up the workers when a new parallel loop is posted. */
+	condition_variable loopPosted;
+	/**	Notifies the caller when all workers left the current parallel loop. */
+	condition_variable loopFinished;
+
+	/**	Task of the current parallel loop. */
+	const function<void(int, int)> *task;
+	/**	Quantity of tasks in the current parallel loop. */
+	int nTasks;
+	/**	Next task to be executed in the current parallel loop. */
+	int nextTask;
+	/**	Quantity of workers still inside the current parallel loop. */
+	int activeWorkers;
+	/**	Counter of posted parallel loops, used to wake up the workers once per loop. */
+	long long int generation;
+	/**	If the pool is being destroyed. */
+	bool stopping;
+	/**	First exception thrown by a task of the current parallel loop. */
+	exception_ptr taskException;
+	/**	Worker threads of all the pools of the process. */
+	static atomic<int> liveWorkers;
+
+	/**
+	 * Main loop of the worker threads.
+	 * @param threadId Identifier of the worker thread.
+	 */
+	void workerLoop(int threadId);
+	/**
+	 * Executes tasks of the current loop until none is left.
+	 * @param threadId Identifier of the executing thread.
+	 */
+	void consumeTasks(int threadId);
+
+public:
+	/**
+	 * Creates the pool with @p nThreads threads, including the calling thread.
+	 * @param nThreads Quantity of threads that execute each parallel loop.
+	 */
+	ThreadPool(int nThreads);
+	/**
+	 * Joins all worker threads.
+	 */
+	~ThreadPool();
+
+	/**
+	 * Executes @p task(i, threadId) for each i in [0, @p nTasks). Tasks are handed out
+	 * dynamically in increasing order of i and the call returns when all of them finished.
+	 * The @p threadId argument is in [0, getThreads()) and may be used to index per-thread
+	 * scratch buffers.
+	 * @param nTasks Quantity of tasks.
+	 * @param task Function executed for each task.
+	 */
+	void parallelFor(int nTasks, const function<void(int, int)> &task);
+
+	/**
+	 * Returns the quantity of threads that execute each parallel loop.
+	 * @return Quantity of threads.
+	 */
+	int getThreads() const;
+
+	/**
+	 * Limits the threads used internally by the BLAS/LAPACK backend of Armadillo
+	 * (OpenBLAS, MKL, BLIS or OpenMP based), in order to avoid oversubscription of the
+	 * cores when the sigma points are evaluated with a ThreadPool.
+	 * @param nThreads Maximum quantity of BLAS threads.
+	 */
+	static void setBLASThreads(int nThreads);
+	/**
+	 * Returns the quantity of worker threads of all the pools of the process, which must be 0
+	 * before forking it.
+	 * @return Quantity of worker threads.
+	 */
+	static int getLiveWorkers();
+};
+
+#endif /* THREADPOOL_H_ */
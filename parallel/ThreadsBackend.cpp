@@ -0,0 +1,24 @@
+/*
+ * ThreadsBackend.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "ThreadsBackend.h"
+
+ThreadsBackend::ThreadsBackend(int nThreads) :
+		AbstractExecutionBackend(), pool(nThreads) {
+}
+
+int ThreadsBackend::getThreads() const {
+	return pool.getThreads();
+}
+
+ThreadPool *ThreadsBackend::getThreadPool() {
+	return &pool;
+}
+
+bool ThreadsBackend::evaluate(const Blocks &blocks, const function<void(int, int)> &evaluate) {
+	pool.parallelFor(blocks.nSigma, evaluate);
+	return true;
+}
@@ -0,0 +1,33 @@
+/*
+ * ThreadsBackend.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef THREADSBACKEND_H_
+#define THREADSBACKEND_H_
+
+#include "AbstractExecutionBackend.h"
+#include "ThreadPool.h"
+
+/**
+ * Evaluates the sigma points concurrently with a pool of threads. The operators must be
+ * reentrant. The results do not depend on the quantity of threads.
+ */
+class ThreadsBackend: public AbstractExecutionBackend {
+	/**	Pool of threads that evaluates the sigma points. */
+	ThreadPool pool;
+
+public:
+	/**
+	 * Starts the pool of threads.
+	 * @param nThreads Quantity of threads.
+	 */
+	ThreadsBackend(int nThreads);
+
+	int getThreads() const;
+	ThreadPool *getThreadPool();
+	bool evaluate(const Blocks &blocks, const function<void(int, int)> &evaluate);
+};
+
+#endif /* THREADSBACKEND_H_ */
@@ -0,0 +1,498 @@
+/*
+ * KFPy.cpp
+ *
+ *	Python bindings of the library (module kfpy).
+ *
+ *	The estimates of the filters are exposed as NumPy views over the memory of the filter, hence
+ *	they are not copied but they are only valid until the filter is reset or restored from a
+ *	checkpoint. The GIL is released while the filter works and reacquired only to call the Python
+ *	operators. The operators fill their output arrays in place; these arrays are views over the
+ *	workspace of the step, only valid during the call, hence an operator that keeps one (or a
+ *	slice of it) fails the step with a RuntimeError and must keep a copy instead. A failed operator
+ *	leaves the estimate unchanged, its exception is raised once the step ends:
+ *
+ *	@code
+ *	def forward(x, theta):			# one sigma point, x is advanced in place
+ *		x[:] = decay(theta) * x
+ *	def observe(x, z):
+ *		z[:] = x[::10]
+ *	error = kf.execute_step(observations, forward, observe)
+ *
+ *	def forward_batch(X, Theta):	# all sigma points, one per row
+ *		X[:] *= decay(Theta)
+ *	def observe_batch(X, Z):
+ *		Z[:] = X[:, ::10]
+ *	error = kf.execute_step_batch(observations, forward_batch, observe_batch)
+ *	@endcode
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <algorithm>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <string>
+#include <vector>
+
+#include "../AbstractROUKF.h"
+#include "../MappedROUKF.h"
+#include "../ROUKF.h"
+#include "../StaticROUKF.h"
+#include "../io/ConfigurationFileReader.h"
+#include "../mapping/AbstractParameterMapper.h"
+#include "../mapping/CompositeParameterMapper.h"
+#include "../mapping/ExponentialParameterMapper.h"
+#include "../mapping/IdentityParameterMapper.h"
+#include "../mapping/SigmoidParameterMapper.h"
+
+namespace py = pybind11;
+using namespace std;
+
+/**	Arrays accepted from Python, converted to contiguous doubles if needed. */
+typedef py::array_t<double, py::array::c_style | py::array::forcecast> DoubleArray;
+
+/**
+ * Python operators of a step. The filter calls them through lambdas that capture this object,
+ * hence steps of several filters may run at once in different threads.
+ */
+class PythonOperators {
+	/**	Forward operator. */
+	py::function forward;
+	/**	Observation operator. */
+	py::function observation;
+	/**	First exception raised by the operators, rethrown when the step ends. */
+	exception_ptr error;
+
+	/**
+	 * Returns the references held to an argument of an operator.
+	 * @param argument Argument.
+	 * @return Reference count.
+	 */
+	static py::ssize_t references(const py::handle &argument) {
+		return argument.ref_count();
+	}
+	/**
+	 * Returns 0 for the arguments that are not views.
+	 * @return 0.
+	 */
+	static py::ssize_t references(double) {
+		return 0;
+	}
+
+	/**
+	 * Returns a NumPy view over @p data without copying it, only valid during the operator call.
+	 * @param data Memory of the array.
+	 * @param rows Quantity of rows (sigma points), 0 for a one-dimensional array.
+	 * @param cols Quantity of elements per row.
+	 * @return Writable view.
+	 */
+	static py::array view(double *data, int rows, int cols) {
+		//	A dummy owner prevents the copy, the memory belongs to the filter.
+		py::capsule owner(data, [](void *) {});
+		if (rows == 0)
+			return py::array_t<double>({ (py::ssize_t) cols }, { (py::ssize_t) sizeof(double) }, data, owner);
+		return py::array_t<double>({ (py::ssize_t) rows, (py::ssize_t) cols },
+				{ (py::ssize_t) (cols * sizeof(double)), (py::ssize_t) sizeof(double) }, data, owner);
+	}
+
+	/**
+	 * Calls a Python operator, recording its exception instead of raising it across the filter.
+	 * A view still referenced after the call (kept by the operator, directly or through a slice)
+	 * is recorded as a RuntimeError, as its memory is reused by the filter. The GIL must be held.
+	 * @param op Operator.
+	 * @param args Arguments of the operator.
+	 * @return 0, or -1 if the operator raised an exception (now or in a previous call).
+	 */
+	template<typename... Args>
+	int call(py::function &op, const Args &... args) {
+		if (error)
+			return -1;
+		const py::ssize_t before[] = { references(args)... };
+		try {
+			op(args...);
+		} catch (...) {
+			error = current_exception();
+			return -1;
+		}
+		const py::ssize_t after[] = { references(args)... };
+		for (size_t i = 0; i < sizeof...(Args); ++i)
+			if (after[i] != before[i]) {
+				error = make_exception_ptr(runtime_error("An operator kept a reference to one of its "
+						"arrays, which are only valid during the call; keep a copy instead."));
+				return -1;
+			}
+		return 0;
+	}
+
+public:
+	/**
+	 * Sets the operators of a step.
+	 * @param forward Forward operator.
+	 * @param observation Observation operator.
+	 */
+	PythonOperators(py::function forward, py::function observation) {
+		this->forward = forward;
+		this->observation = observation;
+	}
+
+	/**
+	 * Executes @p step with the GIL released. The exception raised by an operator, if any, is
+	 * rethrown once the step ends.
+	 * @param step Filter step.
+	 * @return Result of the step.
+	 */
+	template<typename Step>
+	double run(Step step) {
+		double err;
+		{
+			py::gil_scoped_release release;
+			err = step();
+		}
+		if (error)
+			rethrow_exception(error);
+		return err;
+	}
+
+	/**
+	 * Returns if an operator raised an exception.
+	 * @return If the step must not go on.
+	 */
+	bool failed() const {
+		return (bool) error;
+	}
+
+	/**	Forward operator for one sigma point (forwardFunction). */
+	int forwardOne(double *x, int nStates, double *theta, int nParameters) {
+		py::gil_scoped_acquire acquire;
+		return call(forward, view(x, 0, nStates), view(theta, 0, nParameters));
+	}
+	/**	Forward operator for one sigma point up to an observation time (windowForwardFunction). */
+	int forwardWindow(double *x, int nStates, double *theta, int nParameters, double time) {
+		py::gil_scoped_acquire acquire;
+		return call(forward, view(x, 0, nStates), view(theta, 0, nParameters), time);
+	}
+	/**
+	 * Observation operator for one sigma point (observationFunction). If it fails, the
+	 * observations are set to NaN, which fails the step before the update.
+	 */
+	void observeOne(double *x, int nStates, double *z, int nObservations) {
+		py::gil_scoped_acquire acquire;
+		if (call(observation, view(x, 0, nStates), view(z, 0, nObservations)) < 0)
+			fill_n(z, nObservations, numeric_limits<double>::quiet_NaN());
+	}
+	/**	Forward operator for all sigma points (batchForwardFunction), one per row. */
+	int forwardBatch(double *X, int nStates, double *Theta, int nParameters, int nSigma) {
+		py::gil_scoped_acquire acquire;
+		return call(forward, view(X, nSigma, nStates), view(Theta, nSigma, nParameters));
+	}
+	/**
+	 * Observation operator for all sigma points (batchObservationFunction), one per row. If it
+	 * fails, the observations are set to NaN as in observeOne.
+	 */
+	void observeBatch(double *X, int nStates, double *Z, int nObservations, int nSigma) {
+		py::gil_scoped_acquire acquire;
+		if (call(observation, view(X, nSigma, nStates), view(Z, nSigma, nObservations)) < 0)
+			fill_n(Z, (size_t) nObservations * nSigma, numeric_limits<double>::quiet_NaN());
+	}
+};
+
+/**
+ * Returns a NumPy view over memory owned by a filter, that keeps the filter alive.
+ * @param data Memory of the array.
+ * @param n Quantity of elements.
+ * @param filter Python object of the filter.
+ * @return Writable view.
+ */
+static py::array filterView(double *data, int n, py::object filter) {
+	return py::array_t<double>({ (py::ssize_t) n }, { (py::ssize_t) sizeof(double) }, data, filter);
+}
+
+/**
+ * Checks the length of an array given to a filter.
+ * @param array Array.
+ * @param n Expected quantity of elements.
+ * @param name Name of the array for the error message.
+ */
+static void checkSize(const DoubleArray &array, int n, const char *name) {
+	if (array.size() != n)
+		throw py::value_error(string(name) + " must have " + to_string(n) + " elements.");
+}
+
+PYBIND11_MODULE(kfpy, m) {
+	m.doc() = "Reduced order unscented Kalman filters.";
+
+	py::enum_<SigmaPointsGenerator::SIGMA_DISTRIBUTION>(m, "SigmaDistribution")
+		.value("SIMPLEX", SigmaPointsGenerator::SIMPLEX)
+		.value("CANONIC", SigmaPointsGenerator::CANONIC)
+		.value("STAR", SigmaPointsGenerator::STAR)
+		.value("SIMPLEX_STAR", SigmaPointsGenerator::SIMPLEX_STAR);
+
+	//	Parameter mappers
+	py::class_<AbstractParameterMapper>(m, "AbstractParameterMapper")
+		.def("map", &AbstractParameterMapper::map, "Maps problem parameters into kalman parameters.")
+		.def("unmap", &AbstractParameterMapper::unmap, "Maps kalman parameters into problem parameters.")
+		.def("map_block", [](AbstractParameterMapper &mapper, py::array_t<double, py::array::c_style> block) {
+			py::buffer_info info = block.request(true);
+			int rows = info.ndim == 2 ? info.shape[0] : 1, cols = info.shape[info.ndim - 1];
+			mapper.mapBlock((double *) info.ptr, cols, rows, cols);
+		}, py::arg("block").noconvert(), "Maps in place a C-contiguous array with the parameters of one sigma point per row.")
+		.def("unmap_block", [](AbstractParameterMapper &mapper, py::array_t<double, py::array::c_style> block) {
+			py::buffer_info info = block.request(true);
+			int rows = info.ndim == 2 ? info.shape[0] : 1, cols = info.shape[info.ndim - 1];
+			mapper.unmapBlock((double *) info.ptr, cols, rows, cols);
+		}, py::arg("block").noconvert(), "Unmaps in place a C-contiguous array with the parameters of one sigma point per row.");
+	py::class_<IdentityParameterMapper, AbstractParameterMapper>(m, "IdentityParameterMapper")
+		.def(py::init<>());
+	py::class_<ExponentialParameterMapper, AbstractParameterMapper>(m, "ExponentialParameterMapper")
+		.def(py::init<>());
+	py::class_<SigmoidParameterMapper, AbstractParameterMapper>(m, "SigmoidParameterMapper")
+		.def(py::init<double, double>(), py::arg("min"), py::arg("max"));
+	py::class_<CompositeParameterMapper, AbstractParameterMapper>(m, "CompositeParameterMapper")
+		.def(py::init<vector<int>, vector<AbstractParameterMapper *> >(), py::arg("params_per_mapper"),
+				py::arg("mappers"), py::keep_alive<1, 3>());
+
+	//	Filters
+	py::class_<AbstractROUKF>(m, "AbstractROUKF", py::dynamic_attr())
+		.def("execute_step", [](AbstractROUKF &filter, DoubleArray observations, py::function forward,
+				py::function observation) {
+			checkSize(observations, filter.getObservations(), "observations");
+			PythonOperators operators(forward, observation);
+			return operators.run([&]() {
+				return filter.executeStep(observations.data(),
+						[&](double *x, int nStates, double *theta, int nParameters) {
+							return operators.forwardOne(x, nStates, theta, nParameters);
+						}, [&](double *x, int nStates, double *z, int nObservations) {
+							operators.observeOne(x, nStates, z, nObservations);
+						});
+			});
+		}, py::arg("observations"), py::arg("forward"), py::arg("observation"),
+				"Performs one step calling forward(x, theta) and observation(x, z) for each sigma point.")
+		.def("run", [](AbstractROUKF &filter, DoubleArray observations, py::function forward,
+				py::function observation, bool relative) {
+			checkSize(observations, filter.getObservations(), "observations");
+			PythonOperators operators(forward, observation);
+			AbstractROUKF::RUN_STATUS status = AbstractROUKF::FAILED;
+			operators.run([&]() {
+				status = filter.run([&]() {
+					double err = filter.executeStep(observations.data(),
+							[&](double *x, int nStates, double *theta, int nParameters) {
+								return operators.forwardOne(x, nStates, theta, nParameters);
+							}, [&](double *x, int nStates, double *z, int nObservations) {
+								operators.observeOne(x, nStates, z, nObservations);
+							});
+					return operators.failed() ? -1 : err;
+				}, relative);
+				return 0.;
+			});
+			return string(AbstractROUKF::getName(status));
+		}, py::arg("observations"), py::arg("forward"), py::arg("observation"), py::arg("relative") = true,
+				"Steps until convergence, stagnation, divergence or max_iterations and returns the reason.")
+		.def_property("stagnation_iterations", &AbstractROUKF::getStagnationIterations,
+				&AbstractROUKF::setStagnationIterations)
+		.def_property("divergence_factor", &AbstractROUKF::getDivergenceFactor, &AbstractROUKF::setDivergenceFactor)
+		.def("execute_step_window", [](AbstractROUKF &filter, DoubleArray observations, DoubleArray times,
+				py::function forward, py::function observation) {
+			checkSize(observations, filter.getObservations() * times.size(), "observations");
+			PythonOperators operators(forward, observation);
+			return operators.run([&]() {
+				return filter.executeStepWindow(observations.data(), times.data(), times.size(),
+						[&](double *x, int nStates, double *theta, int nParameters, double time) {
+							return operators.forwardWindow(x, nStates, theta, nParameters, time);
+						}, [&](double *x, int nStates, double *z, int nObservations) {
+							operators.observeOne(x, nStates, z, nObservations);
+						});
+			});
+		}, py::arg("observations"), py::arg("times"), py::arg("forward"), py::arg("observation"),
+				"Assimilates the observations of several times (one per row) in one update, calling "
+				"forward(x, theta, time) and observation(x, z) for each sigma point and time.")
+		.def("execute_step_batch", [](AbstractROUKF &filter, DoubleArray observations,
+				py::function forward, py::function observation) {
+			checkSize(observations, filter.getObservations(), "observations");
+			PythonOperators operators(forward, observation);
+			return operators.run([&]() {
+				return filter.executeStep(observations.data(),
+						[&](double *X, int nStates, double *Theta, int nParameters, int nSigma) {
+							return operators.forwardBatch(X, nStates, Theta, nParameters, nSigma);
+						}, [&](double *X, int nStates, double *Z, int nObservations, int nSigma) {
+							operators.observeBatch(X, nStates, Z, nObservations, nSigma);
+						});
+			});
+		}, py::arg("observations"), py::arg("forward"), py::arg("observation"),
+				"Performs one step calling forward(X, Theta) and observation(X, Z) once with all sigma points as rows.")
+		.def_property_readonly("state", [](py::object self) {
+			AbstractROUKF &filter = self.cast<AbstractROUKF &>();
+			double *x;
+			filter.getState(&x);
+			return filterView(x, filter.getStatePropagation() == AbstractROUKF::PROPAGATED ? filter.getStates() : 0, self);
+		}, "View of the states.")
+		.def_property_readonly("theta", [](py::object self) {
+			AbstractROUKF &filter = self.cast<AbstractROUKF &>();
+			double *theta;
+			filter.AbstractROUKF::getParameters(&theta);
+			return filterView(theta, filter.getParametersStd().size(), self);
+		}, "View of the parameters in the kalman space (mapped).")
+		.def_property_readonly("error", [](py::object self) {
+			AbstractROUKF &filter = self.cast<AbstractROUKF &>();
+			double *err;
+			filter.getError(&err);
+			return filterView(err, filter.getObservations(), self);
+		}, "View of the error of each observation at the last step.")
+		.def("set_state", [](AbstractROUKF &filter, DoubleArray x) {
+			checkSize(x, filter.getStates(), "x");
+			filter.setState(const_cast<double *>(x.data()));
+		})
+		.def("get_parameters", [](AbstractROUKF &filter) {
+			DoubleArray theta(filter.getParametersStd().size());
+			filter.copyParameters(theta.mutable_data());
+			return theta;
+		}, "Copy of the parameters in the problem space.")
+		.def("set_parameters", [](AbstractROUKF &filter, DoubleArray theta) {
+			checkSize(theta, filter.getParametersStd().size(), "theta");
+			filter.setParameters(const_cast<double *>(theta.data()));
+		}, "Sets the parameters given in the problem space.")
+		.def("get_parameters_std", &AbstractROUKF::getParametersStd)
+		.def("get_parameters_covariance", [](AbstractROUKF &filter) {
+			int p = filter.getParametersStd().size();
+			//	Symmetric, hence the column-major copy is also its C-ordered layout
+			py::array_t<double> P({ p, p });
+			filter.copyParametersCovariance(P.mutable_data());
+			return P;
+		}, "Covariance of the parameters in the kalman space.")
+		.def("get_parameters_marginal_std", [](AbstractROUKF &filter, const vector<int> &parameters) {
+			vector<double> std = filter.getParametersMarginalStd(parameters);
+			if (std.empty())
+				throw py::index_error("A parameter index is out of range.");
+			return std;
+		}, py::arg("parameters") = vector<int>(), "Marginal standard deviation of some parameters, all of them by default.")
+		.def("get_state_parameters_covariance", [](AbstractROUKF &filter, int first, int count) {
+			int p = filter.getParametersStd().size();
+			if (count < 0)
+				count = filter.getStates() - first;
+			//	Column-major count x p is the C-ordered layout of its transpose
+			py::array_t<double> C({ p, max(count, 0) });
+			if (!filter.copyStateParametersCovariance(C.mutable_data(), first, count))
+				throw py::value_error("The cross-covariance of these states is not available.");
+			return C.attr("T");
+		}, py::arg("first") = 0, py::arg("count") = -1,
+				"Cross-covariance between the states [first, first + count) and the parameters.")
+		.def_property_readonly("error_history", &AbstractROUKF::getErrorHistory)
+		.def_property_readonly("observations", &AbstractROUKF::getObservations)
+		.def_property_readonly("states", &AbstractROUKF::getStates)
+		.def_property_readonly("sigma_points", &AbstractROUKF::getSigmaPoints)
+		.def_property("threads", &AbstractROUKF::getThreads, &AbstractROUKF::setThreads)
+		.def_property("single_precision", &AbstractROUKF::isSinglePrecision, &AbstractROUKF::setSinglePrecision)
+		.def_property("tolerance", &AbstractROUKF::getTolerance, &AbstractROUKF::setTolerance)
+		.def_property("max_iterations", &AbstractROUKF::getMaxIterations, &AbstractROUKF::setMaxIterations)
+		.def("has_converged", &AbstractROUKF::hasConverged, py::arg("relative") = true)
+		.def("save_checkpoint", &AbstractROUKF::saveCheckpoint, py::call_guard<py::gil_scoped_release>())
+		.def("load_checkpoint", &AbstractROUKF::loadCheckpoint, py::call_guard<py::gil_scoped_release>())
+		.def("set_profiling", &AbstractROUKF::setProfiling, py::arg("enabled"), py::arg("tracing") = false)
+		.def("get_profiling", [](AbstractROUKF &filter) {
+			const StepProfiler &profiler = filter.getProfiler();
+			py::dict profile;
+			for (int i = 0; i < StepProfiler::PHASES; ++i)
+				profile[StepProfiler::getName((StepProfiler::PHASE) i)] = profiler.getTime((StepProfiler::PHASE) i);
+			for (int i = 0; i < StepProfiler::COUNTERS; ++i)
+				profile[StepProfiler::getName((StepProfiler::COUNTER) i)] = profiler.getCount((StepProfiler::COUNTER) i);
+			return profile;
+		}, "Times in seconds of each phase and counters of the profiled steps.")
+		.def("write_chrome_trace", &AbstractROUKF::writeChromeTrace)
+		.def("set_surrogate", [](AbstractROUKF &filter, double threshold, int capacity, double lengthScale,
+				double nugget, int minSamples) {
+			SurrogateModel *surrogate = new SurrogateModel(filter.getParametersStd().size(), filter.getObservations(),
+					threshold, capacity, lengthScale, nugget);
+			if (minSamples > 0)
+				surrogate->setMinSamples(minSamples);
+			if (!filter.setSurrogateModel(surrogate)) {
+				delete surrogate;
+				throw py::value_error("The surrogate model only suits filters with static states.");
+			}
+		}, py::arg("threshold"), py::arg("capacity") = 0, py::arg("length_scale") = 1., py::arg("nugget") = 1E-6,
+				py::arg("min_samples") = 0, "Answers the sigma points with an emulator when its predicted error is under threshold.")
+		.def("disable_surrogate", [](AbstractROUKF &filter) {
+			filter.setSurrogateModel(NULL);
+		})
+		.def("surrogate_stats", [](AbstractROUKF &filter) {
+			py::dict stats;
+			SurrogateModel *surrogate = filter.getSurrogateModel();
+			if (!surrogate)
+				return stats;
+			stats["saved_solves"] = surrogate->getSavedSolves();
+			stats["fallbacks"] = surrogate->getFallbacks();
+			stats["samples"] = surrogate->getSamples();
+			stats["threshold"] = surrogate->getThreshold();
+			return stats;
+		}, "Statistics of the surrogate model, empty if disabled.");
+
+	py::class_<ROUKF, AbstractROUKF>(m, "ROUKF")
+		.def(py::init([](int nObservations, int nStates, int nParameters, vector<double> observationsUncertainty,
+				vector<double> parametersUncertainty, SigmaPointsGenerator::SIGMA_DISTRIBUTION distribution) {
+			if ((int) observationsUncertainty.size() != nObservations || (int) parametersUncertainty.size() != nParameters)
+				throw py::value_error("One uncertainty is required per observation and per parameter.");
+			return new ROUKF(nObservations, nStates, nParameters, &(observationsUncertainty[0]),
+					&(parametersUncertainty[0]), distribution);
+		}), py::arg("observations"), py::arg("states"), py::arg("parameters"), py::arg("observations_uncertainty"),
+				py::arg("parameters_uncertainty"), py::arg("distribution") = SigmaPointsGenerator::SIMPLEX);
+
+	py::class_<StaticROUKF, AbstractROUKF>(m, "StaticROUKF")
+		.def(py::init([](int nObservations, int nStates, int nParameters, vector<double> observationsUncertainty,
+				vector<double> parametersUncertainty, SigmaPointsGenerator::SIGMA_DISTRIBUTION distribution) {
+			if ((int) observationsUncertainty.size() != nObservations || (int) parametersUncertainty.size() != nParameters)
+				throw py::value_error("One uncertainty is required per observation and per parameter.");
+			return new StaticROUKF(nObservations, nStates, nParameters, &(observationsUncertainty[0]),
+					&(parametersUncertainty[0]), distribution);
+		}), py::arg("observations"), py::arg("states"), py::arg("parameters"), py::arg("observations_uncertainty"),
+				py::arg("parameters_uncertainty"), py::arg("distribution") = SigmaPointsGenerator::SIMPLEX)
+		.def("set_forward_cache", &StaticROUKF::setForwardCache, py::arg("budget"), py::arg("tolerance") = 0.)
+		.def("clear_forward_cache", &StaticROUKF::clearForwardCache)
+		.def("forward_cache_stats", [](const StaticROUKF &filter) {
+			py::dict stats;
+			const ForwardCache *cache = filter.getForwardCache();
+			if (!cache)
+				return stats;
+			stats["hits"] = cache->getHits();
+			stats["misses"] = cache->getMisses();
+			stats["evictions"] = cache->getEvictions();
+			stats["entries"] = cache->getEntries();
+			stats["bytes"] = cache->getBytes();
+			stats["budget"] = cache->getBudget();
+			stats["tolerance"] = cache->getTolerance();
+			return stats;
+		}, "Statistics of the forward cache, empty if disabled.");
+
+	py::class_<MappedROUKF, AbstractROUKF>(m, "MappedROUKF")
+		.def(py::init([](int nObservations, int nStates, int nParameters, vector<double> observationsUncertainty,
+				vector<double> parametersUncertainty, SigmaPointsGenerator::SIGMA_DISTRIBUTION distribution,
+				CompositeParameterMapper *mapper) {
+			if ((int) observationsUncertainty.size() != nObservations || (int) parametersUncertainty.size() != nParameters)
+				throw py::value_error("One uncertainty is required per observation and per parameter.");
+			//	The filter owns its mapper, the Python one and its mappers stay alive with the filter
+			return new MappedROUKF(nObservations, nStates, nParameters, observationsUncertainty,
+					parametersUncertainty, distribution, new CompositeParameterMapper(*mapper));
+		}), py::arg("observations"), py::arg("states"), py::arg("parameters"), py::arg("observations_uncertainty"),
+				py::arg("parameters_uncertainty"), py::arg("distribution"), py::arg("mapper"), py::keep_alive<1, 8>());
+
+	//	Configuration files
+	py::class_<ConfigurationFileReader>(m, "ConfigurationFileReader", py::dynamic_attr())
+		.def(py::init<string>(), py::arg("filename"))
+		.def("get_instance", [](py::object self) {
+			//	The reader returns the same filter on each call, the Python object is kept in the reader
+			if (py::hasattr(self, "_instance"))
+				return py::object(self.attr("_instance"));
+			AbstractROUKF *filter = self.cast<ConfigurationFileReader &>().getInstance();
+			if (!filter)
+				throw py::value_error("The configuration file does not describe a valid filter.");
+			py::object instance = py::cast(filter, py::return_value_policy::take_ownership);
+			self.attr("_instance") = instance;
+			return instance;
+		}, "Creates the filter described by the file.")
+		.def("get_observations", &ConfigurationFileReader::getObservations)
+		.def_property_readonly("parameters", &ConfigurationFileReader::getNParameters)
+		.def_property_readonly("states", &ConfigurationFileReader::getNStates)
+		.def_property_readonly("observations", &ConfigurationFileReader::getNObservations);
+}
@@ -0,0 +1,230 @@
+/*
+ * AllocationTest.cpp
+ *
+ *	Checks that the steps of ROUKF (serial and with threads), StaticROUKF, MappedROUKF and
+ *	FixedROUKF allocate no memory after the first one. The global operator new and, with glibc,
+ *	the malloc family (used by armadillo) are replaced by counting versions.
+ *
+ *	Usage:
+ *		kalman_allocation_test
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <mpi.h>
+#include <new>
+#include <vector>
+
+#include "../bench/SyntheticProblems.h"
+#include "../FixedROUKF.h"
+#include "../MappedROUKF.h"
+#include "../ROUKF.h"
+#include "../StaticROUKF.h"
+
+using namespace std;
+
+/**	Allocations since the last reset. */
+static atomic<long long> allocations(0);
+
+#ifdef __GLIBC__
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void __libc_free(void *pointer);
+
+void *malloc(size_t size) {
+	++allocations;
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+	++allocations;
+	return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size) {
+	++allocations;
+	return __libc_realloc(pointer, size);
+}
+
+void *memalign(size_t alignment, size_t size) {
+	++allocations;
+	return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+	++allocations;
+	return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **pointer, size_t alignment, size_t size) {
+	++allocations;
+	*pointer = __libc_memalign(alignment, size);
+	return *pointer ? 0 : 12;
+}
+
+void free(void *pointer) {
+	__libc_free(pointer);
+}
+}
+#endif
+
+void *operator new(size_t size) {
+	++allocations;
+	void *pointer = std::malloc(size ? size : 1);
+	if (!pointer)
+		throw std::bad_alloc();
+	return pointer;
+}
+
+void *operator new[](size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void *pointer) noexcept {
+	std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept {
+	std::free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+	std::free(pointer);
+}
+
+void operator delete[](void *pointer, size_t) noexcept {
+	std::free(pointer);
+}
+
+/**	Sizes of the linear synthetic problem, constant for FixedROUKF. */
+static const int N_STATES = 200, N_PARAMETERS = 4, N_OBSERVATIONS = 20;
+
+/**
+ * Forward operator of the linear problem (forwardOp) without the timing of SyntheticProblems,
+ * which is not reentrant, for the steps with threads.
+ * @param x States, advanced in place.
+ * @param nStates Quantity of states.
+ * @param theta Parameters.
+ * @param nParameters Quantity of parameters.
+ * @return 0.
+ */
+static int linearForward(double *x, int nStates, double *theta, int nParameters) {
+	for (int i = 0; i < nStates; ++i)
+		x[i] = 0.9 * x[i] + 0.1 * theta[(long long) i * nParameters / nStates];
+	return 0;
+}
+
+/**
+ * Observation operator of the linear problem (observationOp), reentrant as linearForward.
+ * @param x States.
+ * @param nStates Quantity of states.
+ * @param z Observations.
+ * @param nObservations Quantity of observations.
+ */
+static void linearObserve(double *x, int nStates, double *z, int nObservations) {
+	for (int j = 0; j < nObservations; ++j)
+		z[j] = x[(long long) j * nStates / nObservations];
+}
+
+/**
+ * Steps a filter of the current synthetic problem and counts the allocations of the steps after
+ * the first one.
+ * @param name Name of the filter in the report.
+ * @param nSteps Quantity of steps.
+ * @param step Performs a step of the filter with the given observations, returns its error.
+ * @return If no step after the first one allocated memory.
+ */
+static bool checkSteps(const char *name, int nSteps, const function<double(double *)> &step) {
+	vector<double> xt(N_STATES), zt(N_OBSERVATIONS);
+	SyntheticProblems::initialCondition(&(xt[0]));
+	vector<double> trueTheta = SyntheticProblems::trueParameters();
+
+	long long counted = 0;
+	for (int i = 0; i < nSteps; ++i) {
+		SyntheticProblems::forward(&(xt[0]), N_STATES, &(trueTheta[0]), trueTheta.size());
+		SyntheticProblems::observe(&(xt[0]), N_STATES, &(zt[0]), N_OBSERVATIONS);
+
+		//	The first step may size what the constructor could not know
+		allocations = 0;
+		if (step(&(zt[0])) < 0) {
+			printf("%s: step %d failed.\n", name, i);
+			return false;
+		}
+		if (i > 0)
+			counted += allocations;
+	}
+	printf("%s: %lld allocations in %d steps after the first one.\n", name, counted, nSteps - 1);
+	return counted == 0;
+}
+
+int main(int argc, char *argv[]) {
+	MPI_Init(&argc, &argv);
+	const int nSteps = 10;
+	vector<double> observationsUncertainty(N_OBSERVATIONS, 1E-4);
+	vector<double> parametersUncertainty(N_PARAMETERS, 0.25);
+	bool passed = true;
+
+	SyntheticProblems::setup(SyntheticProblems::LINEAR, N_STATES, N_PARAMETERS, false);
+	vector<double> theta = SyntheticProblems::initialParameters();
+	vector<double> x0(N_STATES);
+	SyntheticProblems::initialCondition(&(x0[0]));
+	const forwardFunction A = &SyntheticProblems::forward, reentrantA = &linearForward;
+	const observationFunction H = &SyntheticProblems::observe, reentrantH = &linearObserve;
+
+	ROUKF *roukf = new ROUKF(N_OBSERVATIONS, N_STATES, N_PARAMETERS, &(observationsUncertainty[0]),
+			&(parametersUncertainty[0]), SigmaPointsGenerator::SIMPLEX);
+	roukf->setParameters(&(theta[0]));
+	roukf->setState(&(x0[0]));
+	passed = checkSteps("ROUKF", nSteps, [&](double *zt) {
+		return roukf->executeStep(zt, A, H);
+	}) && passed;
+	delete roukf;
+
+	ROUKF *threaded = new ROUKF(N_OBSERVATIONS, N_STATES, N_PARAMETERS, &(observationsUncertainty[0]),
+			&(parametersUncertainty[0]), SigmaPointsGenerator::SIMPLEX);
+	threaded->setThreads(2);
+	threaded->setParameters(&(theta[0]));
+	threaded->setState(&(x0[0]));
+	passed = checkSteps("ROUKF with threads", nSteps, [&](double *zt) {
+		return threaded->executeStep(zt, reentrantA, reentrantH);
+	}) && passed;
+	delete threaded;
+
+	MappedROUKF *mapped = new MappedROUKF(N_OBSERVATIONS, N_STATES, N_PARAMETERS, observationsUncertainty,
+			parametersUncertainty, SigmaPointsGenerator::SIMPLEX, MappedROUKF::POSITIVE, vector<double>());
+	mapped->setParameters(&(theta[0]));
+	mapped->setState(&(x0[0]));
+	passed = checkSteps("MappedROUKF", nSteps, [&](double *zt) {
+		return mapped->executeStep(zt, A, H);
+	}) && passed;
+	delete mapped;
+
+	FixedROUKF<N_STATES, N_PARAMETERS, N_OBSERVATIONS, SigmaPointsGenerator::SIMPLEX> *fixed =
+			new FixedROUKF<N_STATES, N_PARAMETERS, N_OBSERVATIONS, SigmaPointsGenerator::SIMPLEX>(
+					&(observationsUncertainty[0]), &(parametersUncertainty[0]));
+	fixed->setParameters(&(theta[0]));
+	fixed->setState(&(x0[0]));
+	passed = checkSteps("FixedROUKF", nSteps, [&](double *zt) {
+		return fixed->executeStep(zt, &SyntheticProblems::forward, &SyntheticProblems::observe);
+	}) && passed;
+	delete fixed;
+
+	SyntheticProblems::setup(SyntheticProblems::LINEAR, N_STATES, N_PARAMETERS, true);
+	StaticROUKF *staticRoukf = new StaticROUKF(N_OBSERVATIONS, N_STATES, N_PARAMETERS,
+			&(observationsUncertainty[0]), &(parametersUncertainty[0]), SigmaPointsGenerator::SIMPLEX);
+	staticRoukf->setParameters(&(theta[0]));
+	passed = checkSteps("StaticROUKF", nSteps, [&](double *zt) {
+		return staticRoukf->executeStep(zt, A, H);
+	}) && passed;
+	delete staticRoukf;
+
+	MPI_Finalize();
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,149 @@
+#
+# KFPyTest.py
+#
+#	Checks of the Python bindings (module kfpy) on a linear problem: the steps with one operator
+#	call per sigma point and with batched calls, the lifetime of the views over the filter and the
+#	rejection of operators that fail or keep their arrays.
+#
+#	Usage:
+#		python KFPyTest.py		(with kfpy in PYTHONPATH)
+#
+#  Created on: Oct 16, 2026
+#
+
+import sys
+
+import numpy as np
+
+import kfpy
+
+N_STATES, N_PARAMETERS, N_OBSERVATIONS = 20, 2, 5
+TRUE_THETA = np.array([1., 2.])
+# Parameter towards which each state relaxes
+OWNER = np.arange(N_STATES) * N_PARAMETERS // N_STATES
+
+
+def forward(x, theta):
+	x[:] = 0.9 * x + 0.1 * theta[OWNER]
+
+
+def observe(x, z):
+	z[:] = x[::N_STATES // N_OBSERVATIONS]
+
+
+def forward_batch(X, Theta):
+	X[:] = 0.9 * X + 0.1 * Theta[:, OWNER]
+
+
+def observe_batch(X, Z):
+	Z[:] = X[:, ::N_STATES // N_OBSERVATIONS]
+
+
+def create_filter():
+	kf = kfpy.ROUKF(N_OBSERVATIONS, N_STATES, N_PARAMETERS, [1E-4] * N_OBSERVATIONS, [0.25] * N_PARAMETERS)
+	kf.set_parameters(np.array([0.5, 1.5]))
+	kf.set_state(np.zeros(N_STATES))
+	return kf
+
+
+def expect(condition, what):
+	if not condition:
+		print(what)
+	return condition
+
+
+def main():
+	passed = True
+	single = create_filter()
+	batch = create_filter()
+	xt, zt = np.zeros(N_STATES), np.zeros(N_OBSERVATIONS)
+	for step in range(20):
+		forward(xt, TRUE_THETA)
+		observe(xt, zt)
+		passed = expect(single.execute_step(zt, forward, observe) >= 0, "A step failed.") and passed
+		passed = expect(batch.execute_step_batch(zt, forward_batch, observe_batch) >= 0,
+				"A batched step failed.") and passed
+	theta = single.get_parameters()
+	print("Estimated parameters:", theta)
+	passed = expect(np.allclose(theta, TRUE_THETA, rtol=5E-2), "The parameters were not identified.") and passed
+	passed = expect(np.allclose(theta, batch.get_parameters(), rtol=1E-10),
+			"The batched steps differ from the steps per sigma point.") and passed
+
+	# The views keep the filter alive
+	state = single.state
+	del single
+	passed = expect(state.shape == (N_STATES,) and np.all(np.isfinite(state)), "The state view is invalid.") and passed
+
+	# Operators that keep their arrays fail the step without modifying the estimate
+	kept = []
+
+	def keeping_forward(x, theta):
+		forward(x, theta)
+		kept.append(x[:2])
+
+	before = batch.get_parameters()
+	try:
+		batch.execute_step(zt, keeping_forward, observe)
+		passed = expect(False, "An operator kept its array without an error.") and passed
+	except RuntimeError:
+		pass
+	del kept[:]
+	passed = expect(np.array_equal(before, batch.get_parameters()), "A failed step modified the estimate.") and passed
+
+	# Exceptions of the operators reach the caller
+	def failing_forward(x, theta):
+		raise ValueError("failing operator")
+
+	try:
+		batch.execute_step(zt, failing_forward, observe)
+		passed = expect(False, "The exception of an operator was lost.") and passed
+	except ValueError:
+		pass
+
+	# Observation operators that fail after writing part of their observations, at the last sigma
+	# point, with all sigma points at once or by keeping their array, leave the estimate unchanged
+	calls = [0]
+
+	def failing_observe(x, z):
+		calls[0] += 1
+		z[:2] = 0.
+		if calls[0] == batch.sigma_points:
+			raise ValueError("failing observation")
+
+	def failing_observe_batch(X, Z):
+		Z[:, :2] = 0.
+		raise ValueError("failing observation")
+
+	def keeping_observe(x, z):
+		observe(x, z)
+		kept.append(z[:2])
+
+	failing_steps = [
+		(lambda: batch.execute_step(zt, forward, failing_observe), ValueError),
+		(lambda: batch.execute_step_batch(zt, forward_batch, failing_observe_batch), ValueError),
+		(lambda: batch.execute_step(zt, forward, keeping_observe), RuntimeError)]
+	for step, raised in failing_steps:
+		before, state = batch.get_parameters(), batch.state.copy()
+		try:
+			step()
+			passed = expect(False, "A failed observation operator did not raise.") and passed
+		except raised:
+			pass
+		del kept[:]
+		passed = expect(np.array_equal(before, batch.get_parameters()) and np.array_equal(state, batch.state),
+				"A failed observation operator modified the estimate.") and passed
+	passed = expect(batch.execute_step(zt, forward, observe) >= 0, "The step after a failed one failed.") and passed
+
+	# Marginal deviations of some parameters
+	std = batch.get_parameters_marginal_std()
+	passed = expect(batch.get_parameters_marginal_std([1]) == std[1:], "The marginal deviations differ.") and passed
+	try:
+		batch.get_parameters_marginal_std([N_PARAMETERS])
+		passed = expect(False, "A parameter index out of range was accepted.") and passed
+	except IndexError:
+		pass
+	return passed
+
+
+if __name__ == "__main__":
+	sys.exit(0 if main() else 1)
@@ -0,0 +1,1341 @@
+/*
+ * KalmanTests.cpp
+ *
+ *	Checks of the filters and of their execution backends, one per run, registered in ctest by
+ *	name. The checks that need several MPI processes are run through mpiexec.
+ *
+ *	Usage:
+ *		kalman_tests <check>
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mpi.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "../bench/SyntheticProblems.h"
+#include "../BatchROUKF.h"
+#include "../FixedROUKF.h"
+#include "../io/Checkpoint.h"
+#include "../MappedROUKF.h"
+#include "../observation/BlockDiagonalObservationErrorModel.h"
+#include "../observation/DenseObservationErrorModel.h"
+#include "../parallel/ProcessesBackend.h"
+#include "../parallel/SigmaPointsScheduler.h"
+#include "../parallel/ThreadPool.h"
+#include "../ROUKF.h"
+#include "../StaticROUKF.h"
+
+using namespace std;
+
+/**
+ * Reports a failed expectation.
+ * @param condition Expectation.
+ * @param what Description printed if it does not hold.
+ * @return @p condition .
+ */
+static bool expect(bool condition, const char *what) {
+	if (!condition) {
+		int rank;
+		MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+		printf("Rank %d: %s\n", rank, what);
+	}
+	return condition;
+}
+
+/**	Sizes of the linear synthetic problem of the checks. */
+static const int N_STATES = 50, N_PARAMETERS = 3, N_OBSERVATIONS = 10;
+
+/**
+ * Sets up the linear synthetic problem and creates a ROUKF that starts from its initial
+ * condition and initial parameters.
+ * @return Filter.
+ */
+static ROUKF *createROUKF() {
+	SyntheticProblems::setup(SyntheticProblems::LINEAR, N_STATES, N_PARAMETERS, false);
+	vector<double> observationsUncertainty(N_OBSERVATIONS, 1E-4);
+	vector<double> parametersUncertainty(N_PARAMETERS, 0.25);
+	ROUKF *filter = new ROUKF(N_OBSERVATIONS, N_STATES, N_PARAMETERS, &(observationsUncertainty[0]),
+			&(parametersUncertainty[0]), SigmaPointsGenerator::SIMPLEX);
+	vector<double> theta = SyntheticProblems::initialParameters();
+	filter->setParameters(&(theta[0]));
+	vector<double> x(N_STATES);
+	SyntheticProblems::initialCondition(&(x[0]));
+	filter->setState(&(x[0]));
+	return filter;
+}
+
+/**
+ * Advances the true model of the linear problem and observes it.
+ * @param xt States of the true model, advanced one step.
+ * @param zt Returns the observations of the true model.
+ */
+static void observeTruth(vector<double> &xt, vector<double> &zt) {
+	vector<double> trueTheta = SyntheticProblems::trueParameters();
+	SyntheticProblems::forward(&(xt[0]), xt.size(), &(trueTheta[0]), trueTheta.size());
+	SyntheticProblems::observe(&(xt[0]), xt.size(), &(zt[0]), zt.size());
+}
+
+/**
+ * Returns the estimate of a filter of the linear problem: its parameters, followed by its states
+ * and the covariance of its parameters.
+ * @param filter Filter.
+ * @return Estimate of the filter.
+ */
+static vector<double> estimateOf(AbstractROUKF *filter) {
+	int nStates = filter->getStates(), nParameters = N_PARAMETERS;
+	vector<double> estimate(nParameters + nStates + nParameters * nParameters);
+	filter->copyParameters(&(estimate[0]));
+	filter->copyState(&(estimate[nParameters]));
+	filter->copyParametersCovariance(&(estimate[nParameters + nStates]));
+	return estimate;
+}
+
+/**
+ * Returns the largest difference between two estimates, relative to the largest value.
+ * @param a Estimate.
+ * @param b Estimate of the same size.
+ * @return Relative difference.
+ */
+static double difference(const vector<double> &a, const vector<double> &b) {
+	double largest = 1E-300, diff = 0;
+	for (size_t i = 0; i < a.size(); ++i) {
+		largest = max(largest, fabs(a[i]));
+		diff = max(diff, fabs(a[i] - b[i]));
+	}
+	return diff / largest;
+}
+
+/**
+ * Copies a file.
+ * @param source Path of the file.
+ * @param destination Path of the copy.
+ */
+static void copyFile(const string &source, const string &destination) {
+	ifstream in(source.c_str(), ios::binary);
+	ofstream out(destination.c_str(), ios::binary);
+	out << in.rdbuf();
+}
+
+/**
+ * Original formulation of the step of ROUKF, which samples the sigma points with chol(inv(U))
+ * and applies inv(U) and the inverse observations covariance explicitly, for the checks of the
+ * factored step. The forward and observation operators are those of SyntheticProblems.
+ */
+struct ReferenceROUKF {
+	/**	States. */
+	arma::mat X;
+	/**	Parameters, in logarithmic scale if @p positive . */
+	arma::mat Theta;
+	/**	L part of the covariance concerning to the states. */
+	arma::mat LX;
+	/**	L part of the covariance concerning to the parameters. */
+	arma::mat LTheta;
+	/**	U part of the covariance. */
+	arma::mat U;
+	/**	Inverse of the observations covariance. */
+	arma::mat Wi;
+	/**	If the parameters are estimated in logarithmic scale, as MappedROUKF::POSITIVE. */
+	bool positive;
+
+	/**
+	 * Creates the reference from the initial condition and initial parameters of the current
+	 * synthetic problem.
+	 * @param observationsCovariance Covariance of the observation errors.
+	 * @param parametersUncertainty Variance of each parameter.
+	 * @param positive If the parameters are estimated in logarithmic scale.
+	 */
+	ReferenceROUKF(const arma::mat &observationsCovariance, const vector<double> &parametersUncertainty,
+			bool positive) {
+		vector<double> x(N_STATES), theta = SyntheticProblems::initialParameters();
+		SyntheticProblems::initialCondition(&(x[0]));
+		X = arma::mat(&(x[0]), N_STATES, 1);
+		Theta = arma::mat(&(theta[0]), N_PARAMETERS, 1);
+		if (positive)
+			Theta = arma::log(Theta);
+		LX = arma::zeros(N_STATES, N_PARAMETERS);
+		LTheta = arma::eye(N_PARAMETERS, N_PARAMETERS);
+		U = arma::diagmat(1. / arma::mat(&(parametersUncertainty[0]), N_PARAMETERS, 1));
+		Wi = arma::inv(observationsCovariance);
+		this->positive = positive;
+	}
+
+	/**
+	 * Performs one step.
+	 * @param zt Observations.
+	 */
+	void step(const vector<double> &zt) {
+		shared_ptr<const SigmaPointsGenerator::SigmaPointsSet> set =
+				SigmaPointsGenerator::getSigmaPointsSet(N_PARAMETERS, SigmaPointsGenerator::SIMPLEX);
+		const int nSigma = set->sigma.n_cols, nObservations = zt.size();
+		arma::mat C = arma::chol(arma::inv(U));
+		arma::mat Xk(N_STATES, nSigma), Thetak(N_PARAMETERS, nSigma), Zk(nObservations, nSigma);
+		for (int i = 0; i < nSigma; ++i) {
+			arma::mat s = set->sigma.col(i);
+			Xk.col(i) = X + LX * C.t() * s;
+			arma::mat thetak = Theta + LTheta * C.t() * s;
+			if (positive)
+				thetak = arma::exp(thetak);
+			SyntheticProblems::forward(Xk.colptr(i), N_STATES, thetak.memptr(), N_PARAMETERS);
+			SyntheticProblems::observe(Xk.colptr(i), N_STATES, Zk.colptr(i), nObservations);
+			Thetak.col(i) = positive ? arma::log(thetak) : thetak;
+		}
+		arma::mat error = arma::mat(&(zt[0]), nObservations, 1) - arma::mean(Zk, 1);
+		LX = Xk * set->Dsigma;
+		LTheta = Thetak * set->Dsigma;
+		arma::mat HL = Zk * set->Dsigma;
+		U = set->Pa + HL.t() * (Wi * HL);
+		arma::mat gain = arma::inv(U) * HL.t() * (Wi * error);
+		X = arma::mean(Xk, 1) + LX * gain;
+		Theta = arma::mean(Thetak, 1) + LTheta * gain;
+	}
+
+	/**
+	 * Returns the estimate: the parameters, their standard deviations (from the diagonal of U)
+	 * and the states.
+	 * @return Estimate.
+	 */
+	vector<double> estimate() const {
+		vector<double> estimate(2 * N_PARAMETERS + N_STATES);
+		arma::mat theta = positive ? arma::exp(Theta) : Theta;
+		copy(theta.begin(), theta.end(), estimate.begin());
+		for (int j = 0; j < N_PARAMETERS; ++j)
+			estimate[N_PARAMETERS + j] = sqrt(1. / U.at(j, j));
+		copy(X.begin(), X.end(), estimate.begin() + 2 * N_PARAMETERS);
+		return estimate;
+	}
+};
+
+/**
+ * Returns the estimate of a filter in the layout of ReferenceROUKF::estimate.
+ * @param filter Filter.
+ * @return Parameters, their standard deviations and states.
+ */
+static vector<double> stdEstimateOf(AbstractROUKF *filter) {
+	vector<double> estimate(2 * N_PARAMETERS + N_STATES);
+	filter->copyParameters(&(estimate[0]));
+	vector<double> std = filter->getParametersStd();
+	copy(std.begin(), std.end(), estimate.begin() + N_PARAMETERS);
+	filter->copyState(&(estimate[2 * N_PARAMETERS]));
+	return estimate;
+}
+
+/**
+ * Checks that each filter of a BatchROUKF matches a ROUKF along several steps, in its
+ * parameters, parameters standard deviations and states. The batch has two identical filters, so
+ * that the layout across filters is also checked.
+ * @return If the check passed.
+ */
+static bool checkBatch() {
+	bool passed = true;
+	ROUKF *filter = createROUKF();
+	const int nFilters = 2;
+	vector<double> observationsUncertainty(N_OBSERVATIONS * nFilters, 1E-4);
+	vector<double> parametersUncertainty(N_PARAMETERS * nFilters, 0.25);
+	BatchROUKF batch(nFilters, N_OBSERVATIONS, N_STATES, N_PARAMETERS, &(observationsUncertainty[0]),
+			&(parametersUncertainty[0]), SigmaPointsGenerator::SIMPLEX);
+	vector<double> theta = SyntheticProblems::initialParameters();
+	vector<double> xt(N_STATES), zt(N_OBSERVATIONS), observations(N_OBSERVATIONS * nFilters);
+	SyntheticProblems::initialCondition(&(xt[0]));
+	for (int f = 0; f < nFilters; ++f) {
+		batch.setParameters(f, &(theta[0]));
+		batch.setState(f, &(xt[0]));
+	}
+	instanceForwardFunction A = [](int, double *x, int nStates, double *theta, int nParameters) {
+		return SyntheticProblems::forward(x, nStates, theta, nParameters);
+	};
+	instanceObservationFunction H = [](int, double *x, int nStates, double *z, int nObservations) {
+		SyntheticProblems::observe(x, nStates, z, nObservations);
+	};
+
+	double largest = 0;
+	for (int step = 0; step < 10; ++step) {
+		observeTruth(xt, zt);
+		for (int f = 0; f < nFilters; ++f)
+			copy(zt.begin(), zt.end(), observations.begin() + f * N_OBSERVATIONS);
+		double error = filter->executeStep(&(zt[0]), &SyntheticProblems::forward, &SyntheticProblems::observe);
+		double batchError = batch.executeStep(&(observations[0]), A, H);
+		passed = expect(error >= 0 && batchError >= 0, "A step failed.") && passed;
+
+		vector<double> expected(2 * N_PARAMETERS + N_STATES), actual(expected.size());
+		filter->copyParameters(&(expected[0]));
+		vector<double> std = filter->getParametersStd();
+		copy(std.begin(), std.end(), expected.begin() + N_PARAMETERS);
+		filter->copyState(&(expected[2 * N_PARAMETERS]));
+		for (int f = 0; f < nFilters; ++f) {
+			batch.copyParameters(f, &(actual[0]));
+			std = batch.getParametersStd(f);
+			copy(std.begin(), std.end(), actual.begin() + N_PARAMETERS);
+			batch.copyState(f, &(actual[2 * N_PARAMETERS]));
+			largest = max(largest, difference(expected, actual));
+		}
+	}
+	printf("Largest relative difference of BatchROUKF: %g\n", largest);
+	passed = expect(largest < 1E-8, "BatchROUKF differs from ROUKF.") && passed;
+
+	delete filter;
+	return passed;
+}
+
+/**
+ * Checks that the forward cache does not answer sigma points of the same step that fall in the
+ * same cell (the estimate is then the one without cache) and that the observations evaluated by
+ * forked processes are stored.
+ * @return If the check passed.
+ */
+static bool checkCache() {
+	bool passed = true;
+	SyntheticProblems::setup(SyntheticProblems::LINEAR, N_STATES, N_PARAMETERS, true);
+	vector<double> observationsUncertainty(N_OBSERVATIONS, 1E-4);
+	vector<double> parametersUncertainty(N_PARAMETERS, 0.25);
+	vector<double> theta = SyntheticProblems::initialParameters();
+	StaticROUKF *filters[3];
+	for (int f = 0; f < 3; ++f) {
+		filters[f] = new StaticROUKF(N_OBSERVATIONS, N_STATES, N_PARAMETERS, &(observationsUncertainty[0]),
+				&(parametersUncertainty[0]), SigmaPointsGenerator::SIMPLEX);
+		filters[f]->setParameters(&(theta[0]));
+	}
+	//	Without cache, with cells holding all sigma points and exact with forked processes
+	filters[1]->setForwardCache(1 << 20, 1E3);
+	filters[2]->setForwardCache(1 << 20);
+	filters[2]->setExecutionBackend(new ProcessesBackend(2));
+
+	vector<double> xt(N_STATES), zt(N_OBSERVATIONS);
+	SyntheticProblems::initialCondition(&(xt[0]));
+	observeTruth(xt, zt);
+	for (int step = 0; step < 5; ++step)
+		for (int f = 0; f < 3; ++f)
+			passed = expect(filters[f]->executeStep(&(zt[0]), &SyntheticProblems::forward,
+					&SyntheticProblems::observe) >= 0, "A step failed.") && passed;
+
+	vector<double> expected(N_PARAMETERS), actual(N_PARAMETERS);
+	filters[0]->copyParameters(&(expected[0]));
+	filters[1]->copyParameters(&(actual[0]));
+	passed = expect(difference(expected, actual) == 0, "Sigma points of a step shared a cache entry.") && passed;
+	passed = expect(filters[1]->getForwardCache()->getHits() == 0, "The shared cell answered a sigma point.") && passed;
+	const ForwardCache *cache = filters[2]->getForwardCache();
+	passed = expect(cache->getMisses() > 0 && cache->getEntries() == (size_t) cache->getMisses(),
+			"The observations of the forked processes were not stored.") && passed;
+
+	for (int f = 0; f < 3; ++f)
+		delete filters[f];
+	return passed;
+}
+
+/**
+ * Checks that a filter restored from a checkpoint continues as the original one, that a step
+ * interrupted after some sigma points resumes without evaluating them again, and that an
+ * incomplete checkpoint is rejected without modifying the filter.
+ * @return If the check passed.
+ */
+static bool checkCheckpoint() {
+	const string file = "kalman_test.ckpt", partialFile = "kalman_test_partial.ckpt",
+			incompleteFile = "kalman_test_incomplete.ckpt";
+	bool passed = true;
+	ROUKF *filter = createROUKF();
+	vector<double> xt(N_STATES), zt(N_OBSERVATIONS);
+	SyntheticProblems::initialCondition(&(xt[0]));
+	for (int step = 0; step < 3; ++step) {
+		observeTruth(xt, zt);
+		filter->executeStep(&(zt[0]), &SyntheticProblems::forward, &SyntheticProblems::observe);
+	}
+
+	//	Round trip
+	ROUKF *restored = createROUKF();
+	passed = expect(filter->saveCheckpoint(file), "The checkpoint was not written.") && passed;
+	passed = expect(restored->loadCheckpoint(file), "The checkpoint was not restored.") && passed;
+	passed = expect(difference(estimateOf(filter), estimateOf(restored)) == 0,
+			"The restored filter differs from the original one.") && passed;
+	for (int step = 0; step < 2; ++step) {
+		observeTruth(xt, zt);
+		filter->executeStep(&(zt[0]), &SyntheticProblems::forward, &SyntheticProblems::observe);
+		restored->executeStep(&(zt[0]), &SyntheticProblems::forward, &SyntheticProblems::observe);
+	}
+	passed = expect(difference(estimateOf(filter), estimateOf(restored)) < 1E-12,
+			"The restored filter does not continue as the original one.") && passed;
+
+	//	Copy of the checkpoint taken while the third sigma point is evaluated, the first two
+	//	are already written in it
+	int calls = 0;
+	forwardFunction interrupted = [&](double *x, int nStates, double *theta, int nParameters) {
+		if (++calls == 3)
+			copyFile(file, partialFile);
+		return SyntheticProblems::forward(x, nStates, theta, nParameters);
+	};
+	forwardFunction counted = [&](double *x, int nStates, double *theta, int nParameters) {
+		++calls;
+		return SyntheticProblems::forward(x, nStates, theta, nParameters);
+	};
+	observeTruth(xt, zt);
+	filter->setCheckpointFile(file);
+	filter->executeStep(&(zt[0]), interrupted, &SyntheticProblems::observe);
+	filter->setCheckpointFile("");
+
+	ROUKF *resumed = createROUKF();
+	passed = expect(resumed->loadCheckpoint(partialFile), "The partial checkpoint was not restored.") && passed;
+	calls = 0;
+	resumed->executeStep(&(zt[0]), counted, &SyntheticProblems::observe);
+	passed = expect(calls == resumed->getSigmaPoints() - 2, "The resumed step evaluated the checkpointed sigma points.")
+			&& passed;
+	passed = expect(difference(estimateOf(filter), estimateOf(resumed)) < 1E-12,
+			"The resumed step differs from the uninterrupted one.") && passed;
+
+	//	Without the matrices of the filter
+	vector<double> dims = { (double) N_OBSERVATIONS, (double) N_STATES, (double) N_PARAMETERS };
+	vector<double> scalars = { 1, 0, 0, 0 };
+	Checkpoint incomplete;
+	incomplete.add("dims", dims);
+	incomplete.add("scalars", scalars);
+	incomplete.write(incompleteFile);
+	vector<double> before = estimateOf(resumed);
+	passed = expect(!resumed->loadCheckpoint(incompleteFile), "An incomplete checkpoint was restored.") && passed;
+	passed = expect(difference(before, estimateOf(resumed)) == 0,
+			"An incomplete checkpoint modified the filter.") && passed;
+
+	delete filter;
+	delete restored;
+	delete resumed;
+	remove(file.c_str());
+	remove(partialFile.c_str());
+	remove(incompleteFile.c_str());
+	return passed;
+}
+
+/**	ROUKF that gives the checks the covariances computed from the explicit inverse of U. */
+struct InspectedROUKF : public ROUKF {
+	using ROUKF::ROUKF;
+
+	/**
+	 * Returns the covariance of the parameters, LTheta U^{-1} LTheta^T.
+	 * @return Covariance.
+	 */
+	arma::mat parametersCovariance() const {
+		return LTheta * arma::inv(U) * LTheta.t();
+	}
+	/**
+	 * Returns the cross-covariance between the states and the parameters, LX U^{-1} LTheta^T.
+	 * @return Cross-covariance.
+	 */
+	arma::mat stateParametersCovariance() const {
+		return LX * arma::inv(U) * LTheta.t();
+	}
+};
+
+/**
+ * Returns the largest difference between two matrices relative to the largest element of the
+ * second one.
+ * @param actual Matrix.
+ * @param expected Reference matrix.
+ * @return Relative difference.
+ */
+static double difference(const arma::mat &actual, const arma::mat &expected) {
+	return arma::abs(actual - expected).max() / std::max(arma::abs(expected).max(), 1E-300);
+}
+
+/**
+ * Checks the covariance of the parameters, their marginal standard deviations and the
+ * cross-covariance of a range of states against the explicit inverse of U, before and along
+ * several steps, and that indexes out of range are rejected.
+ * @return If the check passed.
+ */
+static bool checkCovariance() {
+	const int first = 5, count = 7;
+	bool passed = true;
+	SyntheticProblems::setup(SyntheticProblems::LINEAR, N_STATES, N_PARAMETERS, false);
+	vector<double> observationsUncertainty(N_OBSERVATIONS, 1E-4);
+	vector<double> parametersUncertainty(N_PARAMETERS, 0.25);
+	InspectedROUKF filter(N_OBSERVATIONS, N_STATES, N_PARAMETERS, &(observationsUncertainty[0]),
+			&(parametersUncertainty[0]), SigmaPointsGenerator::SIMPLEX);
+	vector<double> theta = SyntheticProblems::initialParameters(), xt(N_STATES), zt(N_OBSERVATIONS);
+	filter.setParameters(&(theta[0]));
+	SyntheticProblems::initialCondition(&(xt[0]));
+	filter.setState(&(xt[0]));
+
+	double largest = 0;
+	for (int step = 0; step < 5; ++step) {
+		if (step > 0) {
+			observeTruth(xt, zt);
+			passed = expect(filter.executeStep(&(zt[0]), &SyntheticProblems::forward, &SyntheticProblems::observe) >= 0,
+					"A step failed.") && passed;
+		}
+		arma::mat P = filter.parametersCovariance(), C = filter.stateParametersCovariance();
+		arma::mat actualP(N_PARAMETERS, N_PARAMETERS), actualC(count, N_PARAMETERS);
+		filter.copyParametersCovariance(actualP.memptr());
+		largest = max(largest, difference(actualP, P));
+		passed = expect(filter.copyStateParametersCovariance(actualC.memptr(), first, count),
+				"The cross-covariance was not available.") && passed;
+		largest = max(largest, difference(actualC, C.rows(first, first + count - 1)));
+
+		vector<double> std = filter.getParametersMarginalStd();
+		passed = expect(std.size() == (size_t) N_PARAMETERS, "Not all marginal deviations were returned.") && passed;
+		for (size_t j = 0; j < std.size(); ++j)
+			largest = max(largest, fabs(std[j] - sqrt(P.at(j, j))) / sqrt(P.at(j, j)));
+		vector<double> some = filter.getParametersMarginalStd({ N_PARAMETERS - 1, 0 });
+		passed = expect(some.size() == 2 && some[0] == std[N_PARAMETERS - 1] && some[1] == std[0],
+				"The marginal deviations of some parameters differ from those of all.") && passed;
+	}
+	printf("Largest relative difference to the explicit inverse of U: %g\n", largest);
+	passed = expect(largest < 1E-10, "The covariances differ from the explicit inverse of U.") && passed;
+
+	vector<double> C(3 * N_PARAMETERS);
+	passed = expect(filter.getParametersMarginalStd({ N_PARAMETERS }).empty()
+			&& filter.getParametersMarginalStd({ 0, -1 }).empty(), "A parameter index out of range was accepted.")
+			&& passed;
+	passed = expect(!filter.copyStateParametersCovariance(&(C[0]), N_STATES - 2, 3)
+			&& !filter.copyStateParametersCovariance(&(C[0]), -1, 3), "A range beyond the states was accepted.")
+			&& passed;
+	return passed;
+}
+
+/**
+ * Checks that failed operators make the step fail without modifying the estimate. In serial
+ * execution, an observation operator failing at the last sigma point leaves the filter as if the
+ * step had not been tried. With the sigma point backend in both communication modes and with
+ * the groups backend, a forward or observation operator failing in one of two MPI processes
+ * makes the step fail in both, without leaving communications pending. The filters have a single
+ * parameter, hence two sigma points, one per process.
+ * @return If the check passed.
+ */
+static bool checkFailure() {
+	int rank, size;
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+	if (size != 2)
+		return expect(false, "The check needs two MPI processes.");
+
+	bool passed = true;
+	{
+		ROUKF *filter = createROUKF(), *reference = createROUKF();
+		vector<double> xt(N_STATES), zt(N_OBSERVATIONS);
+		SyntheticProblems::initialCondition(&(xt[0]));
+		int calls = 0;
+		observationFunction failing = [&calls, filter](double *x, int nStates, double *z, int nObservations) {
+			SyntheticProblems::observe(x, nStates, z, nObservations);
+			if (++calls == filter->getSigmaPoints())
+				z[0] = NAN;
+		};
+		for (int step = 0; step < 3; ++step) {
+			observeTruth(xt, zt);
+			if (step == 1) {
+				vector<double> before = estimateOf(filter);
+				passed = expect(filter->executeStep(&(zt[0]), &SyntheticProblems::forward, failing) < 0,
+						"A step with a failed observation operator succeeded.") && passed;
+				passed = expect(difference(before, estimateOf(filter)) == 0,
+						"A failed observation operator modified the estimate.") && passed;
+			}
+			filter->executeStep(&(zt[0]), &SyntheticProblems::forward, &SyntheticProblems::observe);
+			reference->executeStep(&(zt[0]), &SyntheticProblems::forward, &SyntheticProblems::observe);
+		}
+		passed = expect(difference(estimateOf(filter), estimateOf(reference)) == 0,
+				"The step after a failed one differs from the step without failure.") && passed;
+		delete filter;
+		delete reference;
+	}
+
+	const int nParameters = 1;
+	SyntheticProblems::setup(SyntheticProblems::LINEAR, N_STATES, nParameters, false);
+	vector<double> observationsUncertainty(N_OBSERVATIONS, 1E-4);
+	vector<double> parametersUncertainty(nParameters, 0.25);
+	vector<double> theta = SyntheticProblems::initialParameters();
+	vector<double> x0(N_STATES);
+	SyntheticProblems::initialCondition(&(x0[0]));
+	//	Operator failing in the process 1 (1 the forward one, 2 the observation one). The process
+	//	0 is slowed down in the failed steps, so that the scheduler gives a sigma point to the
+	//	process 1.
+	int failing = 0;
+	forwardFunction A = [&failing, rank](double *x, int nStates, double *theta, int nParameters) {
+		SyntheticProblems::forward(x, nStates, theta, nParameters);
+		if (failing && rank == 0)
+			usleep(200000);
+		return failing == 1 && rank == 1 ? -1 : 0;
+	};
+	observationFunction H = [&failing, rank](double *x, int nStates, double *z, int nObservations) {
+		SyntheticProblems::observe(x, nStates, z, nObservations);
+		if (failing == 2 && rank == 1)
+			z[nObservations - 1] = NAN;
+	};
+
+	for (int backend = 0; backend < 3; ++backend) {
+		ROUKF filter(N_OBSERVATIONS, N_STATES, nParameters, &(observationsUncertainty[0]),
+				&(parametersUncertainty[0]), SigmaPointsGenerator::SIMPLEX);
+		filter.setParameters(&(theta[0]));
+		filter.setState(&(x0[0]));
+		if (backend == 1)
+			filter.setCommunicationMode(SigmaPointsExchange::ALLGATHER);
+		vector<double> xt = x0, zt(N_OBSERVATIONS);
+		auto step = [&]() {
+			observeTruth(xt, zt);
+			if (backend < 2)
+				return filter.executeStepParallel(&(zt[0]), A, H, rank, MPI_COMM_WORLD, MPI_COMM_WORLD);
+			return filter.executeStepScheduled(&(zt[0]), A, H, MPI_COMM_SELF, MPI_COMM_WORLD);
+		};
+		auto estimate = [&]() {
+			vector<double> estimate(nParameters + N_STATES);
+			filter.copyParameters(&(estimate[0]));
+			filter.copyState(&(estimate[nParameters]));
+			return estimate;
+		};
+
+		passed = expect(step() >= 0, "A step failed.") && passed;
+		for (int kind = 1; kind <= 2; ++kind) {
+			vector<double> before = estimate();
+			failing = kind;
+			passed = expect(step() < 0, "A step with a failed operator succeeded.") && passed;
+			failing = 0;
+			passed = expect(estimate() == before, "A failed step modified the estimate.") && passed;
+			passed = expect(step() >= 0, "The step after a failed one failed.") && passed;
+		}
+
+		//	Both processes keep the same estimate
+		vector<double> local = estimate(), root = local;
+		MPI_Bcast(&(root[0]), root.size(), MPI_DOUBLE, 0, MPI_COMM_WORLD);
+		passed = expect(local == root, "The processes diverged after a failed step.") && passed;
+	}
+	return passed;
+}
+
+/**
+ * Checks that FixedROUKF matches ROUKF along several steps, in its parameters, states and
+ * parameters standard deviations (the diagonal of U).
+ * @return If the check passed.
+ */
+static bool checkFixed() {
+	bool passed = true;
+	ROUKF *filter = createROUKF();
+	vector<double> observationsUncertainty(N_OBSERVATIONS, 1E-4);
+	vector<double> parametersUncertainty(N_PARAMETERS, 0.25);
+	FixedROUKF<N_STATES, N_PARAMETERS, N_OBSERVATIONS, SigmaPointsGenerator::SIMPLEX> fixed(
+			&(observationsUncertainty[0]), &(parametersUncertainty[0]));
+	vector<double> theta = SyntheticProblems::initialParameters();
+	fixed.setParameters(&(theta[0]));
+	vector<double> xt(N_STATES), zt(N_OBSERVATIONS);
+	SyntheticProblems::initialCondition(&(xt[0]));
+	fixed.setState(&(xt[0]));
+
+	double largest = 0;
+	for (int step = 0; step < 10; ++step) {
+		observeTruth(xt, zt);
+		filter->executeStep(&(zt[0]), &SyntheticProblems::forward, &SyntheticProblems::observe);
+		fixed.executeStep(&(zt[0]), &SyntheticProblems::forward, &SyntheticProblems::observe);
+
+		vector<double> expected(2 * N_PARAMETERS + N_STATES), actual(expected.size());
+		filter->copyParameters(&(expected[0]));
+		fixed.copyParameters(&(actual[0]));
+		vector<double> std = filter->getParametersStd();
+		copy(std.begin(), std.end(), expected.begin() + N_PARAMETERS);
+		fixed.copyParametersStd(&(actual[N_PARAMETERS]));
+		filter->copyState(&(expected[2 * N_PARAMETERS]));
+		fixed.copyState(&(actual[2 * N_PARAMETERS]));
+		largest = max(largest, difference(expected, actual));
+	}
+	printf("Largest relative difference of FixedROUKF: %g\n", largest);
+	passed = expect(largest < 1E-8, "FixedROUKF differs from ROUKF.") && passed;
+
+	delete filter;
+	return passed;
+}
+
+/**
+ * Checks that the error history keeps the last errors of the steps, the oldest first, when it
+ * wraps around and when its length changes.
+ * @return If the check passed.
+ */
+static bool checkHistory() {
+	bool passed = true;
+	ROUKF *filter = createROUKF();
+	filter->setErrorHistoryLength(3);
+	vector<double> xt(N_STATES), zt(N_OBSERVATIONS), errors;
+	SyntheticProblems::initialCondition(&(xt[0]));
+	for (int step = 0; step < 7; ++step) {
+		observeTruth(xt, zt);
+		errors.push_back(filter->executeStep(&(zt[0]), &SyntheticProblems::forward, &SyntheticProblems::observe));
+		if (step == 4)
+			passed = expect(filter->getErrorHistory() == vector<double>(errors.end() - 3, errors.end()),
+					"The history does not hold the last errors.") && passed;
+	}
+	filter->setErrorHistoryLength(2);
+	passed = expect(filter->getErrorHistory() == vector<double>(errors.end() - 2, errors.end()),
+			"A shorter history does not hold the last errors.") && passed;
+	filter->setErrorHistoryLength(4);
+	observeTruth(xt, zt);
+	errors.push_back(filter->executeStep(&(zt[0]), &SyntheticProblems::forward, &SyntheticProblems::observe));
+	passed = expect(filter->getErrorHistory() == vector<double>(errors.end() - 3, errors.end()),
+			"A longer history does not continue the last errors.") && passed;
+
+	delete filter;
+	return passed;
+}
+
+/**
+ * Checks that a dense observation error model with a diagonal covariance gives the steps of the
+ * diagonal model, and that a correlated covariance gives the steps of the original formulation
+ * with its explicit inverse.
+ * @return If the check passed.
+ */
+static bool checkObservations() {
+	bool passed = true;
+	arma::mat diagonal = 1E-4 * arma::eye(N_OBSERVATIONS, N_OBSERVATIONS);
+	arma::mat correlated(N_OBSERVATIONS, N_OBSERVATIONS);
+	for (int i = 0; i < N_OBSERVATIONS; ++i)
+		for (int j = 0; j < N_OBSERVATIONS; ++j)
+			correlated.at(i, j) = 1E-4 * pow(0.5, abs(i - j));
+	ROUKF *filter = createROUKF();
+	ROUKF *dense = createROUKF();
+	dense->setObservationErrorModel(new DenseObservationErrorModel(diagonal));
+	ROUKF *correlatedFilter = createROUKF();
+	correlatedFilter->setObservationErrorModel(new DenseObservationErrorModel(correlated));
+	ReferenceROUKF reference(correlated, vector<double>(N_PARAMETERS, 0.25), false);
+
+	vector<double> xt(N_STATES), zt(N_OBSERVATIONS);
+	SyntheticProblems::initialCondition(&(xt[0]));
+	double denseDifference = 0, correlatedDifference = 0;
+	for (int step = 0; step < 10; ++step) {
+		observeTruth(xt, zt);
+		double error = filter->executeStep(&(zt[0]), &SyntheticProblems::forward, &SyntheticProblems::observe);
+		double denseError = dense->executeStep(&(zt[0]), &SyntheticProblems::forward, &SyntheticProblems::observe);
+		double correlatedError = correlatedFilter->executeStep(&(zt[0]), &SyntheticProblems::forward,
+				&SyntheticProblems::observe);
+		passed = expect(error >= 0 && denseError >= 0 && correlatedError >= 0, "A step failed.") && passed;
+		reference.step(zt);
+		denseDifference = max(denseDifference, difference(estimateOf(filter), estimateOf(dense)));
+		correlatedDifference = max(correlatedDifference,
+				difference(reference.estimate(), stdEstimateOf(correlatedFilter)));
+	}
+	printf("Largest relative difference of the dense diagonal model: %g\n", denseDifference);
+	printf("Largest relative difference of the correlated model: %g\n", correlatedDifference);
+	passed = expect(denseDifference < 1E-12, "The dense diagonal model differs from the diagonal one.") && passed;
+	passed = expect(correlatedDifference < 1E-8, "The correlated model differs from its explicit inverse.")
+			&& passed;
+
+	delete filter;
+	delete dense;
+	delete correlatedFilter;
+	return passed;
+}
+
+/**
+ * Checks that a filter with its states in single precision stays close to the same filter in
+ * double precision along several steps.
+ * @return If the check passed.
+ */
+static bool checkPrecision() {
+	bool passed = true;
+	ROUKF *doubleFilter = createROUKF();
+	ROUKF *singleFilter = createROUKF();
+	singleFilter->setSinglePrecision(true);
+	vector<double> xt(N_STATES), zt(N_OBSERVATIONS);
+	SyntheticProblems::initialCondition(&(xt[0]));
+	double drift = 0;
+	for (int step = 0; step < 10; ++step) {
+		observeTruth(xt, zt);
+		double doubleError = doubleFilter->executeStep(&(zt[0]), &SyntheticProblems::forward,
+				&SyntheticProblems::observe);
+		double singleError = singleFilter->executeStep(&(zt[0]), &SyntheticProblems::forward,
+				&SyntheticProblems::observe);
+		passed = expect(doubleError >= 0 && singleError >= 0, "A step failed.") && passed;
+		drift = max(drift, difference(estimateOf(doubleFilter), estimateOf(singleFilter)));
+	}
+	printf("Largest relative drift of single precision: %g\n", drift);
+	passed = expect(drift < 1E-3, "Single precision drifted from double precision.") && passed;
+	passed = expect(singleFilter->isSinglePrecision(), "The filter is not in single precision.") && passed;
+
+	delete doubleFilter;
+	delete singleFilter;
+	return passed;
+}
+
+/**
+ * Checks that the sigma points evaluated in forked processes give the same estimate as in serial
+ * execution, that the children report their profiler counts, and that a forward operator failing
+ * in a child makes the step fail without modifying the estimate.
+ * @return If the check passed.
+ */
+static bool checkProcesses() {
+	bool passed = true;
+	ROUKF *serial = createROUKF();
+	ROUKF *forked = createROUKF();
+	forked->setExecutionBackend(new ProcessesBackend(2));
+	forked->setProfiling(true);
+	vector<double> xt(N_STATES), zt(N_OBSERVATIONS);
+	SyntheticProblems::initialCondition(&(xt[0]));
+	double largest = 0;
+	const int nSteps = 5;
+	for (int step = 0; step < nSteps; ++step) {
+		observeTruth(xt, zt);
+		double serialError = serial->executeStep(&(zt[0]), &SyntheticProblems::forward,
+				&SyntheticProblems::observe);
+		double forkedError = forked->executeStep(&(zt[0]), &SyntheticProblems::forward,
+				&SyntheticProblems::observe);
+		passed = expect(serialError >= 0 && forkedError >= 0, "A step failed.") && passed;
+		largest = max(largest, difference(estimateOf(serial), estimateOf(forked)));
+	}
+	printf("Largest relative difference of the forked processes: %g\n", largest);
+	passed = expect(largest < 1E-12, "The forked processes differ from serial execution.") && passed;
+	passed = expect(forked->getProfiler().getCount(StepProfiler::FORWARD_CALLS) == (long long) nSteps
+			* forked->getSigmaPoints(), "The forward calls of the children were not counted.") && passed;
+
+	//	Fails in the children only, the parent never calls the forward operator
+	vector<double> before = estimateOf(forked);
+	const pid_t parent = getpid();
+	forwardFunction failing = [parent](double *x, int nStates, double *theta, int nParameters) {
+		SyntheticProblems::forward(x, nStates, theta, nParameters);
+		return getpid() == parent ? 0 : -1;
+	};
+	observeTruth(xt, zt);
+	passed = expect(forked->executeStep(&(zt[0]), failing, &SyntheticProblems::observe) < 0,
+			"A step with a failed forward operator succeeded.") && passed;
+	passed = expect(difference(before, estimateOf(forked)) == 0,
+			"A failed step modified the estimate.") && passed;
+
+	delete serial;
+	delete forked;
+	return passed;
+}
+
+/**
+ * Checks that filters propagating their states reject the surrogate model, and that the model
+ * learns the sigma points evaluated by forked processes.
+ * @return If the check passed.
+ */
+static bool checkSurrogate() {
+	bool passed = true;
+	ROUKF *propagated = createROUKF();
+	SurrogateModel *surrogate = new SurrogateModel(N_PARAMETERS, N_OBSERVATIONS, 0.);
+	passed = expect(!propagated->setSurrogateModel(surrogate), "A filter propagating its states took a surrogate.")
+			&& passed;
+	delete surrogate;
+	delete propagated;
+
+	SyntheticProblems::setup(SyntheticProblems::LINEAR, N_STATES, N_PARAMETERS, true);
+	vector<double> observationsUncertainty(N_OBSERVATIONS, 1E-4);
+	vector<double> parametersUncertainty(N_PARAMETERS, 0.25);
+	StaticROUKF filter(N_OBSERVATIONS, N_STATES, N_PARAMETERS, &(observationsUncertainty[0]),
+			&(parametersUncertainty[0]), SigmaPointsGenerator::SIMPLEX);
+	vector<double> theta = SyntheticProblems::initialParameters();
+	filter.setParameters(&(theta[0]));
+	filter.setExecutionBackend(new ProcessesBackend(2));
+	//	A null threshold never predicts, every sigma point is evaluated and learnt
+	passed = expect(filter.setSurrogateModel(new SurrogateModel(N_PARAMETERS, N_OBSERVATIONS, 0.)),
+			"A static filter rejected the surrogate.") && passed;
+
+	vector<double> xt(N_STATES), zt(N_OBSERVATIONS);
+	SyntheticProblems::initialCondition(&(xt[0]));
+	observeTruth(xt, zt);
+	for (int step = 0; step < 3; ++step)
+		passed = expect(filter.executeStep(&(zt[0]), &SyntheticProblems::forward, &SyntheticProblems::observe) >= 0,
+				"A step failed.") && passed;
+	passed = expect(filter.getSurrogateModel()->getSamples() > 0,
+			"The surrogate did not learn the sigma points of the forked processes.") && passed;
+	return passed;
+}
+
+/**
+ * Checks that the sigma points evaluated by threads give bit for bit the estimate of serial
+ * execution, comparing X, Theta and U in the checkpoints of both filters. The operators are
+ * those of the linear problem without the timing of SyntheticProblems, which is not reentrant.
+ * @return If the check passed.
+ */
+static bool checkThreads() {
+	const string serialFile = "kalman_test_serial.ckpt", threadsFile = "kalman_test_threads.ckpt";
+	bool passed = true;
+	ROUKF *serial = createROUKF();
+	ROUKF *threaded = createROUKF();
+	threaded->setThreads(4);
+	forwardFunction A = [](double *x, int nStates, double *theta, int nParameters) {
+		for (int i = 0; i < nStates; ++i)
+			x[i] = 0.9 * x[i] + 0.1 * theta[(long long) i * nParameters / nStates];
+		return 0;
+	};
+	observationFunction H = [](double *x, int nStates, double *z, int nObservations) {
+		for (int j = 0; j < nObservations; ++j)
+			z[j] = x[(long long) j * nStates / nObservations];
+	};
+	vector<double> xt(N_STATES), zt(N_OBSERVATIONS);
+	SyntheticProblems::initialCondition(&(xt[0]));
+	for (int step = 0; step < 10; ++step) {
+		observeTruth(xt, zt);
+		double serialError = serial->executeStep(&(zt[0]), A, H);
+		double threadsError = threaded->executeStep(&(zt[0]), A, H);
+		passed = expect(serialError >= 0 && threadsError >= 0, "A step failed.") && passed;
+	}
+	passed = expect(threaded->getThreads() == 4, "The filter does not run threads.") && passed;
+
+	passed = expect(serial->saveCheckpoint(serialFile) && threaded->saveCheckpoint(threadsFile),
+			"The checkpoints were not written.") && passed;
+	Checkpoint expected, actual;
+	passed = expect(expected.open(serialFile) && actual.open(threadsFile), "The checkpoints were not opened.")
+			&& passed;
+	const char *names[] = {"X", "Theta", "U"};
+	for (const char *name : names) {
+		uint64_t rows, cols, actualRows, actualCols;
+		const double *e = expected.find(name, &rows, &cols);
+		const double *a = actual.find(name, &actualRows, &actualCols);
+		passed = expect(e && a && rows == actualRows && cols == actualCols
+				&& memcmp(e, a, rows * cols * sizeof(double)) == 0,
+				(string(name) + " of the threads differs from serial execution.").c_str()) && passed;
+	}
+	expected.close();
+	actual.close();
+
+	delete serial;
+	delete threaded;
+	remove(serialFile.c_str());
+	remove(threadsFile.c_str());
+	return passed;
+}
+
+/**
+ * Checks that run stops with each of its statuses, and that a second run does not converge on
+ * the errors of the first one. The steps are real steps of a StaticROUKF on the linear problem,
+ * whose errors are replaced by scripted ones to reach the other statuses.
+ * @return If the check passed.
+ */
+static bool checkRun() {
+	bool passed = true;
+	SyntheticProblems::setup(SyntheticProblems::LINEAR, N_STATES, N_PARAMETERS, true);
+	vector<double> observationsUncertainty(N_OBSERVATIONS, 1E-4);
+	vector<double> parametersUncertainty(N_PARAMETERS, 0.25);
+	vector<double> theta = SyntheticProblems::initialParameters();
+	vector<double> xt(N_STATES), zt(N_OBSERVATIONS);
+	SyntheticProblems::initialCondition(&(xt[0]));
+	observeTruth(xt, zt);
+	auto create = [&]() {
+		StaticROUKF *filter = new StaticROUKF(N_OBSERVATIONS, N_STATES, N_PARAMETERS, &(observationsUncertainty[0]),
+				&(parametersUncertainty[0]), SigmaPointsGenerator::SIMPLEX);
+		filter->setParameters(&(theta[0]));
+		return filter;
+	};
+
+	//	Scripted errors, the last one repeats, with a tolerance of 0 so that nothing converges
+	auto scripted = [&](const vector<double> &errors, double maxIterations, int stagnationIterations) {
+		StaticROUKF *filter = create();
+		filter->setTolerance(0);
+		filter->setMaxIterations(maxIterations);
+		filter->setStagnationIterations(stagnationIterations);
+		size_t calls = 0;
+		AbstractROUKF::RUN_STATUS status = filter->run([&]() {
+			filter->executeStep(&(zt[0]), &SyntheticProblems::forward, &SyntheticProblems::observe);
+			return errors[std::min(calls++, errors.size() - 1)];
+		});
+		delete filter;
+		return status;
+	};
+	passed = expect(scripted({ 3, 2, 1 }, 3, 50) == AbstractROUKF::MAX_ITERATIONS,
+			"The run did not stop at the maximum iterations.") && passed;
+	passed = expect(scripted({ 1 }, 100, 3) == AbstractROUKF::STAGNATED, "The run did not stagnate.") && passed;
+	passed = expect(scripted({ 1, NAN }, 100, 50) == AbstractROUKF::NOT_A_NUMBER
+			&& scripted({ 1, INFINITY }, 100, 50) == AbstractROUKF::NOT_A_NUMBER,
+			"A NaN or infinite error was not detected.") && passed;
+	passed = expect(scripted({ 1, 2E3 }, 100, 50) == AbstractROUKF::DIVERGED, "The run did not diverge.") && passed;
+	passed = expect(scripted({ 1, -1 }, 100, 50) == AbstractROUKF::FAILED, "A failed step did not stop the run.")
+			&& passed;
+
+	//	Converged run, then a second one that needs its own two steps
+	StaticROUKF *filter = create();
+	filter->setTolerance(1E-6);
+	int steps = 0;
+	auto step = [&]() {
+		++steps;
+		return filter->executeStep(&(zt[0]), &SyntheticProblems::forward, &SyntheticProblems::observe);
+	};
+	passed = expect(filter->run(step) == AbstractROUKF::CONVERGED, "The run did not converge.") && passed;
+	steps = 0;
+	passed = expect(filter->run(step) == AbstractROUKF::CONVERGED && steps >= 2,
+			"The second run converged on the errors of the first one.") && passed;
+	delete filter;
+	return passed;
+}
+
+/**
+ * Checks that a MappedROUKF with positive parameters on the heat problem, nonlinear in its
+ * parameters, follows the original formulation of the step, which samples the sigma points with
+ * chol(inv(U)) and applies inv(U) in the update, in its parameters, standard deviations and
+ * states.
+ * @return If the check passed.
+ */
+static bool checkSampling() {
+	bool passed = true;
+	SyntheticProblems::setup(SyntheticProblems::HEAT, N_STATES, N_PARAMETERS, false);
+	vector<double> observationsUncertainty(N_OBSERVATIONS, 1E-4);
+	vector<double> parametersUncertainty(N_PARAMETERS, 0.25);
+	MappedROUKF filter(N_OBSERVATIONS, N_STATES, N_PARAMETERS, observationsUncertainty, parametersUncertainty,
+			SigmaPointsGenerator::SIMPLEX, MappedROUKF::POSITIVE, vector<double>());
+	vector<double> theta = SyntheticProblems::initialParameters();
+	filter.setParameters(&(theta[0]));
+	vector<double> xt(N_STATES), zt(N_OBSERVATIONS);
+	SyntheticProblems::initialCondition(&(xt[0]));
+	filter.setState(&(xt[0]));
+	ReferenceROUKF reference(arma::diagmat(arma::mat(&(observationsUncertainty[0]), N_OBSERVATIONS, 1)),
+			parametersUncertainty, true);
+
+	double largest = 0;
+	for (int step = 0; step < 10; ++step) {
+		observeTruth(xt, zt);
+		passed = expect(filter.executeStep(zt, &SyntheticProblems::forward, &SyntheticProblems::observe) >= 0,
+				"A step failed.") && passed;
+		reference.step(zt);
+		largest = max(largest, difference(reference.estimate(), stdEstimateOf(&filter)));
+	}
+	printf("Largest relative difference to the original formulation: %g\n", largest);
+	passed = expect(largest < 1E-8, "The sigma points differ from the original formulation.") && passed;
+	return passed;
+}
+
+/**
+ * Simplex sigma points with the recursive construction that the generator had before it was
+ * built in a single pass, sigma_n = [sigma_{n-1} 0; -w_n ... -w_n n*w_n].
+ * @param nPoints Quantity of points to generate.
+ * @param weight Weight of the sigma points.
+ * @return Matrix of sigma points.
+ */
+static arma::mat recursiveSimplex(int nPoints, double weight) {
+	arma::mat sigma = arma::zeros(nPoints, nPoints + 1);
+	double currWeight = 1. / sqrt((double) (nPoints * (nPoints + 1)) * weight);
+	if (nPoints > 1)
+		sigma.submat(0, 0, nPoints - 2, nPoints - 1) = recursiveSimplex(nPoints - 1, weight);
+	for (int col = 0; col < nPoints; col++)
+		sigma.at(nPoints - 1, col) = -currWeight;
+	sigma.at(nPoints - 1, nPoints) = nPoints * currWeight;
+	return sigma;
+}
+
+/**
+ * Checks that the simplex sigma points built in a single pass are those of the recursive
+ * construction with an identity covariance, and that the filters and the threads that ask for
+ * the same sigma points share one cached set.
+ * @return If the check passed.
+ */
+static bool checkSigma() {
+	bool passed = true;
+	for (int p = 1; p <= 8; ++p) {
+		arma::mat sigma;
+		SigmaPointsGenerator::generateSigmaPoints(p, SigmaPointsGenerator::SIMPLEX, &sigma);
+		arma::mat reference = recursiveSimplex(p, 1. / (p + 1));
+		passed = expect(sigma.n_rows == reference.n_rows && sigma.n_cols == reference.n_cols
+				&& memcmp(sigma.memptr(), reference.memptr(), sigma.n_elem * sizeof(double)) == 0,
+				"The simplex differs from the recursive construction.") && passed;
+		shared_ptr<const SigmaPointsGenerator::SigmaPointsSet> set =
+				SigmaPointsGenerator::getSigmaPointsSet(p, SigmaPointsGenerator::SIMPLEX);
+		passed = expect(arma::approx_equal(set->Pa, arma::eye(p, p), "absdiff", 1E-12),
+				"The covariance of the simplex is not the identity.") && passed;
+	}
+
+	SigmaPointsGenerator::clearCache();
+	ROUKF *first = createROUKF();
+	shared_ptr<const SigmaPointsGenerator::SigmaPointsSet> set =
+			SigmaPointsGenerator::getSigmaPointsSet(N_PARAMETERS, SigmaPointsGenerator::SIMPLEX);
+	ROUKF *second = createROUKF();
+	vector<shared_ptr<const SigmaPointsGenerator::SigmaPointsSet> > threadSets(4);
+	vector<thread> threads;
+	for (size_t t = 0; t < threadSets.size(); ++t)
+		threads.push_back(thread([&threadSets, t]() {
+			threadSets[t] = SigmaPointsGenerator::getSigmaPointsSet(N_PARAMETERS, SigmaPointsGenerator::SIMPLEX);
+		}));
+	for (size_t t = 0; t < threads.size(); ++t)
+		threads[t].join();
+	passed = expect(SigmaPointsGenerator::getSigmaPointsSet(N_PARAMETERS, SigmaPointsGenerator::SIMPLEX) == set,
+			"Two filters got different sigma points sets.") && passed;
+	for (size_t t = 0; t < threadSets.size(); ++t)
+		passed = expect(threadSets[t] == set, "A thread got another sigma points set.") && passed;
+
+	//	Sets held by the callers outlive the cache
+	SigmaPointsGenerator::clearCache();
+	passed = expect(SigmaPointsGenerator::getSigmaPointsSet(N_PARAMETERS, SigmaPointsGenerator::SIMPLEX) != set
+			&& set->sigma.n_cols == N_PARAMETERS + 1, "The cleared cache kept its sets.") && passed;
+	delete first;
+	delete second;
+	return passed;
+}
+
+/**
+ * Checks that filters with their states in a storage file give exactly the estimates of the
+ * same filters with their states in memory, in double precision and with single precision
+ * tiles of LX.
+ * @return If the check passed.
+ */
+static bool checkStorage() {
+	bool passed = true;
+	ROUKF *filters[4];
+	for (int f = 0; f < 4; ++f) {
+		filters[f] = createROUKF();
+		//	In memory and in storage, in double and in single precision
+		filters[f]->setSinglePrecision(f >= 2);
+		if (f % 2 == 1)
+			passed = expect(filters[f]->setStateStorage("."), "The state storage was not set.") && passed;
+	}
+
+	vector<double> xt(N_STATES), zt(N_OBSERVATIONS);
+	SyntheticProblems::initialCondition(&(xt[0]));
+	double largest = 0;
+	for (int step = 0; step < 10; ++step) {
+		observeTruth(xt, zt);
+		for (int f = 0; f < 4; ++f)
+			passed = expect(filters[f]->executeStep(&(zt[0]), &SyntheticProblems::forward,
+					&SyntheticProblems::observe) >= 0, "A step failed.") && passed;
+		largest = max(largest, difference(estimateOf(filters[0]), estimateOf(filters[1])));
+		largest = max(largest, difference(estimateOf(filters[2]), estimateOf(filters[3])));
+	}
+	printf("Largest relative difference of the state storage: %g\n", largest);
+	passed = expect(largest == 0, "The state storage differs from the states in memory.") && passed;
+
+	for (int f = 0; f < 4; ++f)
+		delete filters[f];
+	return passed;
+}
+
+/**
+ * Checks that the streaming step, with blocks of three observations, matches executeStep with
+ * diagonal, block diagonal and dense observation error models.
+ * @return If the check passed.
+ */
+static bool checkStreaming() {
+	bool passed = true;
+	vector<arma::mat> blocks;
+	for (int size : {4, 3, 3}) {
+		arma::mat block(size, size);
+		for (int i = 0; i < size; ++i)
+			for (int j = 0; j < size; ++j)
+				block.at(i, j) = 1E-4 * pow(0.5, abs(i - j));
+		blocks.push_back(block);
+	}
+	arma::mat dense(N_OBSERVATIONS, N_OBSERVATIONS);
+	for (int i = 0; i < N_OBSERVATIONS; ++i)
+		for (int j = 0; j < N_OBSERVATIONS; ++j)
+			dense.at(i, j) = 1E-4 * pow(0.5, abs(i - j));
+	const char *names[] = {"diagonal", "block diagonal", "dense"};
+	blockObservationFunction H = [](double *x, int nStates, double *z, int first, int count) {
+		for (int j = 0; j < count; ++j)
+			z[j] = x[(long long) (first + j) * nStates / N_OBSERVATIONS];
+	};
+
+	for (int model = 0; model < 3; ++model) {
+		ROUKF *filter = createROUKF();
+		ROUKF *streaming = createROUKF();
+		if (model == 1) {
+			filter->setObservationErrorModel(new BlockDiagonalObservationErrorModel(blocks));
+			streaming->setObservationErrorModel(new BlockDiagonalObservationErrorModel(blocks));
+		} else if (model == 2) {
+			filter->setObservationErrorModel(new DenseObservationErrorModel(dense));
+			streaming->setObservationErrorModel(new DenseObservationErrorModel(dense));
+		}
+		streaming->setObservationBlockSize(3);
+
+		vector<double> xt(N_STATES), zt(N_OBSERVATIONS);
+		SyntheticProblems::initialCondition(&(xt[0]));
+		double largest = 0;
+		for (int step = 0; step < 5; ++step) {
+			observeTruth(xt, zt);
+			double error = filter->executeStep(&(zt[0]), &SyntheticProblems::forward, &SyntheticProblems::observe);
+			double streamingError = streaming->executeStepStreaming(&(zt[0]), &SyntheticProblems::forward, H);
+			passed = expect(error >= 0 && streamingError >= 0, "A step failed.") && passed;
+			largest = max(largest, difference(estimateOf(filter), estimateOf(streaming)));
+		}
+		printf("Largest relative difference of the streaming step with a %s model: %g\n", names[model], largest);
+		passed = expect(largest < 1E-12, "The streaming step differs from executeStep.") && passed;
+
+		delete filter;
+		delete streaming;
+	}
+	return passed;
+}
+
+/**
+ * Checks that the scheduler evaluates every sigma point exactly once among groups of processes
+ * of different sizes, with and without threads, and that all processes end with every column.
+ * @return If the check passed.
+ */
+static bool checkScheduler() {
+	int rank, size;
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+	//	Groups of two processes (the last one may be alone), their ranks 0 are the masters
+	MPI_Comm groupComm, mastersComm;
+	MPI_Comm_split(MPI_COMM_WORLD, rank / 2, rank, &groupComm);
+	int groupRank;
+	MPI_Comm_rank(groupComm, &groupRank);
+	MPI_Comm_split(MPI_COMM_WORLD, groupRank == 0 ? 0 : MPI_UNDEFINED, rank, &mastersComm);
+
+	const int nSigma = 7, rows = 5;
+	bool passed = true;
+	{
+		SigmaPointsScheduler scheduler;
+		scheduler.setup(groupComm, mastersComm, nSigma);
+		ThreadPool pool(2);
+		vector<int> evaluations(nSigma);
+		vector<double> block((size_t) rows * nSigma);
+		for (int step = 0; step < 4; ++step) {
+			std::fill(evaluations.begin(), evaluations.end(), 0);
+			std::fill(block.begin(), block.end(), -1.);
+			//	Threads in the last steps, after the queue was ordered by the timings
+			scheduler.run([&](int i, int) {
+				if (groupRank == 0)
+					__sync_fetch_and_add(&evaluations[i], 1);
+				for (int j = 0; j < rows; ++j)
+					block[(size_t) i * rows + j] = i * rows + j + step;
+			}, step >= 2 ? &pool : NULL);
+			MPI_Allreduce(MPI_IN_PLACE, &(evaluations[0]), nSigma, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+			for (int i = 0; i < nSigma; ++i)
+				passed = expect(evaluations[i] == 1, "A sigma point was not evaluated exactly once.") && passed;
+
+			scheduler.share(&(block[0]), rows);
+			for (int j = 0; j < rows * nSigma; ++j)
+				passed = expect(block[j] == j + step, "A shared column differs from its evaluation.") && passed;
+		}
+	}
+
+	if (mastersComm != MPI_COMM_NULL)
+		MPI_Comm_free(&mastersComm);
+	MPI_Comm_free(&groupComm);
+	return passed;
+}
+
+/**
+ * Checks that a windowed step over several observation times matches a single step of a filter
+ * observing the stacked observations of all times with a block diagonal covariance (one block
+ * per time), and that a window of a single time matches executeStep. The observations of each
+ * time are correlated.
+ * @return If the check passed.
+ */
+static bool checkWindow() {
+	const int nTimes = 3;
+	bool passed = true;
+	arma::mat covariance(N_OBSERVATIONS, N_OBSERVATIONS);
+	for (int i = 0; i < N_OBSERVATIONS; ++i)
+		for (int j = 0; j < N_OBSERVATIONS; ++j)
+			covariance.at(i, j) = 1E-4 * pow(0.5, abs(i - j));
+	windowForwardFunction windowForward = [](double *x, int nStates, double *theta, int nParameters, double) {
+		return SyntheticProblems::forward(x, nStates, theta, nParameters);
+	};
+
+	//	The stacked filter propagates each sigma point through all times, recording their
+	//	observations, which its observation operator then copies (sigma points are evaluated
+	//	in serial, one after the other)
+	ROUKF *window = createROUKF();
+	window->setObservationErrorModel(new DenseObservationErrorModel(covariance));
+	vector<double> observationsUncertainty(N_OBSERVATIONS * nTimes, 1E-4);
+	vector<double> parametersUncertainty(N_PARAMETERS, 0.25);
+	ROUKF stacked(N_OBSERVATIONS * nTimes, N_STATES, N_PARAMETERS, &(observationsUncertainty[0]),
+			&(parametersUncertainty[0]), SigmaPointsGenerator::SIMPLEX);
+	stacked.setObservationErrorModel(new BlockDiagonalObservationErrorModel(vector<arma::mat>(nTimes, covariance)));
+	vector<double> theta = SyntheticProblems::initialParameters(), x0(N_STATES);
+	SyntheticProblems::initialCondition(&(x0[0]));
+	stacked.setParameters(&(theta[0]));
+	stacked.setState(&(x0[0]));
+	vector<double> trajectory(N_OBSERVATIONS * nTimes);
+	forwardFunction stackedForward = [&trajectory](double *x, int nStates, double *theta, int nParameters) {
+		for (int k = 0; k < nTimes; ++k) {
+			SyntheticProblems::forward(x, nStates, theta, nParameters);
+			SyntheticProblems::observe(x, nStates, &(trajectory[k * N_OBSERVATIONS]), N_OBSERVATIONS);
+		}
+		return 0;
+	};
+	observationFunction stackedObserve = [&trajectory](double *, int, double *z, int nObservations) {
+		memcpy(z, &(trajectory[0]), nObservations * sizeof(double));
+	};
+
+	vector<double> xt(N_STATES), zt(N_OBSERVATIONS * nTimes), times(nTimes);
+	SyntheticProblems::initialCondition(&(xt[0]));
+	double largest = 0, largestError = 0;
+	for (int step = 0; step < 4; ++step) {
+		for (int k = 0; k < nTimes; ++k) {
+			vector<double> ztk(N_OBSERVATIONS);
+			observeTruth(xt, ztk);
+			copy(ztk.begin(), ztk.end(), zt.begin() + k * N_OBSERVATIONS);
+			times[k] = step * nTimes + k + 1;
+		}
+		double windowError = window->executeStepWindow(&(zt[0]), &(times[0]), nTimes, windowForward,
+				&SyntheticProblems::observe);
+		double stackedError = stacked.executeStep(&(zt[0]), stackedForward, stackedObserve);
+		passed = expect(windowError >= 0 && stackedError >= 0, "A step failed.") && passed;
+		largest = max(largest, difference(estimateOf(window), estimateOf(&stacked)));
+		largestError = max(largestError, abs(windowError - stackedError) / stackedError);
+	}
+	printf("Largest relative difference of the window to the stacked observations: %g (error norm %g)\n",
+			largest, largestError);
+	passed = expect(largest < 1E-12 && largestError < 1E-12,
+			"The window differs from a step over the stacked observations.") && passed;
+	delete window;
+
+	//	A single time
+	ROUKF *single = createROUKF(), *filter = createROUKF();
+	single->setObservationErrorModel(new DenseObservationErrorModel(covariance));
+	filter->setObservationErrorModel(new DenseObservationErrorModel(covariance));
+	SyntheticProblems::initialCondition(&(xt[0]));
+	largest = 0;
+	for (int step = 0; step < 4; ++step) {
+		vector<double> ztk(N_OBSERVATIONS);
+		observeTruth(xt, ztk);
+		double time = step + 1;
+		double windowError = single->executeStepWindow(&(ztk[0]), &time, 1, windowForward, &SyntheticProblems::observe);
+		double error = filter->executeStep(&(ztk[0]), &SyntheticProblems::forward, &SyntheticProblems::observe);
+		passed = expect(windowError >= 0 && error >= 0, "A step failed.") && passed;
+		largest = max(largest, difference(estimateOf(single), estimateOf(filter)));
+	}
+	printf("Largest relative difference of a window of one time to executeStep: %g\n", largest);
+	passed = expect(largest < 1E-12, "A window of one time differs from executeStep.") && passed;
+	delete single;
+	delete filter;
+	return passed;
+}
+
+/**	Check of this executable. */
+struct NamedCheck {
+	/**	Name used in the command line. */
+	const char *name;
+	/**	Function running the check, returns if it passed. */
+	bool (*check)();
+};
+
+/**	Checks run by name. */
+static const NamedCheck checks[] = {
+	{"batch", &checkBatch},
+	{"cache", &checkCache},
+	{"checkpoint", &checkCheckpoint},
+	{"covariance", &checkCovariance},
+	{"failure", &checkFailure},
+	{"fixed", &checkFixed},
+	{"history", &checkHistory},
+	{"observations", &checkObservations},
+	{"precision", &checkPrecision},
+	{"processes", &checkProcesses},
+	{"run", &checkRun},
+	{"sampling", &checkSampling},
+	{"scheduler", &checkScheduler},
+	{"sigma", &checkSigma},
+	{"storage", &checkStorage},
+	{"streaming", &checkStreaming},
+	{"surrogate", &checkSurrogate},
+	{"threads", &checkThreads},
+	{"window", &checkWindow}
+};
+
+int main(int argc, char *argv[]) {
+	MPI_Init(&argc, &argv);
+	const NamedCheck *selected = NULL;
+	for (size_t i = 0; argc > 1 && i < sizeof(checks) / sizeof(checks[0]); ++i)
+		if (strcmp(argv[1], checks[i].name) == 0)
+			selected = &checks[i];
+	if (!selected) {
+		printf("Usage: %s <check>, with the checks:", argv[0]);
+		for (size_t i = 0; i < sizeof(checks) / sizeof(checks[0]); ++i)
+			printf(" %s", checks[i].name);
+		printf("\n");
+		MPI_Finalize();
+		return 2;
+	}
+
+	//	Passes only if it passed in every process
+	int passed = selected->check() ? 1 : 0;
+	MPI_Allreduce(MPI_IN_PLACE, &passed, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+	MPI_Finalize();
+	return passed ? 0 : 1;
+}